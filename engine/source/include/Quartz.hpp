@@ -26,8 +26,11 @@
 #include <quartz/core/Core.hpp>
 #include <quartz/core/utilities/Logger.hpp>
 #include <quartz/core/utilities/FileIO.hpp>
+#include <quartz/core/utilities/VirtualFileSystem.hpp>
+#include <quartz/core/scripting/LuaState.hpp>
 
 #include <quartz/core/Application.hpp>
+#include <quartz/core/GameLoop.hpp>
 #include <quartz/core/EntryPoint.hpp>
 
 #include <quartz/core/events/Event.hpp>
@@ -37,6 +37,9 @@ namespace qz
 
 		std::string logFilePath = "Quartz.log";
 		utils::LogVerbosity logVerbosity = utils::LogVerbosity::INFO;
+
+		/// @brief The asset archive to read assets from, loose files are used for anything it doesn't hold.
+		std::string assetArchivePath = "assets.qzpak";
 	};
 
 	struct ApplicationData
@@ -25,6 +25,8 @@
 
 #include <quartz/core/Core.hpp>
 #include <quartz/core/Application.hpp>
+#include <quartz/core/utilities/Config.hpp>
+#include <quartz/core/utilities/VirtualFileSystem.hpp>
 
 using namespace qz;
 
@@ -40,6 +42,13 @@ int main(int argc, char** argv)
 
 	LOGGER_INIT(requirements->logFilePath, requirements->logVerbosity);
 
+	// Loose files are only looked for when the archive doesn't hold them.
+	utils::VirtualFileSystem::get()->mountDirectory(".");
+	utils::VirtualFileSystem::get()->mountArchive(requirements->assetArchivePath);
+
+	// Lets config files be tuned while the game is running.
+	utils::ConfigManager::get()->startWatching();
+
 	appData->window = gfx::IWindow::create(requirements->windowTitle, requirements->windowWidth,
 										   requirements->windowHeight, 0, gfx::RenderingAPI::OPENGL);
 
@@ -50,6 +59,9 @@ int main(int argc, char** argv)
 	delete application;
 	delete appData;
 
+	utils::ConfigManager::get()->stopWatching();
+	utils::VirtualFileSystem::get()->unmountAll();
+
 	LOGGER_DESTROY();
 
 	return 0;
@@ -0,0 +1,159 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#pragma once
+
+#include <quartz/core/Core.hpp>
+#include <quartz/core/events/ApplicationEvent.hpp>
+#include <quartz/core/events/EventQueue.hpp>
+#include <quartz/core/graphics/IWindow.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+namespace qz
+{
+	/**
+	 * @brief Runs the simulation at a fixed rate on its own thread, and renders as often as it can on the calling thread.
+	 *
+	 * Every tick covers the same amount of time, and is sent to the tick listeners as an events::AppTickEvent on the
+	 * simulation thread. Rendering doesn't wait for ticks, so a heavy tick doesn't hold up frames, and a slow frame
+	 * doesn't hold up ticks. As frames fall between ticks, anything the simulation moves should be drawn part way
+	 * between its last two states, see Interpolated.
+	 *
+	 * Window events are still polled and dispatched on the rendering thread, at the end of every frame.
+	 */
+	class QZ_API GameLoop
+	{
+	public:
+		static constexpr int DEFAULT_TICKS_PER_SECOND = 20;
+
+		/**
+		 * @brief Creates a game loop.
+		 * @param window The window to render to, the loop runs until it closes.
+		 * @param ticksPerSecond How many ticks to run every second.
+		 */
+		GameLoop(gfx::IWindow* window, int ticksPerSecond = DEFAULT_TICKS_PER_SECOND);
+		~GameLoop() = default;
+
+		/**
+		 * @brief Registers a function to run every tick, on the simulation thread. This must be done before run().
+		 * @param listener The function to call, it returns whether it handled the tick.
+		 */
+		void registerTickListener(events::EventQueue::TypedListener<events::AppTickEvent> listener);
+
+		/**
+		 * @brief Runs the loop until the window closes or stop() is called.
+		 * @param render The function to render a frame, it is called between the window's startFrame and endFrame.
+		 */
+		void run(const std::function<void()>& render);
+
+		/**
+		 * @brief Stops the loop, it finishes the tick and frame it is running first.
+		 */
+		void stop();
+
+		int getTicksPerSecond() const;
+
+		/**
+		 * @brief Gets the number of ticks that have finished.
+		 */
+		std::uint64_t getTickCount() const;
+
+		/**
+		 * @brief Gets how far the current time is past a tick.
+		 * @param tick The tick to measure from.
+		 * @return From 0, at the time the tick was for, to 1, a whole tick later.
+		 *
+		 * A tick is run once the time it is for has passed, so frames are drawn between the state of the tick
+		 * before last and the last tick, running one tick behind the simulation.
+		 */
+		float getInterpolation(std::uint64_t tick) const;
+
+	private:
+		void simulate();
+
+		gfx::IWindow* m_window;
+
+		int m_ticksPerSecond;
+		std::chrono::steady_clock::duration m_tickLength;
+
+		// Tick n is run at m_start + n * m_tickLength, m_start moves forward when the simulation skips time.
+		std::atomic<std::chrono::steady_clock::rep> m_start;
+
+		std::atomic<bool> m_running;
+		std::atomic<std::uint64_t> m_tickCount;
+
+		// Only used by the simulation thread.
+		events::EventQueue m_tickEvents;
+	};
+
+	/**
+	 * @brief Holds the last two states of something the simulation changes, so it can be drawn between them.
+	 * @tparam T The type of the state. It needs + and - with itself, and * with a float, like float or Vector3.
+	 *
+	 * The simulation pushes the new state at the end of every tick, and the renderer reads a blend of the last
+	 * two. Each only holds the lock while copying the state, so neither waits on the other's work.
+	 */
+	template <typename T>
+	class Interpolated
+	{
+	public:
+		explicit Interpolated(const T& initial = T()) : m_previous(initial), m_current(initial) {}
+
+		/**
+		 * @brief Sets the state at the end of a tick, from the simulation thread.
+		 * @param state The new state.
+		 * @param tick The number of the tick the state is for, from events::AppTickEvent::getTick().
+		 */
+		void push(const T& state, std::uint64_t tick)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			m_previous = m_current;
+			m_current = state;
+			m_tick = tick;
+		}
+
+		/**
+		 * @brief Gets the state to draw this frame, from the rendering thread.
+		 * @param loop The loop the simulation is running in.
+		 */
+		T get(const GameLoop& loop) const
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			return m_previous + (m_current - m_previous) * loop.getInterpolation(m_tick);
+		}
+
+	private:
+		mutable std::mutex m_mutex;
+
+		T m_previous;
+		T m_current;
+		std::uint64_t m_tick = 0;
+	};
+}
@@ -26,6 +26,8 @@
 #include <quartz/core/Core.hpp>
 #include <quartz/core/events/Event.hpp>
 
+#include <cstdint>
+
 namespace qz
 {
 	namespace events
@@ -135,24 +137,40 @@ namespace qz
 		};
 
 		/**
-		 * @brief Derived Class from Event for every time a game loop is run.
+		 * @brief Derived Class from Event for every tick of the simulation.
 		 * 
-		 * Each "tick" (for the engine's definition) is the start of a new iteration of the main game loop. This is NOT implemented as of yet,
-		 * and may even be removed at a later date if a necessary need/implementation is not necessary or already completed.
+		 * The GameLoop runs the simulation on its own thread at a fixed rate, and sends one of these to its tick listeners for every tick,
+		 * on that thread. Each tick always covers the same amount of time, so anything updated from it behaves the same at any frame rate.
 		 */
 		class QZ_API AppTickEvent : public Event
 		{
 		public:
 			/**
 			 * @brief Constructs a AppTick event.
+			 * @param tick The number of the tick, counting up from 1.
+			 * @param dt The time each tick covers, in seconds.
 			 */
-			AppTickEvent() = default;
+			AppTickEvent(const std::uint64_t tick, const float dt) : m_tick(tick), m_dt(dt) {}
+
+			/**
+			 * @brief Gets the number of the tick, which counts up from 1.
+			 */
+			std::uint64_t getTick() const { return m_tick; }
+
+			/**
+			 * @brief Gets the time the tick covers, in seconds. This is the same for every tick.
+			 */
+			float getDelta() const { return m_dt; }
 
 			/// @brief Automatically "creates" the member function(s) which require the Event's Type.
 			EVENT_CLASS_TYPE(APP_TICK);
 
 			/// @brief Automatically "creates" the member function(s) which require the Event's Category(s).
 			EVENT_CLASS_CATEGORY(EventCategory::APPLICATION);
+
+		private:
+			std::uint64_t m_tick; /// @brief The number of the tick.
+			float m_dt; /// @brief The time the tick covers, in seconds.
 		};
 	}
 }
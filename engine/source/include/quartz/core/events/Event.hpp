@@ -25,6 +25,7 @@
 
 #include <quartz/core/Core.hpp>
 
+#include <cstddef>
 #include <functional>
 
 namespace qz
@@ -41,7 +42,7 @@ namespace qz
 			WINDOW_RESIZE,		//< Used for when a window is resized, this is mainly useful for recalculating projections/viewports for graphics.
 			WINDOW_FOCUS,		//< Used for when a window is focused or "clicked back onto". E.g. A camera can be re-enabled when the window is focused.
 			WINDOW_LOST_FOCUS,	//< Used for when a window loses focus, or is "clicked off of". E.g. A camera can be disabled when the window loses focus.
-			APP_TICK,		//< Used for when a new iteration of the main game loop runs (NOT IMPLEMENTED AS OF 19/02/2019).
+			APP_TICK,		//< Used for every tick of the fixed rate simulation, see GameLoop.
 			KEY_PRESSED,		//< Used for when a key is pressed, not great for things like cameras, as the event callback will have a little "latency" to it.
 			KEY_RELEASED,		//< Used for when a key is released, not great for things like cameras, as the event callback will have a little "latency" to it.
 			MOUSE_BUTTON_PRESSED,	//< Used for when a mouse button is pressed.
@@ -50,6 +51,9 @@ namespace qz
 			MOUSE_SCROLLED		//< Used for when the scroll wheel on a mouse is used.
 		};
 
+		/// @brief The number of values in EventType, for tables indexed by the type of an event.
+		constexpr std::size_t EVENT_TYPE_COUNT = static_cast<std::size_t>(EventType::MOUSE_SCROLLED) + 1;
+
 		/**
 		 * @brief Enumerator for the different categories of events that can occur in the runtime duration of the engine.
 		 */
@@ -105,6 +109,7 @@ namespace qz
 
 		private:
 			friend class EventDispatcher;
+			friend class EventQueue;
 		};
 
 		/**
@@ -0,0 +1,170 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#pragma once
+
+#include <quartz/core/Core.hpp>
+#include <quartz/core/events/Event.hpp>
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace qz
+{
+	namespace events
+	{
+		/**
+		 * @brief Collects the events that come in during a frame and hands each one to the listeners for its type.
+		 *
+		 * Events are constructed straight into a fixed block of memory owned by the queue, and the memory is reused
+		 * once they have been dispatched, so queueing and dispatching an event never allocates. If a burst of events
+		 * (such as fast mouse movement) fills the block, the events already queued are dispatched early to make room.
+		 *
+		 * Listeners are registered for the types of event they want, and stored in a table indexed by EventType, so
+		 * dispatching an event only calls the listeners that asked for it.
+		 */
+		class QZ_API EventQueue
+		{
+		public:
+			/**
+			 * @brief A function that receives every type of event.
+			 */
+			using Listener = std::function<void(Event&)>;
+
+			/**
+			 * @brief A function that receives one type of event, and returns whether it handled it.
+			 * @tparam T The type of event, like events::KeyPressedEvent.
+			 */
+			template <typename T>
+			using TypedListener = std::function<bool(T&)>;
+
+			static constexpr std::size_t ARENA_SIZE = 16 * 1024;
+			static constexpr std::size_t MAX_QUEUED_EVENTS = ARENA_SIZE / sizeof(Event);
+
+			EventQueue() = default;
+			~EventQueue() { clear(); }
+
+			// Queued events point into the queue's own memory, so it can't be copied or moved.
+			EventQueue(const EventQueue& other) = delete;
+			EventQueue(EventQueue&& other) = delete;
+
+			/**
+			 * @brief Adds a listener for a single type of event.
+			 * @tparam T The type of event the listener wants, like events::KeyPressedEvent.
+			 * @param listener The function to call, it is passed the event already cast to T.
+			 */
+			template <typename T>
+			void addListener(TypedListener<T> listener)
+			{
+				m_listeners[static_cast<std::size_t>(T::getStaticType())].emplace_back([listener](Event& event)
+				{
+					event.m_handled = listener(static_cast<T&>(event));
+				});
+			}
+
+			/**
+			 * @brief Adds a listener for every type of event.
+			 * @param listener The function to call, it can use an EventDispatcher to pick out the events it wants.
+			 */
+			void addListener(const Listener& listener)
+			{
+				for (std::vector<Listener>& listeners : m_listeners)
+					listeners.push_back(listener);
+			}
+
+			/**
+			 * @brief Queues an event, constructing it in place.
+			 * @tparam T The type of event to queue.
+			 * @param args The arguments to construct the event with.
+			 *
+			 * The event is dispatched on the next call to dispatch(), or straight away if the queue is full.
+			 */
+			template <typename T, typename... Args>
+			void push(Args&&... args)
+			{
+				static_assert(sizeof(T) <= ARENA_SIZE, "Events have to fit in the queue.");
+
+				std::size_t offset = align(m_used, alignof(T));
+
+				if (offset + sizeof(T) > ARENA_SIZE || m_count == MAX_QUEUED_EVENTS)
+				{
+					dispatch();
+					offset = 0;
+				}
+
+				m_events[m_count++] = new (m_arena + offset) T(std::forward<Args>(args)...);
+				m_used = offset + sizeof(T);
+			}
+
+			/**
+			 * @brief Hands every queued event, in the order they were queued, to the listeners for its type.
+			 *
+			 * The queue is empty afterwards.
+			 */
+			void dispatch()
+			{
+				for (std::size_t i = 0; i < m_count; ++i)
+				{
+					Event& event = *m_events[i];
+
+					for (Listener& listener : m_listeners[static_cast<std::size_t>(event.getEventType())])
+						listener(event);
+				}
+
+				clear();
+			}
+
+			/**
+			 * @brief Gets the number of events waiting to be dispatched.
+			 */
+			std::size_t size() const { return m_count; }
+
+		private:
+			static std::size_t align(std::size_t offset, std::size_t alignment)
+			{
+				return (offset + alignment - 1) & ~(alignment - 1);
+			}
+
+			void clear()
+			{
+				for (std::size_t i = 0; i < m_count; ++i)
+					m_events[i]->~Event();
+
+				m_count = 0;
+				m_used = 0;
+			}
+
+			alignas(std::max_align_t) unsigned char m_arena[ARENA_SIZE];
+			std::size_t m_used = 0;
+
+			std::array<Event*, MAX_QUEUED_EVENTS> m_events;
+			std::size_t m_count = 0;
+
+			std::array<std::vector<Listener>, EVENT_TYPE_COUNT> m_listeners;
+		};
+	}
+}
@@ -48,7 +48,30 @@ namespace qz
 				static GraphicsResource<IShaderPipeline> generateShaderPipeline();
 				virtual ~IShaderPipeline() = default;
 
+				/**
+				 * @brief Sets the directory that linked shader programs are cached in.
+				 * @param directory The directory to store cached programs in, an empty string disables the cache.
+				 *
+				 * Cached programs are keyed by their stage sources and the driver in use, so a cache directory can safely
+				 * be shared between builds and machines, stale entries are simply never matched again.
+				 */
+				static void setBinaryCacheDirectory(const std::string& directory);
+
+				/**
+				 * @brief Gets the directory that linked shader programs are cached in.
+				 * @return The cache directory, an empty string means caching is disabled.
+				 */
+				static const std::string& getBinaryCacheDirectory();
+
 				virtual void addStage(ShaderType stage, const std::string& shaderSource) = 0;
+
+				/**
+				 * @brief Builds the pipeline from the stages that have been added.
+				 *
+				 * If a program binary matching the stage sources and driver exists in the binary cache, it will be
+				 * restored instead of compiling the stages. Otherwise the stages are compiled, linked and then written
+				 * to the cache for the next run.
+				 */
 				virtual void build() = 0;
 
 				virtual void use() const = 0;
@@ -69,6 +92,9 @@ namespace qz
 
 				virtual void bindAttributeLocation(const std::string& attribName, int index) = 0;
 				virtual int retrieveAttributeLocation(const std::string& attribName) = 0;
+
+			private:
+				static std::string s_binaryCacheDirectory;
 			};
 		}
 	}
@@ -44,6 +44,22 @@ namespace qz
 				static GraphicsResource<ITextureArray> generateTextureArray();
 				virtual ~ITextureArray() = default;
 
+				/**
+				 * @brief Sets the directory that baked texture arrays are cached in.
+				 * @param directory The directory to store baked arrays in, an empty string disables the cache.
+				 *
+				 * resolveReservations() decodes the reserved textures and builds their mipmaps once, then stores the
+				 * result keyed by the contents and layers of the source images. Later runs upload the baked array
+				 * straight from the cache, and editing any source image simply misses the cache.
+				 */
+				static void setBakeCacheDirectory(const std::string& directory);
+
+				/**
+				 * @brief Gets the directory that baked texture arrays are cached in.
+				 * @return The cache directory, an empty string means caching is disabled.
+				 */
+				static const std::string& getBakeCacheDirectory();
+
 				virtual void setOptions(TextureOptions options) = 0;
 
 				virtual void add(const std::string& path) = 0;
@@ -61,6 +77,9 @@ namespace qz
 				TexCache m_texReservations;
 
 				int m_layerNumber = 0;
+
+			private:
+				static std::string s_bakeCacheDirectory;
 			};
 		}
 	}
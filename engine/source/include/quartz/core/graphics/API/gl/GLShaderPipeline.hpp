@@ -76,7 +76,33 @@ namespace qz
 				private:
 					unsigned int m_id;
 
-					std::vector<unsigned int> m_shaders;
+					/// @brief The stages waiting to be compiled, they are only compiled if no cached binary could be used.
+					std::vector<std::pair<ShaderType, std::string>> m_stages;
+
+					/**
+					 * @brief Calculates the binary cache path for the current stages and driver.
+					 * @return The path to the cache entry, or an empty string if binaries are unsupported or caching is disabled.
+					 */
+					std::string getBinaryCachePath() const;
+
+					/**
+					 * @brief Attempts to restore the program from the binary cache.
+					 * @param cachePath The path to the cache entry.
+					 * @return True if the program was restored and linked successfully, false if it needs to be compiled.
+					 */
+					bool loadBinary(const std::string& cachePath);
+
+					/**
+					 * @brief Writes the linked program to the binary cache.
+					 * @param cachePath The path to the cache entry.
+					 */
+					void saveBinary(const std::string& cachePath) const;
+
+					/**
+					 * @brief Compiles and links all the stages that have been added.
+					 * @return True if the program linked successfully, false if not.
+					 */
+					bool compileAndLink();
 				};
 			}
 		}
@@ -28,6 +28,9 @@
 
 #include <glad/glad.h>
 
+#include <cstdint>
+#include <vector>
+
 namespace qz
 {
 	namespace gfx
@@ -68,6 +71,13 @@ namespace qz
 					int m_layerNumber = 0;
 
 				private:
+					/**
+					 * @brief Uploads a baked array, every mip level of every layer, one level at a time.
+					 * @param pixels The RGBA pixels of each level in turn, each level holding the layers in order.
+					 * @param layers The layer each baked texture goes in, in ascending order.
+					 */
+					void uploadBaked(const unsigned char* pixels, const std::vector<int>& layers) const;
+
 					unsigned int m_id;
 					mutable int m_slot;
 
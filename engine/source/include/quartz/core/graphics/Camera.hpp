@@ -27,6 +27,7 @@
 #include <quartz/core/math/Math.hpp>
 #include <quartz/core/graphics/IWindow.hpp>
 #include <quartz/core/events/ApplicationEvent.hpp>
+#include <quartz/core/utilities/Config.hpp>
 
 namespace qz
 {
@@ -53,6 +54,12 @@ namespace qz
 			 * @return A 3 component vector containing the position of the camera.
 			 */
 			Vector3 getPosition() const;
+
+			/**
+			 * @brief Moves the camera, for example to keep it at the eyes of something that collides with the world.
+			 * @param position The new position of the camera, in world space.
+			 */
+			void setPosition(const Vector3& position);
 			
 			/**
 			 * @brief Gets the direction of the camera, in world space
@@ -143,6 +150,15 @@ namespace qz
 
 			/// @brief The current status of the camera, whether it's enabled or not.
 			bool m_enabled = true;
+
+			/// @brief The controls, bound from Controls.ini so they can be tuned while the game is running.
+			utils::ConfigValue<events::Key> m_moveForward;
+			utils::ConfigValue<events::Key> m_moveBackwards;
+			utils::ConfigValue<events::Key> m_strafeLeft;
+			utils::ConfigValue<events::Key> m_strafeRight;
+
+			utils::ConfigValue<float> m_sensitivity;
+			utils::ConfigValue<float> m_moveSpeed;
 		};
 	}
 }
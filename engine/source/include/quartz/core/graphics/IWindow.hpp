@@ -26,6 +26,7 @@
 #include <quartz/core/Core.hpp>
 #include <quartz/core/math/Math.hpp>
 #include <quartz/core/events/Event.hpp>
+#include <quartz/core/events/EventQueue.hpp>
 #include <quartz/core/graphics/API/Context.hpp>
 #include <quartz/core/events/EventEnums.hpp>
 
@@ -120,9 +121,30 @@ namespace qz
  			 * (assuming you're adding an event listener that doesn't have a class, but is just a sole function)
  			 * window->registerEventListener(&functionName);
  			 * @endcode
+ 			 *
+ 			 * The listener receives every type of event, prefer the typed overload for listeners that only want some.
  			 */
  			virtual void registerEventListener(std::function<void(events::Event&)> listener) = 0;
 
+			/**
+			 * @brief Registers an event listener for a single type of event.
+			 * @tparam T The type of event the listener wants, like events::KeyPressedEvent.
+			 * @param listener The function to call, it returns whether it handled the event.
+			 *
+			 * It can be used like:
+			 *
+			 * @code{.cpp}
+			 * window->registerEventListener<events::KeyPressedEvent>([this](events::KeyPressedEvent& event) { return onKeyPress(event); });
+			 * @endcode
+			 *
+			 * Only events of type T are passed to the listener, already cast, so it doesn't need an EventDispatcher.
+			 */
+			template <typename T>
+			void registerEventListener(events::EventQueue::TypedListener<T> listener)
+			{
+				m_eventQueue.addListener<T>(std::move(listener));
+			}
+
 			/**
 			 * @brief Shows the window to the user.
 			 * 
@@ -255,8 +277,8 @@ namespace qz
 			virtual void endFrame()                               = 0;
 
 		protected:
-			 /// @brief Stores event listeners for the event dispatching system.
-			std::vector<std::function<void(events::Event&)>> m_eventListeners;
+			 /// @brief Queues the events of each frame, and stores the event listeners they are dispatched to.
+			events::EventQueue m_eventQueue;
 		};
 	}
 }
@@ -0,0 +1,82 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#pragma once
+
+#include <quartz/core/math/Vector3.hpp>
+
+namespace qz
+{
+	namespace math
+	{
+		/**
+		 * @brief An axis aligned bounding box, the space between two corners.
+		 */
+		struct AABB
+		{
+			Vector3 min;
+			Vector3 max;
+
+			AABB() = default;
+
+			/**
+			 * @brief Constructs a box from its corners.
+			 * @param min The lowest corner of the box.
+			 * @param max The highest corner of the box.
+			 */
+			AABB(const Vector3& min, const Vector3& max) : min(min), max(max) {}
+
+			/**
+			 * @brief Moves the box.
+			 * @param offset How far to move the box.
+			 */
+			void offset(const Vector3& offset) { min += offset; max += offset; }
+
+			/**
+			 * @brief Gets the box that covers all the space this box passes through as it moves.
+			 * @param motion How far the box moves.
+			 * @return The box grown in the direction of the motion.
+			 */
+			AABB expand(const Vector3& motion) const
+			{
+				AABB out = *this;
+
+				(motion.x < 0.f ? out.min.x : out.max.x) += motion.x;
+				(motion.y < 0.f ? out.min.y : out.max.y) += motion.y;
+				(motion.z < 0.f ? out.min.z : out.max.z) += motion.z;
+
+				return out;
+			}
+
+			/**
+			 * @brief Checks whether two boxes overlap, boxes that only touch don't.
+			 */
+			bool intersects(const AABB& other) const
+			{
+				return min.x < other.max.x && max.x > other.min.x &&
+					min.y < other.max.y && max.y > other.min.y &&
+					min.z < other.max.z && max.z > other.min.z;
+			}
+		};
+	}
+}
@@ -28,6 +28,7 @@
 #include <quartz/core/math/Vector3.hpp>
 #include <quartz/core/math/Vector2.hpp>
 #include <quartz/core/math/Ray.hpp>
+#include <quartz/core/math/AABB.hpp>
 
 namespace qz
 {
@@ -26,6 +26,8 @@
 #include <quartz/core/Core.hpp>
 #include <quartz/core/math/Vector3.hpp>
 
+#include <cstddef>
+
 namespace qz
 {
 	namespace math
@@ -99,23 +101,53 @@ namespace qz
 				const Vector3& up
 			);
 
+			/**
+			 * @brief Calculates the inverse of the matrix.
+			 * @return The inverted matrix.
+			 *
+			 * The matrix must be invertible (have a non-zero determinant), otherwise the result will contain infinities/NaNs.
+			 */
+			Matrix4x4 inverse() const;
+
+			/**
+			 * @brief Transforms a point by the matrix, treating the point as having a W component of 1.
+			 * @param point The point to transform.
+			 * @return The transformed point, no perspective division is applied.
+			 */
+			Vector3 transformPoint(const Vector3& point) const;
+
+			/**
+			 * @brief Transforms a direction by the matrix, treating the direction as having a W component of 0.
+			 * @param direction The direction to transform.
+			 * @return The transformed direction, any translation in the matrix does not affect it.
+			 */
+			Vector3 transformDirection(const Vector3& direction) const;
+
+			/**
+			 * @brief Transforms an array of points by the matrix, see transformPoint.
+			 * @param points The points to transform.
+			 * @param out The array to write the transformed points into, may be the same array as points.
+			 * @param count The number of points in the arrays.
+			 */
+			void transformPoints(const Vector3* points, Vector3* out, std::size_t count) const;
+
 			/// @brief Operator Overload for multiplying an established lvalue matrix object with another matrix.
 			void operator*=(const Matrix4x4& other);
 
 			/// @brief Operator Overload for multiplying a matrix object (lvalue, or rvalue) with another matrix.
-			Matrix4x4 operator*(const Matrix4x4& other);
+			Matrix4x4 operator*(const Matrix4x4& other) const;
 
 			/// @brief Operator Overload for multiplying an established lvalue matrix object with scalar value, a float.
 			void operator*=(const float& other);
 
 			/// @brief Operator Overload for multiplying a matrix object (lvalue, or rvalue) with scalar value, a float.
-			Matrix4x4 operator*(const float& other);
+			Matrix4x4 operator*(const float& other) const;
 
 			/**
 			 * @brief Operator Overload for multiplying a matrix object (lvalue or rvalue) with a 3 component Vector.
 			 * @return The calculated product, as a Vector3, a 3 component vector.
 			 */
-			Vector3 operator*(const Vector3& other);
+			Vector3 operator*(const Vector3& other) const;
 		};
 	};
 }
@@ -71,6 +71,18 @@ namespace qz
 			 */
 			Vector3 getCurrentPosition() const;
 
+			/**
+			 * @brief Gets the position the ray started at.
+			 * @return The start of the ray.
+			 */
+			const Vector3& getStart() const;
+
+			/**
+			 * @brief Gets the direction the ray is "traveling" in.
+			 * @return The direction of the ray.
+			 */
+			const Vector3& getDirection() const;
+
 		private:
 			float m_length;
 			Vector3 m_start;
@@ -25,6 +25,7 @@
 
 #include <quartz/core/Core.hpp>
 #include <cmath>
+#include <cstddef>
 
 namespace qz
 {
@@ -109,6 +110,42 @@ namespace qz
 			 * @return The calculated product.
 			 */
 			static float	dotProduct	(const Vector3& vec1, const Vector3& vec2);
+
+			/**
+			 * @brief Adds two arrays of vectors together, component by component.
+			 * @param vec1 The first array of vectors.
+			 * @param vec2 The second array of vectors.
+			 * @param out The array to write the results into, may be the same array as either input.
+			 * @param count The number of vectors in each array.
+			 */
+			static void		add			(const Vector3* vec1, const Vector3* vec2, Vector3* out, std::size_t count);
+
+			/**
+			 * @brief Subtracts an array of vectors from another, component by component.
+			 * @param vec1 The array of vectors being subtracted from.
+			 * @param vec2 The array of vectors to subtract.
+			 * @param out The array to write the results into, may be the same array as either input.
+			 * @param count The number of vectors in each array.
+			 */
+			static void		subtract	(const Vector3* vec1, const Vector3* vec2, Vector3* out, std::size_t count);
+
+			/**
+			 * @brief Multiplies an array of vectors by a scalar.
+			 * @param vecs The array of vectors to scale.
+			 * @param scalar The value to multiply each component by.
+			 * @param out The array to write the results into, may be the same array as the input.
+			 * @param count The number of vectors in the array.
+			 */
+			static void		scale		(const Vector3* vecs, float scalar, Vector3* out, std::size_t count);
+
+			/**
+			 * @brief Calculates the Dot Product of each pair of vectors in two arrays.
+			 * @param vec1 The first array of vectors.
+			 * @param vec2 The second array of vectors.
+			 * @param out The array to write the products into, it must hold count floats.
+			 * @param count The number of vectors in each array.
+			 */
+			static void		dotProducts	(const Vector3* vec1, const Vector3* vec2, float* out, std::size_t count);
 			
 			///////////////////// OPERATOR OVERLOADS /////////////////////
 
@@ -151,6 +188,20 @@ namespace qz
 			TemplateVector3()				: x(T()),	y(T()), z(T())	{}
 			TemplateVector3(T x)			: x(x),		y(x),	z(x)	{}
 			TemplateVector3(T x, T y, T z)	: x(x),		y(y),	z(z)	{}		
+
+			///////////////////// OPERATOR OVERLOADS /////////////////////
+
+			void			operator+=	(const TemplateVector3& other)			{ x += other.x; y += other.y; z += other.z; }
+			void			operator-=	(const TemplateVector3& other)			{ x -= other.x; y -= other.y; z -= other.z; }
+
+			TemplateVector3	operator+	(const TemplateVector3& other)	const	{ return TemplateVector3(x + other.x, y + other.y, z + other.z); }
+			TemplateVector3	operator-	(const TemplateVector3& other)	const	{ return TemplateVector3(x - other.x, y - other.y, z - other.z); }
+			TemplateVector3	operator*	(const T& scalar)				const	{ return TemplateVector3(x * scalar, y * scalar, z * scalar); }
+
+			bool			operator==	(const TemplateVector3& other)	const	{ return x == other.x && y == other.y && z == other.z; }
+			bool			operator!=	(const TemplateVector3& other)	const	{ return !(*this == other); }
+
+			///////////////////// END OPERATOR OVERLOADS /////////////////////
 		};
 	}
 }
@@ -61,6 +61,7 @@ namespace qz
 					void swapBuffers() const override;
 
 					void registerEventListener(std::function<void(events::Event&)> listener) override;
+					using IWindow::registerEventListener;
 
 					void show() const override;
 					void hide() const override;
@@ -101,9 +102,6 @@ namespace qz
 					bool m_fullscreen;
 
 					Vector2 m_cachedScreenSize;
-
-				private:
-					void dispatchToListeners(events::Event&& event);
 				};
 			}
 		}
@@ -0,0 +1,146 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#pragma once
+
+#include <quartz/core/Core.hpp>
+
+#include <memory>
+#include <string>
+
+// Only LuaState.cpp and code that talks to Lua directly needs <lua.hpp>, so it isn't pulled into every header.
+struct lua_State;
+
+namespace qz
+{
+	namespace scripting
+	{
+		/// @brief A C function callable from Lua, the same type as lua_CFunction.
+		using LuaFunction = int (*)(lua_State* state);
+
+		/**
+		 * @brief A reference to a Lua value, kept alive in the registry until the reference is destroyed.
+		 *
+		 * Pushing the value back is a single indexed registry read, so a reference is the cheapest way for C++ to
+		 * hold on to something like a callback. References can outlive the LuaState they came from, they simply
+		 * become invalid once it is closed.
+		 */
+		class QZ_API LuaRef
+		{
+		public:
+			LuaRef() = default;
+
+			/**
+			 * @brief References a value on the stack, leaving the stack as it was.
+			 * @param state The state the value belongs to, as given by LuaState::getHandle().
+			 * @param index The stack index of the value.
+			 */
+			LuaRef(const std::shared_ptr<lua_State>& state, int index);
+			~LuaRef();
+
+			LuaRef(const LuaRef& other) = delete;
+			LuaRef& operator=(const LuaRef& other) = delete;
+
+			LuaRef(LuaRef&& other) noexcept;
+			LuaRef& operator=(LuaRef&& other) noexcept;
+
+			/**
+			 * @brief Pushes the value onto the stack.
+			 * @return The state it was pushed onto, or nullptr if the reference is invalid and nothing was pushed.
+			 */
+			lua_State* push() const;
+
+			bool isValid() const;
+
+		private:
+			void release();
+
+			// The same value as LUA_NOREF, which is checked where <lua.hpp> is available.
+			static constexpr int NO_REF = -2;
+
+			std::weak_ptr<lua_State> m_state;
+			int m_ref = NO_REF;
+		};
+
+		/**
+		 * @brief An independent Lua virtual machine with the standard libraries opened.
+		 *
+		 * Scripts are read through the VirtualFileSystem, so they can be packed like any other asset. Lua is not
+		 * thread safe, so a LuaState should only ever be used from one thread at a time.
+		 */
+		class QZ_API LuaState
+		{
+		public:
+			LuaState();
+			~LuaState() = default;
+
+			LuaState(const LuaState& other) = delete;
+			LuaState& operator=(const LuaState& other) = delete;
+
+			/**
+			 * @brief Runs a script file.
+			 * @param filepath The logical path of the script.
+			 * @return Whether the script ran without errors, any error is logged as a warning.
+			 */
+			bool runFile(const std::string& filepath);
+
+			/**
+			 * @brief Runs a string of Lua source.
+			 * @param source The source to run.
+			 * @param chunkName The name used for the source in error messages.
+			 * @param resultCount How many results of the chunk to leave on the stack.
+			 * @return Whether the source ran without errors, any error is logged as a warning.
+			 */
+			bool runString(const std::string& source, const std::string& chunkName = "=string", int resultCount = 0);
+
+			/**
+			 * @brief Makes a C function available to scripts as a global.
+			 */
+			void registerFunction(const std::string& name, LuaFunction function);
+
+			/**
+			 * @brief Sets a global to a number, for constants such as enum values.
+			 */
+			void setGlobal(const std::string& name, double value);
+
+			/**
+			 * @brief Calls the function on the top of the stack, below its arguments, like lua_pcall.
+			 * @param state The state to call in.
+			 * @param argumentCount How many arguments were pushed after the function.
+			 * @param resultCount How many results to leave on the stack.
+			 * @return Whether the call succeeded, on failure the error is logged and nothing is left on the stack.
+			 */
+			static bool call(lua_State* state, int argumentCount, int resultCount = 0);
+
+			lua_State* getState() const;
+
+			/**
+			 * @brief Gets the owning handle to the state, for creating LuaRefs.
+			 */
+			const std::shared_ptr<lua_State>& getHandle() const;
+
+		private:
+			std::shared_ptr<lua_State> m_state;
+		};
+	}
+}
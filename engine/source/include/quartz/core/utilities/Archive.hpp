@@ -0,0 +1,188 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#pragma once
+
+#include <quartz/core/Core.hpp>
+#include <quartz/core/utilities/FileIO.hpp>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace qz
+{
+	namespace utils
+	{
+		/**
+		 * @brief The header at the very start of an asset archive.
+		 *
+		 * An archive is laid out as the header, the index of entries sorted by path hash, the paths of the entries,
+		 * and then the data of every entry, each starting on an ARCHIVE_ALIGNMENT boundary. Everything is little
+		 * endian, and the whole file is meant to be memory mapped rather than read.
+		 */
+		struct ArchiveHeader
+		{
+			char magic[4];
+			std::uint32_t version;
+			std::uint32_t entryCount;
+			std::uint32_t namesSize;
+		};
+
+		/**
+		 * @brief A single file stored in an asset archive.
+		 */
+		struct ArchiveEntry
+		{
+			/// @brief The FNV-1a hash of the path, which the index is sorted by.
+			std::uint64_t hash;
+
+			/// @brief Where the data starts, from the start of the archive.
+			std::uint64_t offset;
+
+			/// @brief How many bytes the data takes up in the archive.
+			std::uint64_t storedSize;
+
+			/// @brief How many bytes the file is once decompressed.
+			std::uint64_t size;
+
+			/// @brief Where the path starts, from the start of the names.
+			std::uint32_t nameOffset;
+			std::uint32_t nameLength;
+
+			std::uint32_t flags;
+			std::uint32_t reserved;
+		};
+
+		static constexpr char ARCHIVE_MAGIC[4] = { 'Q', 'Z', 'P', 'K' };
+		static constexpr std::uint32_t ARCHIVE_VERSION = 1;
+
+		/// @brief Entry data is aligned to a cache line, so it can be used in place straight from the mapping.
+		static constexpr std::uint64_t ARCHIVE_ALIGNMENT = 64;
+
+		/// @brief Set on entries whose data was compressed with Compression::compress.
+		static constexpr std::uint32_t ARCHIVE_ENTRY_COMPRESSED = 1 << 0;
+
+		/**
+		 * @brief A read-only asset archive, memory mapped as a whole.
+		 *
+		 * Looking up an entry is a binary search over the mapped index, so opening an archive costs one open and
+		 * one mapping however many files it holds. An Archive can be read from any number of threads at once.
+		 */
+		class QZ_API Archive
+		{
+		public:
+			Archive() = default;
+
+			/**
+			 * @brief Opens and validates an archive.
+			 * @param filepath The path of the archive on disk.
+			 * @return Whether the archive could be opened, a warning is logged if it couldn't.
+			 */
+			bool open(const std::string& filepath);
+
+			bool isOpen() const { return m_entries != nullptr; }
+
+			/**
+			 * @brief Finds an entry.
+			 * @param path The path of the file in the archive, as given by normalizePath().
+			 * @return The entry, or nullptr if the archive doesn't hold the file.
+			 */
+			const ArchiveEntry* find(std::string_view path) const;
+
+			/**
+			 * @brief Gets the path an entry is stored under.
+			 */
+			std::string_view getName(const ArchiveEntry& entry) const;
+
+			/**
+			 * @brief Gets the data of an entry exactly as stored, without copying it.
+			 * @param entry The entry to get the data of.
+			 * @return The data, which is only the contents of the file if the entry isn't compressed.
+			 */
+			std::string_view getStoredData(const ArchiveEntry& entry) const;
+
+			/**
+			 * @brief Reads an entry, decompressing it if needed.
+			 * @param entry The entry to read.
+			 * @param out The string to read into.
+			 * @return Whether the entry could be read, it can only fail if the archive is corrupt.
+			 */
+			bool read(const ArchiveEntry& entry, std::string& out) const;
+
+			std::uint32_t getEntryCount() const { return m_entryCount; }
+			const ArchiveEntry* getEntries() const { return m_entries; }
+
+			/**
+			 * @brief Turns a path into the form it is stored under, with forward slashes and no leading "./".
+			 */
+			static std::string normalizePath(std::string_view path);
+
+		private:
+			MappedFile m_file;
+
+			const ArchiveEntry* m_entries = nullptr;
+			std::uint32_t m_entryCount = 0;
+
+			const char* m_names = nullptr;
+		};
+
+		/**
+		 * @brief Builds an asset archive, used by the asset packer.
+		 */
+		class QZ_API ArchiveWriter
+		{
+		public:
+			/**
+			 * @brief Adds a file to the archive, replacing any file already added with the same path.
+			 * @param path The path the file will be looked up by.
+			 * @param data The contents of the file.
+			 * @param compress Whether to try compressing the file, it is only stored compressed if that makes it
+			 * noticeably smaller.
+			 */
+			void add(std::string_view path, std::string data, bool compress = true);
+
+			/**
+			 * @brief Writes the archive to disk.
+			 * @param filepath The path of the archive to write.
+			 * @return Whether the archive could be written, a warning is logged if it couldn't.
+			 */
+			bool write(const std::string& filepath) const;
+
+			std::size_t getFileCount() const { return m_files.size(); }
+
+		private:
+			struct File
+			{
+				std::string path;
+				std::string data;
+
+				std::uint64_t size;
+				bool compressed;
+			};
+
+			std::vector<File> m_files;
+		};
+	}
+}
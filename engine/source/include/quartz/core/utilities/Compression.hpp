@@ -0,0 +1,63 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#pragma once
+
+#include <quartz/core/Core.hpp>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace qz
+{
+	namespace utils
+	{
+		/**
+		 * @brief Fast LZ77 style compression, used for packing assets.
+		 *
+		 * The format is a stream of sequences, each made of a run of literal bytes followed by a copy of earlier
+		 * output. It favours decompression speed over ratio, since assets are packed once but unpacked on every
+		 * start. Compressed data does not store its own size, so the caller has to keep track of it.
+		 */
+		class QZ_API Compression
+		{
+		public:
+			/**
+			 * @brief Compresses a block of memory.
+			 * @param input The data to compress.
+			 * @return The compressed data, which can be slightly bigger than the input if it doesn't compress.
+			 */
+			static std::string compress(std::string_view input);
+
+			/**
+			 * @brief Decompresses a block of memory produced by compress().
+			 * @param input The compressed data.
+			 * @param output Where to decompress to.
+			 * @param outputSize The exact size of the uncompressed data.
+			 * @return Whether the data was valid and decompressed to exactly outputSize bytes.
+			 */
+			static bool decompress(std::string_view input, char* output, std::size_t outputSize);
+		};
+	}
+}
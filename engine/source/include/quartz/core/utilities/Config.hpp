@@ -26,23 +26,56 @@
 #include <quartz/core/Core.hpp>
 #include <quartz/core/events/EventEnums.hpp>
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 #include <inih/INIReader.h>
 
 #define QZ_REGISTER_CONFIG(filenameStr) \
-	qz::ConfigManager::get()->registerConfig(filenameStr)
+	qz::utils::ConfigManager::get()->registerConfig(filenameStr)
 
 #define QZ_GET_CONFIG(filenameStr) \
-	qz::ConfigManager::get()->getConfigFile(filenameStr)
+	qz::utils::ConfigManager::get()->getConfigFile(filenameStr)
 
 namespace qz
 {
 	namespace utils
 	{
+		class ConfigFile;
+
+		/**
+		 * @brief A config value bound once with ConfigFile::bind, which keeps up to date as the file is reloaded.
+		 *
+		 * Reading the value is a single atomic load with no lookups or parsing, so it is fine to read every frame.
+		 * A handle stays valid for as long as the ConfigFile it was bound from, and reads as T() if never bound.
+		 */
+		template <typename T>
+		class ConfigValue
+		{
+		public:
+			ConfigValue() = default;
+
+			T get() const { return m_value == nullptr ? T() : m_value->load(std::memory_order_relaxed); }
+			operator T() const { return get(); }
+
+		private:
+			friend class ConfigFile;
+
+			explicit ConfigValue(const std::atomic<T>* value)
+				: m_value(value) {}
+
+			const std::atomic<T>* m_value = nullptr;
+		};
+
 		/**
 		 * @brief Class for Configuration File loading and interpreting.
 		 *
+		 * The parsed file is kept as a snapshot that reload() swaps out atomically, so values can be read from any
+		 * thread while the file is being reloaded by the ConfigManager's watcher.
 		 */
 		class QZ_API ConfigFile
 		{
@@ -52,12 +85,29 @@ namespace qz
 			 * @param filepath The filepath of the .ini file (should include .ini extension).
 			 */
 			ConfigFile(const std::string& filepath)
-				: m_filepath(filepath) {}
+				: m_inifile(std::make_shared<INIReader>()), m_filepath(filepath) {}
 
 			/*
 			 * @brief Default stub constructor. Does nothing.
 			 */
-			ConfigFile() {}
+			ConfigFile()
+				: m_inifile(std::make_shared<INIReader>()) {}
+
+			ConfigFile(const ConfigFile& other) = delete;
+			ConfigFile& operator=(const ConfigFile& other) = delete;
+
+			/**
+			 * @brief Binds a value to a typed handle, which is updated every time the file is reloaded.
+			 * @param section The ini section that the key/value belongs to.
+			 * @param key The key of the value.
+			 * @param defaultValue The value to use if the key/value/section doesn't exist.
+			 * @return The handle to read the value through. T can be int, char, bool, float or events::Key.
+			 *
+			 * Prefer binding over the get functions for anything read often, the get functions look the value up
+			 * and parse it again on every call.
+			 */
+			template <typename T>
+			ConfigValue<T> bind(const std::string& section, const std::string& key, T defaultValue);
 
 			/**
 			 * @brief Load's a integer value from the config .ini file, using the specfied default value if the value doesn't exist.
@@ -117,11 +167,63 @@ namespace qz
 			 */
 			void reload();
 
+			const std::string& getFilepath() const { return m_filepath; }
+
 		private:
-			INIReader   m_inifile;
+			struct IBinding
+			{
+				virtual ~IBinding() = default;
+				virtual void resolve(const INIReader& inifile) = 0;
+			};
+
+			template <typename T>
+			struct Binding : IBinding
+			{
+				std::string section;
+				std::string key;
+				T defaultValue;
+
+				std::atomic<T> value;
+
+				void resolve(const INIReader& inifile) override
+				{
+					value.store(read(inifile, section, key, defaultValue), std::memory_order_relaxed);
+				}
+			};
+
+			static int read(const INIReader& inifile, const std::string& section, const std::string& key, int defaultReturn);
+			static char read(const INIReader& inifile, const std::string& section, const std::string& key, char defaultReturn);
+			static bool read(const INIReader& inifile, const std::string& section, const std::string& key, bool defaultReturn);
+			static float read(const INIReader& inifile, const std::string& section, const std::string& key, float defaultReturn);
+			static events::Key read(const INIReader& inifile, const std::string& section, const std::string& key, events::Key defaultReturn);
+
+			/// @brief Swapped with std::atomic_load/std::atomic_store, so readers never see a half loaded file.
+			std::shared_ptr<const INIReader> m_inifile;
 			std::string m_filepath;
+
+			/// @brief Serialises reloads and binding, reading values never takes it.
+			std::mutex m_mutex;
+			std::vector<std::unique_ptr<IBinding>> m_bindings;
 		};
 
+		template <typename T>
+		ConfigValue<T> ConfigFile::bind(const std::string& section, const std::string& key, T defaultValue)
+		{
+			auto binding = std::make_unique<Binding<T>>();
+			binding->section = section;
+			binding->key = key;
+			binding->defaultValue = defaultValue;
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			binding->resolve(*std::atomic_load(&m_inifile));
+
+			const ConfigValue<T> handle(&binding->value);
+			m_bindings.push_back(std::move(binding));
+
+			return handle;
+		}
+
 		class ConfigManager
 		{
 		public:
@@ -145,8 +247,37 @@ namespace qz
 			 */
 			ConfigFile* getConfigFile(const std::string& name);
 
+			/**
+			 * @brief Starts reloading registered config files on a background thread whenever they change on disk.
+			 *
+			 * Changes are picked up through inotify on Linux, and by checking modification times elsewhere. Bound
+			 * values update as soon as the file has been reloaded.
+			 */
+			void startWatching();
+
+			/**
+			 * @brief Stops the background thread started by startWatching(), waiting for it to finish.
+			 */
+			void stopWatching();
+
+			~ConfigManager();
+
 		private:
+			void watch();
+
+			/// @brief Adds a watch for the directory holding a config file, when m_mutex is held.
+			void addWatch(const ConfigFile& file);
+
 			std::unordered_map<std::string, ConfigFile> m_configfiles;
+
+			/// @brief Guards m_configfiles while the watcher is running.
+			std::mutex m_mutex;
+
+			std::thread m_watcher;
+			std::atomic<bool> m_watching{ false };
+
+			int m_notifyHandle = -1;
+			std::unordered_map<int, std::string> m_watchedDirectories;
 		};
 	}
 }
@@ -25,10 +25,68 @@
 
 #include <quartz/core/Core.hpp>
 
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <string_view>
+
 namespace qz
 {
 	namespace utils
 	{
+		/**
+		 * @brief A file mapped read-only into memory.
+		 *
+		 * The contents are read straight out of the operating system's file cache as they are touched, without being
+		 * copied into a buffer first. The view stays valid for as long as the MappedFile does.
+		 */
+		class QZ_API MappedFile
+		{
+		public:
+			MappedFile() = default;
+
+			/**
+			 * @brief Maps a file.
+			 * @param filepath The path to the file to map, check isOpen() to see whether it worked.
+			 */
+			explicit MappedFile(const std::string& filepath);
+			~MappedFile();
+
+			MappedFile(const MappedFile& other) = delete;
+			MappedFile& operator=(const MappedFile& other) = delete;
+
+			MappedFile(MappedFile&& other) noexcept;
+			MappedFile& operator=(MappedFile&& other) noexcept;
+
+			/**
+			 * @brief Checks whether the file was opened, an empty file is open but has no contents.
+			 */
+			bool isOpen() const { return m_open; }
+
+			/**
+			 * @brief Gets the contents of the file, without copying them.
+			 */
+			std::string_view getContents() const { return { m_data, m_size }; }
+
+			const char* data() const { return m_data; }
+			std::size_t size() const { return m_size; }
+
+		private:
+			void close();
+
+			bool m_open = false;
+
+			const char* m_data = nullptr;
+			std::size_t m_size = 0;
+
+#ifdef QZ_PLATFORM_WINDOWS
+			void* m_file = nullptr;
+			void* m_mapping = nullptr;
+#endif
+		};
+
 		/**
 		 * @brief File Input/Output wrapping class.
 		 */
@@ -38,9 +96,59 @@ namespace qz
 			/**
 			 * @brief Reads a whole file into a string.
 			 * @param filepath The path to the file needing to be read.
-			 * @return A string containing the contents of the file.
+			 * @return A string containing the contents of the file, empty if it couldn't be read.
 			 */
 			static std::string readAllFile(const std::string& filepath);
+
+			/**
+			 * @brief Maps a whole file into memory, for reading it without copying it.
+			 * @param filepath The path to the file needing to be read.
+			 * @return The mapped file, check MappedFile::isOpen() to see whether it worked.
+			 */
+			static MappedFile mapFile(const std::string& filepath);
+
+			/**
+			 * @brief Reads a whole file into a string on a background thread.
+			 * @param filepath The path to the file needing to be read.
+			 * @return A future that holds the contents once they have been read, empty if the file couldn't be read.
+			 *
+			 * Files are read on a small pool of threads kept for I/O, so starting several reads and then getting on
+			 * with other work overlaps the loading with that work.
+			 */
+			static std::future<std::string> readAllFileAsync(const std::string& filepath);
+
+			/**
+			 * @brief Maps a whole file into memory on a background thread, reading all of it in ahead of use.
+			 * @param filepath The path to the file needing to be read.
+			 * @return A future that holds the mapped file once all of it is in memory.
+			 */
+			static std::future<MappedFile> mapFileAsync(const std::string& filepath);
+
+			/**
+			 * @brief Queues some work on the threads the asynchronous reads run on.
+			 * @param work The work to run, which should mostly be waiting on the disk.
+			 */
+			static void queueIOWork(std::function<void()> work);
+
+			/**
+			 * @brief Runs a function on the threads the asynchronous reads run on.
+			 * @param function The function to run, which should mostly be waiting on the disk.
+			 * @return A future that holds what the function returns once it has run.
+			 */
+			template <typename T>
+			static std::future<T> runOnIOThread(std::function<T()> function);
 		};
+
+		template <typename T>
+		std::future<T> FileIO::runOnIOThread(std::function<T()> function)
+		{
+			// Thread pool work has to be copyable, which a packaged_task isn't.
+			auto task = std::make_shared<std::packaged_task<T()>>(std::move(function));
+			std::future<T> result = task->get_future();
+
+			queueIOWork([task]() { (*task)(); });
+
+			return result;
+		}
 	}
 }
@@ -0,0 +1,95 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#pragma once
+
+#include <quartz/core/Core.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace qz
+{
+	namespace utils
+	{
+		/// @brief The seed used for FNV-1a hashes when no previous hash is being continued.
+		static constexpr std::uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+
+		/// @brief The prime multiplied into every byte of an FNV-1a hash.
+		static constexpr std::uint64_t FNV_PRIME = 1099511628211ull;
+
+		/**
+		 * @brief Hashes a block of memory using the 64 bit FNV-1a algorithm.
+		 * @param data The memory to hash.
+		 * @param size The size of the memory, in bytes.
+		 * @param seed A previous hash to continue from, so multiple blocks can be hashed as if they were one.
+		 * @return The calculated hash.
+		 *
+		 * This is NOT a cryptographic hash, it is only meant for things like cache keys and lookup tables.
+		 */
+		inline std::uint64_t hashBytes(const void* data, std::size_t size, std::uint64_t seed = FNV_OFFSET_BASIS)
+		{
+			const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+			std::uint64_t hash = seed;
+			for (std::size_t i = 0; i < size; ++i)
+			{
+				hash ^= bytes[i];
+				hash *= FNV_PRIME;
+			}
+
+			return hash;
+		}
+
+		/**
+		 * @brief Hashes a string using the 64 bit FNV-1a algorithm.
+		 * @param str The string to hash.
+		 * @param seed A previous hash to continue from.
+		 * @return The calculated hash.
+		 */
+		inline std::uint64_t hashString(const std::string& str, std::uint64_t seed = FNV_OFFSET_BASIS)
+		{
+			return hashBytes(str.data(), str.size(), seed);
+		}
+
+		/**
+		 * @brief Converts a hash into a fixed width, lowercase hexadecimal string, useful for naming cache files.
+		 * @param hash The hash to convert.
+		 * @return The 16 character hexadecimal representation of the hash.
+		 */
+		inline std::string hashToString(std::uint64_t hash)
+		{
+			static const char* digits = "0123456789abcdef";
+
+			std::string out(16, '0');
+			for (int i = 15; i >= 0; --i)
+			{
+				out[i] = digits[hash & 0xF];
+				hash >>= 4;
+			}
+
+			return out;
+		}
+	}
+}
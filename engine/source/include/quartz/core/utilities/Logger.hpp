@@ -28,6 +28,7 @@
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <mutex>
 
 #define LOGGER_INIT(x, y) qz::utils::Logger::instance()->initialise(x, y);
 #define LOGGER_DESTROY() qz::utils::Logger::instance()->destroy();
@@ -142,6 +143,9 @@ namespace qz
 			std::string m_prevMessage;
 			std::size_t m_currentDuplicates;
 
+			/// @brief Messages come from the I/O and config watcher threads as well as the main thread.
+			std::mutex m_mutex;
+
 		private:
 			template <typename T, typename... Args>
 			void log(std::stringstream& sstream, const T& msg, const Args&... args) {
@@ -63,9 +63,18 @@ namespace qz
 
 									task = m_scheduledTasks.front();
 									m_scheduledTasks.pop_front();
+
+									++m_runningTasks;
 								}
 
 								task();
+
+								{
+									std::unique_lock<std::mutex> lock(m_taskMutex);
+
+									if (--m_runningTasks == 0 && m_scheduledTasks.empty())
+										m_idleCondition.notify_all();
+								}
 							}
 						}
 						);
@@ -74,7 +83,11 @@ namespace qz
 
 				~ThreadPool()
 				{
-					m_running = false;
+					{
+						std::unique_lock<std::mutex> lock(m_taskMutex);
+						m_running = false;
+					}
+
 					m_condition.notify_all();
 
 					for (std::thread& taskWorker : m_threads)
@@ -91,11 +104,24 @@ namespace qz
 					m_condition.notify_one();
 				}
 
+				/**
+				 * @brief Blocks until every task that has been added has finished running.
+				 *
+				 * Tasks added by other threads while waiting are waited for too.
+				 */
+				void wait()
+				{
+					std::unique_lock<std::mutex> lock(m_taskMutex);
+					m_idleCondition.wait(lock, [this]() { return m_runningTasks == 0 && m_scheduledTasks.empty(); });
+				}
+
 			private:
-				bool m_running;
+				bool m_running = true;
+				std::size_t m_runningTasks = 0;
 
 				std::mutex m_taskMutex;
 				std::condition_variable m_condition;
+				std::condition_variable m_idleCondition;
 
 				std::vector<std::thread> m_threads;
 				std::deque<std::function<void()>> m_scheduledTasks;
@@ -0,0 +1,113 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#pragma once
+
+#include <quartz/core/Core.hpp>
+#include <quartz/core/utilities/Archive.hpp>
+
+#include <future>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace qz
+{
+	namespace utils
+	{
+		/**
+		 * @brief Reads assets by their logical path, from packed archives or from directories on disk.
+		 *
+		 * Logical paths are relative, e.g. "assets/shaders/main.vert". Archives and directories are searched
+		 * starting with the most recently mounted, so mounting the working directory first and the asset archive
+		 * after it serves everything packed from the archive, and falls back to loose files for anything that isn't.
+		 *
+		 * Mount everything during startup, reading is safe from any thread but mounting is not.
+		 */
+		class QZ_API VirtualFileSystem
+		{
+		public:
+			/**
+			 * @brief Pointer to the static instance of VirtualFileSystem
+			 * @return The VirtualFileSystem singleton.
+			 */
+			static VirtualFileSystem* get();
+
+			/**
+			 * @brief Mounts an asset archive made by the asset packer.
+			 * @param filepath The path of the archive on disk.
+			 * @return Whether the archive could be opened.
+			 */
+			bool mountArchive(const std::string& filepath);
+
+			/**
+			 * @brief Mounts a directory, logical paths are looked up relative to it.
+			 * @param directory The directory on disk.
+			 */
+			void mountDirectory(const std::string& directory);
+
+			/**
+			 * @brief Unmounts every archive and directory.
+			 */
+			void unmountAll();
+
+			/**
+			 * @brief Checks whether a file exists in any of the mounts.
+			 */
+			bool exists(const std::string& path) const;
+
+			/**
+			 * @brief Reads a whole file into a string.
+			 * @param path The logical path of the file.
+			 * @return The contents of the file, empty if it couldn't be found.
+			 */
+			std::string readAllFile(const std::string& path) const;
+
+			/**
+			 * @brief Reads a whole file on the I/O threads, see FileIO::readAllFileAsync.
+			 * @param path The logical path of the file.
+			 * @return A future that holds the contents once they have been read.
+			 */
+			std::future<std::string> readAllFileAsync(const std::string& path) const;
+
+			/**
+			 * @brief Gets the contents of a file, without copying them when it is stored uncompressed in an archive.
+			 * @param path The logical path of the file.
+			 * @param buffer Where the file is read into when it can't be used in place.
+			 * @return The contents of the file, valid until the buffer changes or the archive is unmounted. Empty if
+			 * the file couldn't be found.
+			 */
+			std::string_view view(const std::string& path, std::string& buffer) const;
+
+		private:
+			struct Mount
+			{
+				std::string directory;
+				std::unique_ptr<Archive> archive;
+			};
+
+			std::vector<Mount> m_mounts;
+		};
+	}
+}
@@ -27,14 +27,20 @@
 
 #include <functional>
 #include <unordered_map>
+#include <vector>
 
 namespace qz
 {
 	namespace voxels
 	{
+		class BlockUpdate;
+
 		using BlockCallback = std::function<void()>;
 		using InteractionCallback = std::function<void(int hp)>;
 
+		/// @brief Called on a worker thread by the BlockUpdateScheduler, see BlockUpdate for what it can do.
+		using BlockUpdateCallback = std::function<void(BlockUpdate& update)>;
+
 		/// @brief This defines what state of matter the block is
 		enum class BlockType
 		{
@@ -45,12 +51,22 @@ namespace qz
 			OBJECT,		///< Things like Entities and objects that like transparent turds.
 		};
 
+		/// @brief Whether blocks of this type flow, see FluidEngine.
+		inline bool isFluid(BlockType type)
+		{
+			return type == BlockType::LIQUID || type == BlockType::WATER;
+		}
+
 		class RegistryBlock
 		{
 		public:
 			RegistryBlock() = delete;
 			RegistryBlock(std::string blockID, std::string blockName, int initialHP, BlockType blockType);
 			RegistryBlock(const RegistryBlock& other) = default;
+			RegistryBlock(RegistryBlock&& other) = default;
+
+			RegistryBlock& operator=(const RegistryBlock& other) = default;
+			RegistryBlock& operator=(RegistryBlock&& other) = default;
 
 			~RegistryBlock() = default;
 
@@ -68,11 +84,33 @@ namespace qz
 			const InteractionCallback& getInteractLeftCallback() const;
 			const InteractionCallback& getInteractRightCallback() const;
 
+			/**
+			 * @brief Sets what happens when the block is picked for a random tick, such as grass spreading.
+			 *
+			 * Every tick a few random blocks in each chunk section get a random tick, so a block gets one every
+			 * so often on average. Sections without any blocks that have this callback are skipped.
+			 */
+			void setRandomTickCallback(const BlockUpdateCallback& callback);
+			const BlockUpdateCallback& getRandomTickCallback() const;
+
+			/**
+			 * @brief Sets what happens when an update scheduled with ChunkManager::scheduleBlockUpdate() is due.
+			 */
+			void setScheduledUpdateCallback(const BlockUpdateCallback& callback);
+			const BlockUpdateCallback& getScheduledUpdateCallback() const;
+
 			const std::vector<std::string>& getBlockTextures() const;
 			void setBlockTextures(const std::vector<std::string>& textures);
 
 			int getInitialHP() const;
 
+			/**
+			 * @brief Sets how much light the block gives off.
+			 * @param level The light level, from 0 (none) to 15 (full brightness).
+			 */
+			void setLightEmission(int level);
+			int getLightEmission() const;
+
 		private:
 			std::string m_blockID;
 			std::string m_blockName;
@@ -80,12 +118,17 @@ namespace qz
 
 			std::vector<std::string> m_blockTextures;
 
+			int m_lightEmission = 0;
+
 			BlockCallback m_onPlaceCallback;
 			BlockCallback m_onBreakCallback;
 
 			InteractionCallback m_interactLeftCallback;
 			InteractionCallback m_interactRightCallback;
 
+			BlockUpdateCallback m_randomTickCallback;
+			BlockUpdateCallback m_scheduledUpdateCallback;
+
 			unsigned int m_initialHealthPoints;
 		};
 
@@ -105,6 +148,12 @@ namespace qz
 
 			const std::string& getBlockID() const;
 			BlockType getBlockType() const;
+			int getLightEmission() const;
+
+			/**
+			 * @brief Whether the block was registered with a random tick callback.
+			 */
+			bool hasRandomTicks() const;
 
 			const std::vector<std::string>& getBlockTextures() const;
 
@@ -114,6 +163,8 @@ namespace qz
 			std::string m_blockID;
 			std::string m_blockName;
 			BlockType m_blockType;
+			int m_lightEmission;
+			bool m_randomTicks;
 		};
 
 		class BlockLibrary
@@ -124,6 +175,13 @@ namespace qz
 			void init();
 
 			void registerBlock(const RegistryBlock& block);
+
+			/**
+			 * @brief Registers many blocks at once, such as everything a script defined.
+			 * @param blocks The blocks to register, blocks that are already registered are skipped with a warning.
+			 * @return How many of the blocks were registered.
+			 */
+			std::size_t registerBlocks(std::vector<RegistryBlock>&& blocks);
 			
 			const RegistryBlock& requestBlock(const std::string& blockID) const;
 
@@ -0,0 +1,89 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#pragma once
+
+#include <quartz/core/Core.hpp>
+#include <quartz/core/scripting/LuaState.hpp>
+
+#include <string>
+
+namespace qz
+{
+	namespace voxels
+	{
+		/**
+		 * @brief Lets Lua scripts register blocks with the BlockLibrary.
+		 *
+		 * Scripts call px_register_block(id, definition) with a table such as:
+		 *
+		 * @code
+		 * px_register_block("core:dirt", {
+		 *     displayname = "Dirt",
+		 *     type = BLOCK_SOLID,
+		 *     textures = { "assets/textures/dirt.png", ... },
+		 *     hp = 10, light = 0,
+		 *     on_place = function() end,
+		 *     on_break = function() end,
+		 *     on_interact_left = function(hp) end,
+		 *     on_interact_right = function(hp) end,
+		 * })
+		 * @endcode
+		 *
+		 * px_register_block is plain Lua that only queues the definition, so a script never calls into C++ while it
+		 * runs. Once it has finished every queued definition is read in a single pass and registered in bulk, each
+		 * texture path is only converted once however many blocks share it, and callbacks are kept as registry
+		 * references so invoking one never has to look anything up by name.
+		 */
+		class QZ_API BlockScripting
+		{
+		public:
+			/**
+			 * @brief Sets up px_register_block and the BLOCK_* type constants in the state.
+			 * @param state The state scripts will run in, it must outlive this object.
+			 */
+			explicit BlockScripting(scripting::LuaState& state);
+			~BlockScripting() = default;
+
+			BlockScripting(const BlockScripting& other) = delete;
+			BlockScripting& operator=(const BlockScripting& other) = delete;
+
+			/**
+			 * @brief Runs a script and registers every block it defined.
+			 * @param filepath The logical path of the script.
+			 * @return How many blocks were registered.
+			 */
+			std::size_t runScript(const std::string& filepath);
+
+			/**
+			 * @brief Registers every block defined since the last flush, for definitions made by runString().
+			 * @return How many blocks were registered.
+			 */
+			std::size_t flush();
+
+		private:
+			scripting::LuaState& m_state;
+			scripting::LuaRef m_pending;
+		};
+	}
+}
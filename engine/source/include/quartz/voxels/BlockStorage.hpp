@@ -0,0 +1,176 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#pragma once
+
+#include <quartz/voxels/Block.hpp>
+#include <quartz/voxels/VoxelMath.hpp>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace qz
+{
+	namespace voxels
+	{
+		/**
+		 * @brief Stores the blocks of a chunk.
+		 *
+		 * Most of a world is chunks made entirely of air or stone, so a chunk that is all one block only stores that
+		 * block. The blocks are split into sections of consecutive indices, and a section is only allocated once a
+		 * different block is written to it, this is known as promotion.
+		 *
+		 * A promoted section keeps a palette of the different blocks in it, and a byte per block indexing into it. A
+		 * section rarely holds more than a handful of different blocks, so this costs a fraction of storing a
+		 * BlockInstance for every block, which matters with thousands of chunks loaded.
+		 *
+		 * Sections are shared between copies of the storage and copied on write, so copying the storage to make an
+		 * edit only copies the sections the edit touches. This lets a chunk publish a new version of its blocks
+		 * while readers carry on with the old one.
+		 *
+		 * @tparam Layout Decides the order blocks are stored in, see LinearLayout, MortonLayout and BrickLayout.
+		 */
+		template <typename Layout>
+		class BasicBlockStorage
+		{
+		public:
+			using LayoutType = Layout;
+
+			static constexpr int SECTION_SHIFT = 8;
+			static constexpr std::size_t SECTION_SIZE = std::size_t(1) << SECTION_SHIFT;
+			static constexpr std::size_t SECTION_MASK = SECTION_SIZE - 1;
+			static constexpr std::size_t NUM_SECTIONS = CHUNK_VOLUME / SECTION_SIZE;
+
+			/**
+			 * @brief Constructs storage where every block is the same.
+			 * @param block The block to fill the storage with.
+			 */
+			explicit BasicBlockStorage(const BlockInstance& block);
+			~BasicBlockStorage() = default;
+
+			/**
+			 * @brief Copies the storage, sharing all of its sections until they are written to.
+			 */
+			BasicBlockStorage(const BasicBlockStorage& other);
+			BasicBlockStorage& operator=(const BasicBlockStorage& other);
+
+			BasicBlockStorage(BasicBlockStorage&& other) = default;
+			BasicBlockStorage& operator=(BasicBlockStorage&& other) = default;
+
+			/**
+			 * @brief Gets the index of a block, iterating indices in order walks the storage in memory order.
+			 * @param local The coordinate within the chunk, it must be in bounds.
+			 */
+			static std::size_t getIndex(const Vector3i& local) { return Layout::toIndex(local); }
+			static Vector3i getLocal(std::size_t index) { return Layout::toLocal(index); }
+
+			/**
+			 * @brief Whether every block is the same, in which case no sections are allocated.
+			 */
+			bool isUniform() const;
+
+			/**
+			 * @brief Gets the block that fills every section that hasn't been promoted.
+			 */
+			const BlockInstance& getUniformBlock() const { return m_uniformBlock; }
+
+			const BlockInstance& get(std::size_t index) const
+			{
+				const Section* section = m_sections[index >> SECTION_SHIFT].get();
+				return section == nullptr ? m_uniformBlock : section->palette[section->indices[index & SECTION_MASK]];
+			}
+
+			/**
+			 * @brief Counts the blocks in a section that have random ticks, without looking at the blocks.
+			 * @param section The index of the section, from 0 to NUM_SECTIONS - 1.
+			 */
+			std::size_t getRandomTickCount(std::size_t section) const
+			{
+				if (m_sections[section] == nullptr)
+					return m_uniformBlock.hasRandomTicks() ? SECTION_SIZE : 0;
+
+				return m_randomTickCounts[section];
+			}
+
+			/**
+			 * @brief Whether any block in the storage has random ticks.
+			 */
+			bool hasRandomTicks() const;
+
+			/**
+			 * @brief Sets a block, promoting or copying its section first if needed.
+			 * @param index The index of the block within the chunk.
+			 * @param block The block to store.
+			 */
+			void set(std::size_t index, const BlockInstance& block);
+
+			/**
+			 * @brief Sets every block, releasing all of the sections.
+			 * @param block The block to fill the storage with.
+			 */
+			void fill(const BlockInstance& block);
+
+			/**
+			 * @brief Releases any sections that turn out to be all one block.
+			 *
+			 * This is worth doing after writing a lot of blocks, such as after generating terrain.
+			 */
+			void compact();
+
+		private:
+			struct Section
+			{
+				std::vector<BlockInstance> palette;
+				std::array<std::uint8_t, SECTION_SIZE> indices;
+			};
+
+			static_assert(SECTION_SIZE <= 256, "Every block of a section must be able to have its own palette entry.");
+
+			static_assert(NUM_SECTIONS <= 32, "Owned sections are tracked with a 32 bit mask.");
+
+			BlockInstance m_uniformBlock;
+			std::array<std::shared_ptr<Section>, NUM_SECTIONS> m_sections;
+
+			// The sections this storage has its own copy of, and so can write to without affecting other copies.
+			std::uint32_t m_ownedSections = 0;
+
+			// Kept up to date by set(), only meaningful for sections that have been promoted.
+			std::array<std::uint16_t, NUM_SECTIONS> m_randomTickCounts = {};
+
+			Section& makeWritable(std::size_t section);
+
+			// Finds the palette entry for a block about to be written to a slot of a section, adding it if the
+			// section doesn't have one yet.
+			static std::uint8_t getPaletteIndex(Section& section, std::size_t slot, const BlockInstance& block);
+		};
+
+		extern template class BasicBlockStorage<LinearLayout>;
+		extern template class BasicBlockStorage<MortonLayout>;
+		extern template class BasicBlockStorage<BrickLayout>;
+
+		/// @brief The storage used by chunks, laid out by the ChunkLayout picked at compile time.
+		using BlockStorage = BasicBlockStorage<ChunkLayout>;
+	}
+}
@@ -0,0 +1,182 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#pragma once
+
+#include <quartz/core/utilities/ThreadPool.hpp>
+#include <quartz/voxels/Chunk.hpp>
+#include <quartz/voxels/FixedTimestep.hpp>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace qz
+{
+	namespace voxels
+	{
+		class ChunkManager;
+
+		/**
+		 * @brief What a block update callback is given to work with.
+		 *
+		 * Updates run on worker threads, several chunks at a time. They can look at the world, but changes are only
+		 * queued, and are applied together once every update in the tick has run.
+		 */
+		class BlockUpdate
+		{
+		public:
+			const ChunkManager& getWorld() const		{ return *m_world; }
+			const qz::Vector3i& getPosition() const		{ return m_position; }
+			const BlockInstance& getBlock() const		{ return *m_block; }
+
+			/**
+			 * @brief Queues a block to be set once the tick is over.
+			 * @param position The world coordinates of the block, it doesn't have to be the one being updated.
+			 * @param block The new block.
+			 * @param type Which callbacks should be fired when the block is set.
+			 */
+			void setBlock(const qz::Vector3i& position, const BlockInstance& block, BlockEditType type = BlockEditType::SET);
+
+			/**
+			 * @brief Schedules an update for a block, see ChunkManager::scheduleBlockUpdate().
+			 */
+			void scheduleUpdate(const qz::Vector3i& position, unsigned int delay);
+
+			/**
+			 * @brief Gets a random number, for things like the chance of a plant growing.
+			 *
+			 * Each chunk is updated with its own generator, so this is safe to use from any update.
+			 */
+			std::uint32_t random() { return (*m_random)(); }
+
+		private:
+			friend class BlockUpdateScheduler;
+
+			struct Scheduled
+			{
+				qz::Vector3i position;
+				unsigned int delay;
+			};
+
+			const ChunkManager* m_world = nullptr;
+			qz::Vector3i m_position;
+			const BlockInstance* m_block = nullptr;
+
+			std::minstd_rand* m_random = nullptr;
+			std::vector<BlockEdit>* m_edits = nullptr;
+			std::vector<Scheduled>* m_scheduled = nullptr;
+		};
+
+		/**
+		 * @brief Runs random ticks and scheduled updates for the blocks in the world, on a fixed tick.
+		 *
+		 * Scheduled updates are kept in a timing wheel, a ring of slots one tick apart, so scheduling and running an
+		 * update doesn't depend on how many others are waiting. Updates further away than the wheel goes round wait
+		 * for the wheel to come back round to them.
+		 *
+		 * Random ticks pick RANDOM_TICKS_PER_SECTION blocks in every section of every chunk each tick. Chunks keep
+		 * count of the blocks that have random ticks in each section, so sections without any are skipped without
+		 * looking at their blocks, and most chunks cost next to nothing.
+		 *
+		 * Each chunk's updates are run together on the thread pool, then the edits they queued are applied in one
+		 * batch through ChunkManager::applyEdits().
+		 */
+		class BlockUpdateScheduler
+		{
+		public:
+			static constexpr int TICKS_PER_SECOND = 20;
+			static constexpr int RANDOM_TICKS_PER_SECTION = 3;
+			static constexpr std::size_t WHEEL_SIZE = 256;
+
+			/**
+			 * @brief Creates the scheduler for a world.
+			 * @param world The world to update.
+			 * @param threadPool The pool chunks are updated on, tick() waits for it to finish.
+			 */
+			BlockUpdateScheduler(ChunkManager* world, threads::utils::ThreadPool<>& threadPool);
+			~BlockUpdateScheduler() = default;
+
+			/**
+			 * @brief Runs as many ticks as have passed, at TICKS_PER_SECOND.
+			 * @param dt The time since the last update, in seconds.
+			 */
+			void update(float dt);
+
+			/**
+			 * @brief Runs a single tick, no matter how much time has passed.
+			 */
+			void tick();
+
+			/**
+			 * @brief Schedules an update for a block.
+			 * @param position The world coordinates of the block.
+			 * @param delay How many ticks from now the update should run, at least 1.
+			 *
+			 * The update runs the scheduled update callback of whichever block is there when it is due.
+			 */
+			void schedule(const qz::Vector3i& position, unsigned int delay);
+
+			/**
+			 * @brief Drops the updates scheduled in a chunk that is about to be unloaded.
+			 * @param chunkPos The coordinates of the chunk, counted in chunks.
+			 */
+			void unloadChunk(const qz::Vector3i& chunkPos);
+
+			/**
+			 * @brief The number of updates waiting to run.
+			 */
+			std::size_t getScheduledCount() const;
+
+		private:
+			struct ScheduledUpdate
+			{
+				qz::Vector3i position;
+				std::uint32_t rounds; ///< How many more times the wheel has to go round before the update is due.
+			};
+
+			struct ChunkJob
+			{
+				Chunk* chunk;
+				std::shared_ptr<const BlockStorage> blocks;
+				bool randomTicks = false;
+				std::vector<std::uint16_t> scheduled;
+
+				std::vector<BlockEdit> edits;
+				std::vector<BlockUpdate::Scheduled> newlyScheduled;
+			};
+
+			void run(ChunkJob& job) const;
+
+			ChunkManager* m_world;
+			threads::utils::ThreadPool<>& m_threadPool;
+
+			std::array<std::vector<ScheduledUpdate>, WHEEL_SIZE> m_wheel;
+			std::uint64_t m_currentTick = 0;
+
+			FixedTimestep m_timestep;
+		};
+	}
+}
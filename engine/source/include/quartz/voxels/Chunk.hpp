@@ -23,19 +23,24 @@
 
 #pragma once
 
+#include <array>
 #include <vector>
 #include <mutex>
+#include <memory>
 
-#include <quartz/core/math/Vector2.hpp>
-#include <quartz/core/math/Vector3.hpp>
+#include <quartz/core/math/Math.hpp>
 
 #include <quartz/voxels/Block.hpp>
+#include <quartz/voxels/BlockStorage.hpp>
+#include <quartz/voxels/FluidMap.hpp>
+#include <quartz/voxels/LightMap.hpp>
+#include <quartz/voxels/MeshPool.hpp>
+#include <quartz/voxels/VoxelMath.hpp>
 
 #include <quartz/core/graphics/gl/VertexBuffer.hpp>
 #include <quartz/core/graphics/gl/VertexArray.hpp>
 #include <quartz/core/graphics/gl/TextureArray.hpp>
 
-#include <quartz/core/utils/ThreadPool.hpp>
 #include <atomic>
 
 namespace qz
@@ -50,6 +55,28 @@ namespace qz
 			NEEDS_MESHING			= 1 << 3,
 			BLOCKS_NEED_TEXTURING	= 1 << 4,
 			OBJECTS_NEED_TEXTURING	= 1 << 5,
+			WATER_NEEDS_TEXTURING	= 1 << 6,
+		};
+
+		/// @brief The coarsest level of detail a chunk can be meshed at, level n meshes cubes 2^n blocks wide.
+		constexpr int MAX_CHUNK_LOD = 3;
+
+		/// @brief Decides which callbacks are fired when a block is edited.
+		enum class BlockEditType
+		{
+			SET,	///< Replaces the block without firing any callbacks.
+			PLACE,	///< Fires the place callback of the new block.
+			BREAK,	///< Fires the break callback of the block being replaced.
+		};
+
+		/**
+		 * @brief A single edit within a batch, see ChunkManager::applyEdits.
+		 */
+		struct BlockEdit
+		{
+			qz::Vector3i position;
+			BlockInstance block;
+			BlockEditType type = BlockEditType::SET;
 		};
 
 		enum class BlockFace : int
@@ -64,18 +91,23 @@ namespace qz
 
 		struct Mesh
 		{
-			std::vector<qz::Vector3> vertices;
-			std::vector<qz::Vector3> normals;
-			std::vector<qz::Vector2> uvs;
-			std::vector<int> texLayers;
+			MeshBufferPool::Buffer vertices; ///< Already in the format the GPU wants, so it is uploaded without copying.
 
+			/**
+			 * @brief Empties the mesh and gives its memory back to the MeshBufferPool.
+			 */
 			void reset();
-			void update(const Mesh& other);
+
+			/**
+			 * @brief Empties the mesh, but keeps hold of its memory for when it gets rebuilt.
+			 */
+			void clear();
 
 			std::size_t triangleCount() const;
 		};
 
 		class Chunk;
+		class ChunkManager;
 
 		class ChunkMesh
 		{
@@ -89,18 +121,54 @@ namespace qz
 			ChunkMesh(ChunkMesh&& other);
 			ChunkMesh& operator=(ChunkMesh&& other);
 
-			void add(const BlockInstance& block, BlockFace face, qz::Vector3 chunkPos, qz::Vector3 blockPos, Chunk* chunk);
+			/**
+			 * @brief Adds a face of a block to the mesh.
+			 * @param block The block the face belongs to.
+			 * @param face Which face of the block to add.
+			 * @param chunkPos The coordinates of the chunk, counted in chunks.
+			 * @param blockPos The position of the block within the chunk.
+			 * @param light The packed light levels of the block the face is facing.
+			 * @param ao The ambient occlusion at each corner of the face, from 0 (fully occluded) to 3 (unoccluded).
+			 * @param chunk The chunk the mesh belongs to.
+			 * @param size The width of the cube in blocks, coarser levels of detail mesh cubes that stand in for
+			 * several blocks. blockPos is then the lowest block the cube covers.
+			 */
+			void add(const BlockInstance& block, BlockFace face, const qz::Vector3i& chunkPos, const qz::Vector3i& blockPos, std::uint8_t light, const std::array<std::uint8_t, 4>& ao, Chunk* chunk, int size = 1);
+
+			/**
+			 * @brief Adds a face of a fluid block to the water mesh.
+			 * @param block The fluid block the face belongs to.
+			 * @param face Which face of the block to add.
+			 * @param chunkPos The coordinates of the chunk, counted in chunks.
+			 * @param blockPos The position of the block within the chunk.
+			 * @param light The packed light levels of the block the face is facing.
+			 * @param height How full the block is, from 0 to 1, the top of the block is lowered to match.
+			 * @param chunk The chunk the mesh belongs to.
+			 */
+			void addFluid(const BlockInstance& block, BlockFace face, const qz::Vector3i& chunkPos, const qz::Vector3i& blockPos, std::uint8_t light, float height, Chunk* chunk);
 
 			const Mesh& getBlockMesh() const;
 			const Mesh& getObjectMesh() const;
 			const Mesh& getWaterMesh() const;
 
+			/**
+			 * @brief Moves the block mesh out, so it can be handed to the renderer without copying it.
+			 * @return The block mesh, the next mesh is built in a fresh buffer from the MeshBufferPool.
+			 */
+			Mesh takeBlockMesh();
+			Mesh takeWaterMesh();
+
 			void resetAll();
+			void clearAll();
 
 		private:
 			Mesh m_blockMesh;
 			Mesh m_objectMesh;
 			Mesh m_waterMesh;
+
+			// How big the last block mesh was, the next one is likely to be about the same.
+			std::size_t m_blockVertexHint = 0;
+			std::size_t m_waterVertexHint = 0;
 		};
 
 		class ChunkRenderer
@@ -116,9 +184,24 @@ namespace qz
 			ChunkRenderer& operator=(ChunkRenderer&& other);
 
 			void resetMesh();
-			void updateMesh(const Mesh& mesh);
 
-			void reserveTexture(const std::string& path);
+			/**
+			 * @brief Takes a new mesh to upload, its buffer goes back to the MeshBufferPool once bufferData() is done.
+			 * @param mesh The new mesh.
+			 */
+			void updateMesh(Mesh&& mesh);
+
+			/**
+			 * @brief Gets the mesh waiting to be uploaded, it is empty once bufferData() has been called.
+			 */
+			const Mesh& getMesh() const;
+
+			/**
+			 * @brief Reserves a layer in the texture array for a texture, if it doesn't already have one.
+			 * @param path The path of the texture.
+			 * @return The layer reserved for the texture.
+			 */
+			int reserveTexture(const std::string& path);
 			int getTexLayer(const std::string& path);
 
 			void loadTextures();
@@ -131,6 +214,9 @@ namespace qz
 		private:
 			Mesh m_mesh;
 
+			// The number of vertices that were last uploaded, m_mesh is empty after uploading.
+			std::size_t m_vertexCount = 0;
+
 			gfx::gl::VertexArray* m_vao = nullptr;
 			gfx::gl::VertexBuffer* m_vbo = nullptr;
 
@@ -152,7 +238,13 @@ namespace qz
 			Chunk(Chunk&& other);
 			Chunk& operator=(Chunk&& other);
 
-			Chunk(qz::Vector3 chunkPos, unsigned int chunkSize, const std::string& defaultBlockID);
+			/**
+			 * @brief Constructs an empty chunk, populateData() fills it with blocks.
+			 * @param manager The manager the chunk belongs to, used to look at neighbouring chunks while meshing.
+			 * @param chunkPos The coordinates of the chunk, counted in chunks rather than blocks.
+			 * @param defaultBlockID The block to fill the chunk with before generating terrain.
+			 */
+			Chunk(ChunkManager* manager, const qz::Vector3i& chunkPos, const std::string& defaultBlockID);
 
 			~Chunk() = default;
 
@@ -160,14 +252,78 @@ namespace qz
 
 			void buildMesh();
 
-			const ChunkMesh& getChunkMesh() const;
-			const Vector3& getChunkPos() const;
-
-			void breakBlockAt(qz::Vector3 position, const BlockInstance& block);
-			void placeBlockAt(qz::Vector3 position, const BlockInstance& block);
+			/**
+			 * @brief Sets how coarsely the chunk is meshed, flagging it for meshing if that changes.
+			 * @param lod The level of detail, from 0 (every block) to MAX_CHUNK_LOD.
+			 *
+			 * At level n the blocks are downsampled into cubes 2^n blocks wide, each filled if at least half of its
+			 * blocks are solid. The blocks themselves are kept at full detail, so edits and lighting are unaffected.
+			 */
+			void setLOD(int lod);
+			int getLOD() const;
 
-			BlockInstance getBlockAt(qz::Vector3 position) const;
-			void setBlockAt(qz::Vector3 position, const BlockInstance& newBlock);
+			const ChunkMesh& getChunkMesh() const;
+			const Vector3i& getChunkPos() const;
+
+			/**
+			 * @brief Whether the chunk is entirely one block, in which case it has no block array.
+			 */
+			bool isUniform() const;
+
+			/**
+			 * @brief Whether the chunk is entirely one non solid block such as air, there is nothing to mesh or light.
+			 */
+			bool isEmpty() const;
+
+			/**
+			 * @brief Gets a snapshot of the blocks in the chunk.
+			 *
+			 * Edits never change a published snapshot, they publish a new one. So the snapshot can be read from any
+			 * thread without locking, and it stays consistent while the chunk is being edited.
+			 */
+			std::shared_ptr<const BlockStorage> getBlocks() const;
+
+			// All block positions are local to the chunk, positions outside of it are ignored.
+
+			void breakBlockAt(const qz::Vector3i& position, const BlockInstance& block);
+			void placeBlockAt(const qz::Vector3i& position, const BlockInstance& block);
+
+			BlockInstance getBlockAt(const qz::Vector3i& position) const;
+			BlockType getBlockTypeAt(const qz::Vector3i& position) const;
+			int getLightEmissionAt(const qz::Vector3i& position) const;
+			void setBlockAt(const qz::Vector3i& position, const BlockInstance& newBlock);
+
+			/**
+			 * @brief Applies a batch of edits under a single lock, and flags the chunk for meshing once.
+			 * @param edits The edits to apply, all of them must be for this chunk.
+			 *
+			 * The edit positions may be in world coordinates, only the position within the chunk is used. Callbacks
+			 * are fired after all edits have been applied and the chunk has been unlocked.
+			 */
+			void applyEdits(const std::vector<const BlockEdit*>& edits);
+
+			/**
+			 * @brief Fills a box of blocks under a single lock, and flags the chunk for meshing once.
+			 * @param min The lowest corner of the box, local to the chunk.
+			 * @param max The highest corner of the box, local to the chunk, inclusive.
+			 * @param block The block to fill the box with.
+			 * @param type Which callbacks should be fired for each block.
+			 */
+			void fillRegion(const qz::Vector3i& min, const qz::Vector3i& max, const BlockInstance& block, BlockEditType type);
+
+			LightMap& getLightMap();
+			const LightMap& getLightMap() const;
+
+			/**
+			 * @brief Gets the fluid levels of the chunk, these are only changed by the FluidEngine.
+			 */
+			FluidMap& getFluidMap();
+			const FluidMap& getFluidMap() const;
+
+			/**
+			 * @brief Flags the chunk to be meshed again, such as when its lighting changes.
+			 */
+			void flagForMeshing();
 
 			ChunkRenderer& getBlockRenderer();
 			ChunkRenderer& getObjectRenderer();
@@ -178,8 +334,27 @@ namespace qz
 			void renderWater(int* counter);
 
 		private:
-			qz::Vector3 m_chunkPos;
-			unsigned int m_chunkSize;
+			std::shared_ptr<BlockStorage> beginWrite() const;
+			void publish(std::shared_ptr<BlockStorage> blocks);
+
+			void buildFullMesh(const BlockStorage& blocks);
+			void buildLODMesh(const BlockStorage& blocks, int lod);
+
+			// A chunk of a single solid block only has faces on its border, so they are added without scanning it.
+			void buildShellMesh(const BlockStorage& blocks);
+
+			// Whether the chunk is a single solid block and so are all 6 of its neighbours, so none of it can be seen.
+			bool isBuried(const BlockStorage& blocks) const;
+
+			// Adds the faces of a fluid block that aren't against the same fluid. Bit n of openFaces is set if face n
+			// isn't against a solid block.
+			void addFluidFaces(const BlockStorage& blocks, const BlockInstance& block, const qz::Vector3i& pos, unsigned int openFaces);
+
+			// The light a face is lit by, from the block it faces, which may be in a neighbouring chunk.
+			std::uint8_t getFaceLight(const qz::Vector3i& neighbour) const;
+
+			ChunkManager* m_manager;
+			qz::Vector3i m_chunkPos;
 
 			ChunkMesh m_mesh;
 
@@ -188,17 +363,17 @@ namespace qz
 			ChunkRenderer m_waterRenderer;
 
 			std::atomic<unsigned int> m_chunkFlags;
+			std::atomic<int> m_lod;
 
 			std::string m_defaultBlockID;
-			std::vector<BlockInstance> m_chunkBlocks;
-
-			std::mutex m_chunkMutex;
-			threads::ThreadPool<1> m_threadPool;
-
-			std::size_t getVectorIndex(std::size_t x, std::size_t y, std::size_t z) const
-			{
-				return x + m_chunkSize * (y + m_chunkSize * z);
-			}
+			// Only ever replaced as a whole, through std::atomic_load() and std::atomic_store().
+			std::shared_ptr<const BlockStorage> m_blocks;
+			LightMap m_lightMap;
+			FluidMap m_fluidMap;
+
+			// Writers copy the current blocks, edit the copy and publish it, one writer at a time.
+			std::mutex m_writeMutex;
+			std::mutex m_meshMutex;
 		};
 
 	}
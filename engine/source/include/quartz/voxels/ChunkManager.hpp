@@ -24,46 +24,223 @@
 #pragma once
 
 #include <quartz/core/utils/ThreadPool.hpp>
+#include <quartz/core/math/Ray.hpp>
 
 #include <quartz/voxels/Block.hpp>
+#include <quartz/voxels/BlockUpdateScheduler.hpp>
 #include <quartz/voxels/Chunk.hpp>
+#include <quartz/voxels/FluidEngine.hpp>
+#include <quartz/voxels/LightEngine.hpp>
+#include <quartz/voxels/Physics.hpp>
+#include <quartz/voxels/VoxelMath.hpp>
+#include <quartz/voxels/entities/EntityWorld.hpp>
 #include <quartz/voxels/terrain/PerlinNoise.hpp>
 
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
 namespace qz
 {
 	namespace voxels
 	{
+		/**
+		 * @brief The result of a successful raycast against the world.
+		 */
+		struct RaycastHit
+		{
+			BlockInstance block;	///< The block that was hit.
+			qz::Vector3i position;	///< The world coordinates of the block that was hit.
+			qz::Vector3i normal;	///< The normal of the face the ray entered through, zero if the ray started inside the block.
+			float distance = 0.f;	///< The distance along the ray to where it entered the block.
+		};
+
 		class ChunkManager
 		{
 		public:
-			ChunkManager(const std::string& blockID, int chunkSize, unsigned int seed);
-			ChunkManager(ChunkManager&& other) = default;
+			ChunkManager(const std::string& blockID, unsigned int seed);
+
+			// The chunks and the light engine point back to the manager, so it can't be moved.
+			ChunkManager(const ChunkManager& other) = delete;
+			ChunkManager(ChunkManager&& other) = delete;
 
 			~ChunkManager() = default;
 
 			void toggleWireframe();
 			bool isWireframe() const;;
 
+			/**
+			 * @brief Loads the chunks around the camera, and picks the level of detail of every loaded chunk.
+			 * @param cameraPosition The position of the camera, in render space.
+			 *
+			 * Only a few chunks are generated per call, nearest first, so it should be called every frame until the
+			 * whole view distance has been loaded. Chunks the camera has moved away from are unloaded.
+			 */
 			void determineGeneration(qz::Vector3 cameraPosition);
+
+			/**
+			 * @brief Sets how far around the camera chunks are loaded.
+			 * @param horizontal The distance along x and z, counted in chunks.
+			 * @param vertical The distance along y, counted in chunks. Terrain is much wider than it is tall, so
+			 * this can usually be a lot smaller.
+			 *
+			 * Chunks that are now out of view are unloaded straight away.
+			 */
+			void setViewDistance(int horizontal, int vertical);
+			int getViewDistance() const;
+			int getVerticalViewDistance() const;
+
+			/**
+			 * @brief Sets where chunks switch to coarser meshes.
+			 * @param distances For each level of detail from 1 up, the distance in chunks from the camera at which
+			 * it starts. They must be increasing.
+			 *
+			 * Each level halves the resolution, so with distances that double at each level, chunks far away cost
+			 * about as many triangles on screen as the ones close by.
+			 */
+			void setLODDistances(const std::array<int, MAX_CHUNK_LOD>& distances);
 			void testGeneration();
+
+			/**
+			 * @brief Advances everything in the world that changes over time, such as flowing water, block updates and
+			 * entities.
+			 * @param dt The time since the last update, in seconds.
+			 */
+			void update(float dt);
+
+			/**
+			 * @brief Schedules an update for a block, which runs its scheduled update callback.
+			 * @param position The world coordinates of the block.
+			 * @param delay How many block update ticks from now the update should run, there are
+			 * BlockUpdateScheduler::TICKS_PER_SECOND of them a second.
+			 */
+			void scheduleBlockUpdate(const qz::Vector3i& position, unsigned int delay);
+
+			/**
+			 * @brief Gets the entities in the world.
+			 */
+			entities::EntityWorld& getEntities();
+			const entities::EntityWorld& getEntities() const;
+
+			/**
+			 * @brief Gets the physics system, which moves every entity with a PhysicsBody on every update().
+			 */
+			PhysicsSystem& getPhysics();
+			const PhysicsSystem& getPhysics() const;
+
+			/**
+			 * @brief Calls a function for every loaded chunk, in no particular order.
+			 */
+			void forEachChunk(const std::function<void(Chunk*)>& function);
+
+			/**
+			 * @brief Unloads the chunks further than the view distance from the camera, plus a margin.
+			 *
+			 * The margin keeps chunks loaded while the camera moves back and forth across a chunk border, rather
+			 * than regenerating them every time. Anything the world's systems had queued in the chunks is dropped.
+			 */
 			void unloadRedundant();
 
-			void setBlockAt(qz::Vector3 position, const BlockInstance& block);
-			BlockInstance getBlockAt(qz::Vector3 position) const;
+			/**
+			 * @brief The number of chunks currently loaded.
+			 */
+			std::size_t getChunkCount() const;
+
+			/**
+			 * @brief Finds a loaded chunk.
+			 * @param chunkPos The coordinates of the chunk, counted in chunks rather than blocks.
+			 * @return The chunk, or nullptr if it isn't loaded.
+			 */
+			Chunk* getChunk(const qz::Vector3i& chunkPos);
+			const Chunk* getChunk(const qz::Vector3i& chunkPos) const;
 
-			void breakBlockAt(qz::Vector3 position, const BlockInstance& block);
-			void placeBlockAt(qz::Vector3 position, const BlockInstance& block);
+			// All block positions are in world block coordinates, use worldToBlock() to convert from a float position.
+
+			void setBlockAt(const qz::Vector3i& position, const BlockInstance& block);
+			BlockInstance getBlockAt(const qz::Vector3i& position) const;
+
+			void breakBlockAt(const qz::Vector3i& position, const BlockInstance& block);
+			void placeBlockAt(const qz::Vector3i& position, const BlockInstance& block);
+
+			/**
+			 * @brief Gets the light levels of a block.
+			 * @param position The world coordinates of the block.
+			 * @return The sky light in the high nibble and the block light in the low nibble, blocks that aren't
+			 * loaded are treated as open sky.
+			 */
+			std::uint8_t getLightAt(const qz::Vector3i& position) const;
+
+			/**
+			 * @brief Gets how much fluid is in a block.
+			 * @param position The world coordinates of the block.
+			 * @return The level, from 0 (none) to FluidMap::MAX_LEVEL (full).
+			 */
+			int getFluidLevelAt(const qz::Vector3i& position) const;
+
+			/**
+			 * @brief Applies a batch of edits, such as an explosion or a paste.
+			 * @param edits The edits to apply, edits in chunks that aren't loaded are dropped.
+			 *
+			 * Edits are grouped by chunk so each chunk is looked up, locked and flagged for meshing once, no matter how
+			 * many of its blocks change.
+			 */
+			void applyEdits(const std::vector<BlockEdit>& edits);
+
+			/**
+			 * @brief Fills a box of blocks, in world block coordinates.
+			 * @param min The lowest corner of the box.
+			 * @param max The highest corner of the box, inclusive.
+			 * @param block The block to fill the box with.
+			 * @param type Which callbacks should be fired for each block.
+			 */
+			void fillRegion(const qz::Vector3i& min, const qz::Vector3i& max, const BlockInstance& block, BlockEditType type = BlockEditType::SET);
+
+			/**
+			 * @brief Finds the first non gaseous block along a ray.
+			 * @param ray The ray to cast, in block space where each block is 1 unit in size.
+			 * @param maxDistance How far along the ray to search.
+			 * @param hit Receives the details of the hit, if there was one.
+			 * @return Whether a block was hit.
+			 *
+			 * This walks every block the ray passes through in order (Amanatides & Woo), so it can't skip past
+			 * corners like stepping along the ray at a fixed interval can. The camera position can be moved into
+			 * block space with (position / 2) + 0.5, as blocks are rendered 2 units in size.
+			 */
+			bool raycast(const math::Ray& ray, float maxDistance, RaycastHit& hit) const;
 						
 			void render(int bufferCounter);
 
 		private:
+			// The level of detail for a chunk this far from the camera, ignoring hysteresis.
+			int getLODForDistance(int distance) const;
+			void updateLOD();
+
 			unsigned int m_seed;
-			int m_chunkSize;
 			std::string m_defaultBlockID;
 
-			std::vector<Chunk> m_chunks;
+			// Chunks are heap allocated so pointers to them stay valid as more chunks get loaded.
+			std::unordered_map<std::uint64_t, std::unique_ptr<Chunk>> m_chunks;
+
+			// Shared by everything that works on many chunks at once, each of them waits for it to finish.
+			threads::utils::ThreadPool<> m_threadPool;
+
+			LightEngine m_lightEngine;
+			FluidEngine m_fluidEngine;
+			BlockUpdateScheduler m_blockUpdates;
+
+			entities::EntityWorld m_entities;
+			PhysicsSystem m_physics;
 
 			bool m_wireframe = false;
+
+			int m_viewDistance;
+			int m_verticalViewDistance;
+			std::array<int, MAX_CHUNK_LOD> m_lodDistances;
+
+			qz::Vector3i m_cameraChunk;
+			bool m_lodNeedsUpdate = true;
 		};
 
 	}
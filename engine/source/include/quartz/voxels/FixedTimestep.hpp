@@ -0,0 +1,82 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#pragma once
+
+namespace qz
+{
+	namespace voxels
+	{
+		/**
+		 * @brief Turns frame times into a whole number of fixed length ticks, for the systems that run on a tick.
+		 *
+		 * The time that doesn't make up a whole tick is carried over to the next frame, so ticks keep to the same
+		 * rate however long frames take.
+		 */
+		class FixedTimestep
+		{
+		public:
+			/// @brief After a long frame, the ticks that didn't fit are dropped rather than making the next frame even longer.
+			static constexpr int MAX_TICKS_PER_UPDATE = 4;
+
+			explicit FixedTimestep(int ticksPerSecond) :
+				m_tickLength(1.f / ticksPerSecond)
+			{}
+
+			/**
+			 * @brief Adds the time since the last update, and takes away the ticks it adds up to.
+			 * @param dt The time since the last update, in seconds.
+			 * @return How many ticks to run, at most MAX_TICKS_PER_UPDATE.
+			 */
+			int consume(float dt)
+			{
+				m_accumulator += dt;
+
+				int ticks = 0;
+				while (m_accumulator >= m_tickLength)
+				{
+					if (ticks == MAX_TICKS_PER_UPDATE)
+					{
+						m_accumulator = 0.f;
+						break;
+					}
+
+					m_accumulator -= m_tickLength;
+					++ticks;
+				}
+
+				return ticks;
+			}
+
+			/**
+			 * @brief Gets how far the current time is between the last tick and the next one.
+			 * @return From 0, at the last tick, to 1, at the next one.
+			 */
+			float getRemainder() const { return m_accumulator / m_tickLength; }
+
+		private:
+			float m_tickLength;
+			float m_accumulator = 0.f;
+		};
+	}
+}
@@ -0,0 +1,146 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#pragma once
+
+#include <quartz/core/utilities/ThreadPool.hpp>
+#include <quartz/voxels/FixedTimestep.hpp>
+#include <quartz/voxels/FluidMap.hpp>
+
+#include <bitset>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace qz
+{
+	namespace voxels
+	{
+		class Chunk;
+		class ChunkManager;
+
+		/**
+		 * @brief Flows liquids through the world one block at a time, on a fixed tick.
+		 *
+		 * Only blocks that might change are looked at. Each chunk keeps a set of active blocks, a block that changes
+		 * wakes the blocks whose next level depends on it, and blocks that don't change go back to sleep. So a still
+		 * lake costs nothing, and the cost of a tick is down to how much fluid is moving.
+		 *
+		 * Falling fluid is full, fluid resting on something spreads sideways losing a level with each block, and
+		 * fluid that is no longer fed by a source drains away. A tick reads the levels the last tick left behind, so
+		 * every active chunk is worked out at the same time on the thread pool. The changes are then applied on the
+		 * calling thread, which is also where blocks woken in neighbouring chunks are handed over to them.
+		 */
+		class FluidEngine
+		{
+		public:
+			static constexpr int TICKS_PER_SECOND = 4;
+
+			/**
+			 * @brief Creates the fluid engine for a world.
+			 * @param world The world to simulate.
+			 * @param emptyBlockID The block left behind when fluid drains out of a block.
+			 * @param threadPool The pool chunks are simulated on, tick() waits for it to finish.
+			 */
+			FluidEngine(ChunkManager* world, const std::string& emptyBlockID, threads::utils::ThreadPool<>& threadPool);
+			~FluidEngine() = default;
+
+			/**
+			 * @brief Runs as many ticks as have passed, at TICKS_PER_SECOND.
+			 * @param dt The time since the last update, in seconds.
+			 */
+			void update(float dt);
+
+			/**
+			 * @brief Runs a single tick, no matter how much time has passed.
+			 */
+			void tick();
+
+			/**
+			 * @brief Tells the engine a block has been changed by something other than the fluid itself.
+			 * @param position The world coordinates of the block.
+			 *
+			 * The fluid in the block is reset, a fluid block becomes a source, and the block and its neighbours
+			 * are woken up to flow into, or drain out of, the space.
+			 */
+			void queueBlockChange(const qz::Vector3i& position);
+
+			/**
+			 * @brief Wakes every fluid block in a freshly generated chunk, so generated water starts flowing.
+			 * @param chunk The chunk, it must already be loaded into the world.
+			 */
+			void wakeChunk(Chunk* chunk);
+
+			/**
+			 * @brief Forgets the active blocks of a chunk that is about to be unloaded.
+			 * @param chunkPos The coordinates of the chunk, counted in chunks.
+			 *
+			 * Generated fluid is woken up again by wakeChunk() when the chunk is next loaded.
+			 */
+			void unloadChunk(const qz::Vector3i& chunkPos);
+
+			/**
+			 * @brief The number of blocks waiting to be looked at next tick, across the whole world.
+			 */
+			std::size_t getActiveCount() const;
+
+		private:
+			struct ActiveSet
+			{
+				qz::Vector3i chunkPos;
+				std::vector<std::uint16_t> blocks;
+				std::bitset<CHUNK_VOLUME> queued;
+			};
+
+			struct FluidChange
+			{
+				std::uint16_t index;
+				std::uint8_t fluid;
+				std::string blockID; ///< The block to put in, or empty to leave the block as it is.
+			};
+
+			struct ChunkJob
+			{
+				Chunk* chunk;
+				std::vector<std::uint16_t> blocks;
+				std::vector<FluidChange> changes;
+			};
+
+			void wake(const qz::Vector3i& position);
+			void wakeDependents(const qz::Vector3i& position);
+
+			void simulate(ChunkJob& job) const;
+			void apply(ChunkJob& job);
+
+			ChunkManager* m_world;
+			std::string m_emptyBlockID;
+
+			std::unordered_map<std::uint64_t, ActiveSet> m_active;
+
+			FixedTimestep m_timestep;
+
+			threads::utils::ThreadPool<>& m_threadPool;
+		};
+	}
+}
@@ -0,0 +1,68 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#pragma once
+
+#include <quartz/voxels/VoxelMath.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace qz
+{
+	namespace voxels
+	{
+		/**
+		 * @brief Stores how much fluid is in every block of a chunk.
+		 *
+		 * Each block gets a single byte, the level is kept in the low nibble and the high nibble holds flags. A fluid
+		 * block with no level has never been simulated, so it was placed or generated and becomes a source.
+		 */
+		class FluidMap
+		{
+		public:
+			static constexpr int MAX_LEVEL = 8;
+
+			/// @brief Sources stay full, everything else drains away unless a source keeps it topped up.
+			static constexpr std::uint8_t SOURCE = 0x10;
+
+			FluidMap() : m_fluid(CHUNK_VOLUME, 0) {}
+
+			int getLevel(std::size_t index) const					{ return m_fluid[index] & 0x0F; }
+			bool isSource(std::size_t index) const					{ return (m_fluid[index] & SOURCE) != 0; }
+
+			/**
+			 * @brief Gets the level and flags of a block, packed into a single byte.
+			 * @param index The index of the block within the chunk.
+			 * @return The level in the low nibble, and the flags in the high nibble.
+			 */
+			std::uint8_t getPacked(std::size_t index) const		{ return m_fluid[index]; }
+			void setPacked(std::size_t index, std::uint8_t fluid)	{ m_fluid[index] = fluid; }
+
+			void clear()											{ m_fluid.assign(CHUNK_VOLUME, 0); }
+
+		private:
+			std::vector<std::uint8_t> m_fluid;
+		};
+	}
+}
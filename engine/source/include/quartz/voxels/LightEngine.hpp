@@ -0,0 +1,123 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#pragma once
+
+#include <quartz/voxels/BlockStorage.hpp>
+#include <quartz/voxels/LightMap.hpp>
+
+#include <memory>
+#include <queue>
+#include <unordered_set>
+
+namespace qz
+{
+	namespace voxels
+	{
+		class Chunk;
+		class ChunkManager;
+
+		/**
+		 * @brief Spreads sky and block light through the world with a breadth first flood fill.
+		 *
+		 * Changes are incremental, when a block changes its old light is flooded out with a removal pass and any
+		 * light bordering the hole is flooded back in with an add pass, so only the affected area is touched.
+		 * Chunks whose light changes are flagged for meshing, as the light is baked into the mesh.
+		 */
+		class LightEngine
+		{
+		public:
+			explicit LightEngine(ChunkManager* world);
+			~LightEngine() = default;
+
+			/**
+			 * @brief Calculates the light for a freshly generated chunk, and spreads it into its loaded neighbours.
+			 * @param chunk The chunk to light, it must already be loaded into the world.
+			 *
+			 * Chunks without a loaded chunk above them are assumed to be open to the sky.
+			 */
+			void lightChunk(Chunk* chunk);
+
+			/**
+			 * @brief Queues a block that has changed, the light isn't updated until propagate() is called.
+			 * @param position The world coordinates of the block.
+			 *
+			 * Queueing a whole batch of changes before propagating means overlapping areas are only flooded once.
+			 */
+			void queueBlockChange(const qz::Vector3i& position);
+
+			/**
+			 * @brief Processes all of the queued light changes.
+			 */
+			void propagate();
+
+			/**
+			 * @brief Forgets a chunk that is about to be unloaded.
+			 * @param chunk The chunk, which is still loaded.
+			 *
+			 * Queued changes in the chunk are skipped once it is gone, like changes in any chunk that isn't loaded.
+			 */
+			void unloadChunk(Chunk* chunk);
+
+		private:
+			struct LightNode
+			{
+				qz::Vector3i position;
+				int level;
+			};
+
+			struct ChannelQueues
+			{
+				std::queue<LightNode> add;
+				std::queue<LightNode> remove;
+			};
+
+			ChunkManager* m_world;
+
+			ChannelQueues m_skyQueues;
+			ChannelQueues m_blockQueues;
+
+			std::unordered_set<Chunk*> m_dirtyChunks;
+
+			Chunk* m_cachedChunk = nullptr;
+			qz::Vector3i m_cachedChunkPos;
+
+			// A snapshot of the cached chunk's blocks, taking a snapshot for every block looked at is too slow.
+			std::shared_ptr<const BlockStorage> m_cachedBlocks;
+
+			ChannelQueues& getQueues(LightChannel channel);
+
+			Chunk* getChunkFor(const qz::Vector3i& position);
+
+			/**
+			 * @brief Gets a block from the chunk last returned by getChunkFor().
+			 * @param local The position of the block within that chunk.
+			 */
+			const BlockInstance& getCachedBlock(const qz::Vector3i& local) const;
+			void markDirty(Chunk* chunk, const qz::Vector3i& local, const qz::Vector3i& position);
+
+			void propagateRemove(LightChannel channel);
+			void propagateAdd(LightChannel channel);
+		};
+	}
+}
@@ -0,0 +1,87 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#pragma once
+
+#include <quartz/voxels/VoxelMath.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace qz
+{
+	namespace voxels
+	{
+		/// @brief The two kinds of light stored for each block.
+		enum class LightChannel
+		{
+			SKY,	///< Light coming down from the sky, it doesn't fade as it travels straight down.
+			BLOCK,	///< Light emitted by blocks, such as torches.
+		};
+
+		/**
+		 * @brief Stores the light levels for every block in a chunk.
+		 *
+		 * Each block gets a single byte, the sky light is kept in the high nibble and the block light in the low
+		 * nibble, so both fit in the same cache line as their neighbours.
+		 */
+		class LightMap
+		{
+		public:
+			static constexpr int MAX_LIGHT = 15;
+
+			LightMap() : m_light(CHUNK_VOLUME, 0) {}
+
+			int getSkyLight(std::size_t index) const				{ return m_light[index] >> 4; }
+			int getBlockLight(std::size_t index) const				{ return m_light[index] & 0x0F; }
+
+			void setSkyLight(std::size_t index, int level)			{ m_light[index] = static_cast<std::uint8_t>((m_light[index] & 0x0F) | (level << 4)); }
+			void setBlockLight(std::size_t index, int level)		{ m_light[index] = static_cast<std::uint8_t>((m_light[index] & 0xF0) | level); }
+
+			int getLight(LightChannel channel, std::size_t index) const
+			{
+				return channel == LightChannel::SKY ? getSkyLight(index) : getBlockLight(index);
+			}
+
+			void setLight(LightChannel channel, std::size_t index, int level)
+			{
+				if (channel == LightChannel::SKY)
+					setSkyLight(index, level);
+				else
+					setBlockLight(index, level);
+			}
+
+			/**
+			 * @brief Gets both light levels for a block, packed into a single byte.
+			 * @param index The index of the block within the chunk.
+			 * @return The sky light in the high nibble, and the block light in the low nibble.
+			 */
+			std::uint8_t getPacked(std::size_t index) const		{ return m_light[index]; }
+
+			void clear()											{ m_light.assign(CHUNK_VOLUME, 0); }
+
+		private:
+			std::vector<std::uint8_t> m_light;
+		};
+	}
+}
@@ -0,0 +1,97 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#pragma once
+
+#include <quartz/core/math/Math.hpp>
+
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace qz
+{
+	namespace voxels
+	{
+		/**
+		 * @brief A vertex of a chunk mesh, laid out exactly as it is uploaded to the GPU.
+		 */
+		struct ChunkVert3D
+		{
+			qz::Vector3 verts;
+			qz::Vector2 uvs;
+
+			float texLayer;
+
+			qz::Vector3 shading; ///< The sky light, block light and ambient occlusion, from 0 to 1.
+
+			ChunkVert3D(const qz::Vector3& vertices, const qz::Vector2& UVs, float textureLayer, const qz::Vector3& vertShading) :
+				verts(vertices), uvs(UVs), texLayer(textureLayer), shading(vertShading)
+			{}
+		};
+
+		/**
+		 * @brief Hands out vertex buffers for chunk meshes, and takes them back once they have been uploaded.
+		 *
+		 * Chunks get remeshed all the time, so rather than allocating a new buffer each time, buffers are kept
+		 * around sorted into size classes by how many vertices they can hold. Each class is double the size of the
+		 * one before it.
+		 */
+		class MeshBufferPool
+		{
+		public:
+			using Buffer = std::vector<ChunkVert3D>;
+
+			static MeshBufferPool* get();
+
+			/**
+			 * @brief Gets an empty buffer with room for at least the requested number of vertices.
+			 * @param minVertices How many vertices the buffer is expected to hold, it can still grow past this.
+			 */
+			Buffer acquire(std::size_t minVertices);
+
+			/**
+			 * @brief Gives a buffer back to the pool so its memory can be reused.
+			 * @param buffer The buffer, it is left empty.
+			 */
+			void release(Buffer&& buffer);
+
+		private:
+			MeshBufferPool() = default;
+			~MeshBufferPool() = default;
+
+			/// @brief The capacity of the smallest size class, in vertices.
+			static constexpr std::size_t MIN_CAPACITY = 1 << 10;
+			static constexpr int NUM_SIZE_CLASSES = 9;
+
+			/// @brief Buffers past this many in a size class are freed rather than kept.
+			static constexpr std::size_t MAX_BUFFERS_PER_CLASS = 32;
+
+			static std::size_t getClassCapacity(int sizeClass);
+
+			std::mutex m_mutex;
+			std::array<std::vector<Buffer>, NUM_SIZE_CLASSES> m_freeBuffers;
+		};
+	}
+}
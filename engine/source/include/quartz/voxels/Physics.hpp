@@ -0,0 +1,184 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#pragma once
+
+#include <quartz/core/utilities/ThreadPool.hpp>
+#include <quartz/core/math/AABB.hpp>
+#include <quartz/voxels/BlockStorage.hpp>
+#include <quartz/voxels/FixedTimestep.hpp>
+
+#include <entt/entity/registry.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace qz
+{
+	namespace voxels
+	{
+		class Chunk;
+		class ChunkManager;
+
+		/**
+		 * @brief Which ways a box was stopped during a move.
+		 */
+		struct MoveResult
+		{
+			bool onGround = false;		///< Stopped while moving down.
+			bool hitCeiling = false;	///< Stopped while moving up.
+			bool blockedX = false;		///< Stopped along x.
+			bool blockedZ = false;		///< Stopped along z.
+			bool stepped = false;		///< Climbed onto a block instead of stopping against it.
+		};
+
+		/**
+		 * @brief Moves boxes through the world without letting them pass into solid blocks.
+		 *
+		 * A move is swept one axis at a time, y then x then z, against every solid block in the space the whole move
+		 * covers, so a box can't tunnel through a block however fast it is going. Blocks in chunks that aren't loaded
+		 * are treated as solid. The collider remembers the chunk it last looked at, so each thread should use its
+		 * own, and only while the world isn't being changed.
+		 */
+		class VoxelCollider
+		{
+		public:
+			explicit VoxelCollider(const ChunkManager* world);
+
+			/**
+			 * @brief Moves a box as far as it can go along a motion.
+			 * @param box The box to move, in block space. It is left where it stopped.
+			 * @param motion How far to move the box.
+			 * @param stepHeight How high a ledge the box can climb onto when it walks into one while on the ground,
+			 * 0 to never climb. Blocks are full cubes, so this has to be at least 1 to climb anything.
+			 * @param result Receives which ways the box was stopped.
+			 * @return How far the box actually moved.
+			 */
+			qz::Vector3 move(math::AABB& box, const qz::Vector3& motion, float stepHeight, MoveResult& result);
+
+			/**
+			 * @brief Checks whether a box overlaps any solid block.
+			 * @param box The box to check, in block space.
+			 */
+			bool intersects(const math::AABB& box);
+
+		private:
+			// Collects the boxes of the solid blocks in a region into m_candidates.
+			void gather(const math::AABB& region);
+			bool isSolid(const qz::Vector3i& position);
+
+			qz::Vector3 sweep(math::AABB& box, const qz::Vector3& motion) const;
+
+			const ChunkManager* m_world;
+
+			bool m_hasCachedChunk = false;
+			qz::Vector3i m_cachedChunkPos;
+			std::shared_ptr<const BlockStorage> m_cachedBlocks;
+
+			std::vector<math::AABB> m_candidates;
+		};
+
+		/**
+		 * @brief Something that moves through the world under gravity and collides with blocks.
+		 */
+		struct PhysicsBody
+		{
+			qz::Vector3 position;			///< The centre of the bottom of the body, in block space.
+			qz::Vector3 previousPosition;	///< Where the body was before the last tick.
+			qz::Vector3 velocity;			///< In blocks per second.
+
+			float width = 0.6f;
+			float height = 1.8f;
+			float stepHeight = 1.f;
+			float gravityScale = 1.f;
+
+			bool onGround = false;
+
+			/**
+			 * @brief Gets the box the body takes up, in block space.
+			 */
+			math::AABB getBounds() const;
+		};
+
+		/**
+		 * @brief Moves the entities with a PhysicsBody through the world on a fixed tick.
+		 *
+		 * Bodies only read the world and each only writes to itself, so a tick walks the registry's packed array of
+		 * bodies in batches of BATCH_SIZE and moves the batches at the same time on the thread pool. A fixed tick
+		 * keeps movement the same at any frame rate, getInterpolation() says how far the frame is between two ticks
+		 * so bodies can be drawn in between previousPosition and position.
+		 */
+		class PhysicsSystem
+		{
+		public:
+			static constexpr int TICKS_PER_SECOND = 60;
+			static constexpr std::size_t BATCH_SIZE = 256;
+
+			static constexpr float GRAVITY = 32.f;				///< In blocks per second squared.
+			static constexpr float TERMINAL_VELOCITY = 78.f;	///< In blocks per second.
+
+			/**
+			 * @brief Creates the physics system for a world.
+			 * @param world The world bodies collide with.
+			 * @param registry The registry holding the PhysicsBody components to move.
+			 * @param threadPool The pool batches of bodies are moved on, tick() waits for it to finish.
+			 */
+			PhysicsSystem(const ChunkManager* world, entt::registry<>& registry, threads::utils::ThreadPool<>& threadPool);
+			~PhysicsSystem() = default;
+
+			/**
+			 * @brief Runs as many ticks as have passed, at TICKS_PER_SECOND.
+			 * @param dt The time since the last update, in seconds.
+			 */
+			void update(float dt);
+
+			/**
+			 * @brief Runs a single tick, no matter how much time has passed.
+			 */
+			void tick();
+
+			/**
+			 * @brief Gets how far the current time is between the last tick and the next one.
+			 * @return From 0, at the last tick, to 1, at the next one.
+			 */
+			float getInterpolation() const;
+
+			/**
+			 * @brief Moves a single body by one tick.
+			 * @param collider The collider to move the body with.
+			 * @param body The body to move.
+			 */
+			static void step(VoxelCollider& collider, PhysicsBody& body);
+
+		private:
+			void simulate(PhysicsBody* bodies, std::size_t count) const;
+
+			const ChunkManager* m_world;
+			entt::registry<>& m_registry;
+
+			FixedTimestep m_timestep;
+
+			threads::utils::ThreadPool<>& m_threadPool;
+		};
+	}
+}
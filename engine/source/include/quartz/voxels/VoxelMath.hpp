@@ -0,0 +1,245 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#pragma once
+
+#include <quartz/core/math/Math.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace qz
+{
+	namespace voxels
+	{
+		/// @brief The base 2 logarithm of the chunk size, chunks must be a power of two in size.
+		constexpr int CHUNK_SIZE_SHIFT	= 4;
+
+		/// @brief The number of blocks along each edge of a chunk.
+		constexpr int CHUNK_SIZE		= 1 << CHUNK_SIZE_SHIFT;
+
+		/// @brief Masks a world block coordinate down to a coordinate within its chunk.
+		constexpr int CHUNK_SIZE_MASK	= CHUNK_SIZE - 1;
+
+		/// @brief The number of blocks within a single chunk.
+		constexpr int CHUNK_VOLUME		= CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE;
+
+		static_assert((CHUNK_SIZE & CHUNK_SIZE_MASK) == 0, "The chunk size must be a power of two.");
+
+		/**
+		 * @brief Finds the block that contains a position in block space.
+		 * @param position The position to convert, where each block is 1 unit in size.
+		 * @return The world coordinates of the block containing the position.
+		 */
+		inline Vector3i worldToBlock(const Vector3& position)
+		{
+			return { static_cast<int>(std::floor(position.x)), static_cast<int>(std::floor(position.y)), static_cast<int>(std::floor(position.z)) };
+		}
+
+		/**
+		 * @brief Finds the chunk that a block is in.
+		 * @param block The world coordinates of the block.
+		 * @return The coordinates of the chunk, counted in chunks rather than blocks.
+		 *
+		 * Right shifting rounds towards negative infinity, so negative coordinates don't need fixing up like they
+		 * would with a division.
+		 */
+		inline Vector3i worldToChunk(const Vector3i& block)
+		{
+			return { block.x >> CHUNK_SIZE_SHIFT, block.y >> CHUNK_SIZE_SHIFT, block.z >> CHUNK_SIZE_SHIFT };
+		}
+
+		/**
+		 * @brief Finds where a block is within the chunk that contains it.
+		 * @param block The world coordinates of the block.
+		 * @return The coordinates of the block within its chunk, each component is in the range [0, CHUNK_SIZE).
+		 */
+		inline Vector3i worldToLocal(const Vector3i& block)
+		{
+			return { block.x & CHUNK_SIZE_MASK, block.y & CHUNK_SIZE_MASK, block.z & CHUNK_SIZE_MASK };
+		}
+
+		/**
+		 * @brief Finds the world coordinates of the first block in a chunk.
+		 * @param chunk The coordinates of the chunk, counted in chunks.
+		 * @return The world coordinates of the chunks origin.
+		 */
+		inline Vector3i chunkToWorld(const Vector3i& chunk)
+		{
+			return chunk * CHUNK_SIZE;
+		}
+
+		/**
+		 * @brief Checks whether a local coordinate actually lies within a chunk.
+		 * @param local The coordinate to check.
+		 * @return Whether all components are in the range [0, CHUNK_SIZE).
+		 */
+		inline bool isLocalInBounds(const Vector3i& local)
+		{
+			return ((local.x | local.y | local.z) & ~CHUNK_SIZE_MASK) == 0;
+		}
+
+		/**
+		 * @brief Stores blocks in plain x, then y, then z order.
+		 *
+		 * Walking along x touches neighbouring memory, but a step along y or z jumps CHUNK_SIZE or CHUNK_SIZE^2
+		 * elements.
+		 */
+		struct LinearLayout
+		{
+			static std::size_t toIndex(const Vector3i& local)
+			{
+				return static_cast<std::size_t>(local.x | (local.y << CHUNK_SIZE_SHIFT) | (local.z << (CHUNK_SIZE_SHIFT * 2)));
+			}
+
+			static Vector3i toLocal(std::size_t index)
+			{
+				const int i = static_cast<int>(index);
+				return { i & CHUNK_SIZE_MASK, (i >> CHUNK_SIZE_SHIFT) & CHUNK_SIZE_MASK, i >> (CHUNK_SIZE_SHIFT * 2) };
+			}
+		};
+
+		/**
+		 * @brief Stores blocks in Z-order, the bits of x, y and z are interleaved into the index.
+		 *
+		 * Blocks that are close together in any direction end up close together in memory, each 2x2x2 group is
+		 * contiguous, then each 4x4x4 group and so on.
+		 */
+		struct MortonLayout
+		{
+			static std::size_t toIndex(const Vector3i& local)
+			{
+				return spread(local.x) | (spread(local.y) << 1) | (spread(local.z) << 2);
+			}
+
+			static Vector3i toLocal(std::size_t index)
+			{
+				return { compact(index), compact(index >> 1), compact(index >> 2) };
+			}
+
+		private:
+			static_assert(CHUNK_SIZE_SHIFT == 4, "The morton layout only spreads 4 bits per axis.");
+
+			// Moves bits 0-3 to bits 0, 3, 6 and 9.
+			static std::size_t spread(int coord)
+			{
+				std::size_t bits = static_cast<std::size_t>(coord);
+				bits = (bits | (bits << 4)) & 0x0C3;
+				bits = (bits | (bits << 2)) & 0x249;
+				return bits;
+			}
+
+			static int compact(std::size_t bits)
+			{
+				bits &= 0x249;
+				bits = (bits | (bits >> 2)) & 0x0C3;
+				bits = (bits | (bits >> 4)) & 0x00F;
+				return static_cast<int>(bits);
+			}
+		};
+
+		/**
+		 * @brief Stores blocks in 4x4x4 bricks, each brick is contiguous and the bricks are in linear order.
+		 *
+		 * A brick of 64 blocks is small enough to sit in cache while all of its neighbours are looked at.
+		 */
+		struct BrickLayout
+		{
+			static constexpr int BRICK_SHIFT = 2;
+			static constexpr int BRICK_MASK = (1 << BRICK_SHIFT) - 1;
+			static constexpr int BRICKS_SHIFT = CHUNK_SIZE_SHIFT - BRICK_SHIFT;
+
+			static std::size_t toIndex(const Vector3i& local)
+			{
+				const int brick = (local.x >> BRICK_SHIFT) | ((local.y >> BRICK_SHIFT) << BRICKS_SHIFT) | ((local.z >> BRICK_SHIFT) << (BRICKS_SHIFT * 2));
+				const int inner = (local.x & BRICK_MASK) | ((local.y & BRICK_MASK) << BRICK_SHIFT) | ((local.z & BRICK_MASK) << (BRICK_SHIFT * 2));
+
+				return static_cast<std::size_t>((brick << (BRICK_SHIFT * 3)) | inner);
+			}
+
+			static Vector3i toLocal(std::size_t index)
+			{
+				const int i = static_cast<int>(index);
+
+				const int inner = i & ((1 << (BRICK_SHIFT * 3)) - 1);
+				const int brick = i >> (BRICK_SHIFT * 3);
+
+				constexpr int bricksMask = (1 << BRICKS_SHIFT) - 1;
+
+				return {
+					((brick & bricksMask) << BRICK_SHIFT) | (inner & BRICK_MASK),
+					(((brick >> BRICKS_SHIFT) & bricksMask) << BRICK_SHIFT) | ((inner >> BRICK_SHIFT) & BRICK_MASK),
+					((brick >> (BRICKS_SHIFT * 2)) << BRICK_SHIFT) | (inner >> (BRICK_SHIFT * 2))
+				};
+			}
+		};
+
+		/**
+		 * @brief The layout used by every chunk, chosen at compile time.
+		 *
+		 * Define QZ_VOXEL_LAYOUT_MORTON or QZ_VOXEL_LAYOUT_BRICK to change it, linear is the default.
+		 */
+#if defined(QZ_VOXEL_LAYOUT_MORTON)
+		using ChunkLayout = MortonLayout;
+#elif defined(QZ_VOXEL_LAYOUT_BRICK)
+		using ChunkLayout = BrickLayout;
+#else
+		using ChunkLayout = LinearLayout;
+#endif
+
+		/**
+		 * @brief Converts a coordinate within a chunk into an index into the chunks block array.
+		 * @param local The coordinate within the chunk, it must be in bounds.
+		 * @return The index of the block, in the order of the ChunkLayout.
+		 */
+		inline std::size_t localToIndex(const Vector3i& local)
+		{
+			return ChunkLayout::toIndex(local);
+		}
+
+		/**
+		 * @brief Converts an index into a chunks block array back into a coordinate within the chunk.
+		 * @param index The index of the block.
+		 * @return The coordinate of the block within the chunk.
+		 */
+		inline Vector3i indexToLocal(std::size_t index)
+		{
+			return ChunkLayout::toLocal(index);
+		}
+
+		/**
+		 * @brief Packs chunk coordinates into a single integer, for use as a key in a hash map.
+		 * @param chunk The coordinates of the chunk, counted in chunks.
+		 * @return The packed key, each component gets 21 bits.
+		 */
+		inline std::uint64_t chunkKey(const Vector3i& chunk)
+		{
+			constexpr std::uint64_t mask = (1ull << 21) - 1;
+
+			return (static_cast<std::uint64_t>(chunk.x) & mask)
+				| ((static_cast<std::uint64_t>(chunk.y) & mask) << 21)
+				| ((static_cast<std::uint64_t>(chunk.z) & mask) << 42);
+		}
+	}
+}
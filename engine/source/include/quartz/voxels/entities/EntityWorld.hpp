@@ -0,0 +1,91 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#pragma once
+
+#include <quartz/voxels/Physics.hpp>
+#include <quartz/voxels/entities/Components.hpp>
+
+#include <entt/entity/registry.hpp>
+
+#include <vector>
+
+namespace qz
+{
+	namespace entities
+	{
+		using Registry = entt::registry<>;
+		using Entity = Registry::entity_type;
+
+		/**
+		 * @brief Holds every entity in the world, and the components that make them up.
+		 *
+		 * Each type of component is kept in its own densely packed pool, so a system that looks at one or two
+		 * components walks straight through memory instead of chasing an object per entity. Anything that moves
+		 * has a voxels::PhysicsBody, which the world's PhysicsSystem moves every tick.
+		 */
+		class EntityWorld
+		{
+		public:
+			static constexpr float ITEM_DESPAWN_TIME = 300.f;	///< How long items lie in the world, in seconds.
+
+			EntityWorld() = default;
+			~EntityWorld() = default;
+
+			Registry& getRegistry();
+			const Registry& getRegistry() const;
+
+			/**
+			 * @brief Creates an entity that moves through the world.
+			 * @param body The body of the entity, which becomes its PhysicsBody component.
+			 * @return The new entity, other components can be assigned to it through the registry.
+			 */
+			Entity createEntity(const voxels::PhysicsBody& body);
+
+			/**
+			 * @brief Drops an item into the world.
+			 * @param stack The items to drop.
+			 * @param position Where to drop them, in block space.
+			 * @param velocity How fast they are thrown, in blocks per second.
+			 * @return The entity for the dropped item.
+			 */
+			Entity dropItem(const ItemStack& stack, const qz::Vector3& position, const qz::Vector3& velocity);
+
+			void destroy(Entity entity);
+
+			std::size_t getEntityCount() const;
+
+			/**
+			 * @brief Ages the items lying in the world, removing the ones that have been there too long.
+			 * @param dt The time since the last update, in seconds.
+			 */
+			void update(float dt);
+
+		private:
+			Registry m_registry;
+
+			// Reused by update(), entities can't be destroyed while a view over them is being walked.
+			std::vector<Entity> m_expired;
+		};
+	}
+}
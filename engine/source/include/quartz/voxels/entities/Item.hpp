@@ -25,13 +25,47 @@
 
 #include <quartz/core/Core.hpp>
 
+#include <entt/core/hashed_string.hpp>
+
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace qz
 {
 	namespace entities
 	{
+		/**
+		 * @brief The interned form of an item ID, so components can refer to items without holding strings.
+		 */
+		using ItemID = entt::hashed_string::hash_type;
+
+		/**
+		 * @brief Interns an item ID.
+		 * @param id The item ID, in the format mod:id.
+		 * @return The hash of the ID, which is the same every time for the same string.
+		 */
+		inline ItemID hashItemID(const std::string& id)
+		{
+			return entt::hashed_string::to_value(id.c_str());
+		}
+
+		class ItemInstance;
+
+		/**
+		 * @brief The number an item is given when it is registered, for looking it up without hashing anything.
+		 *
+		 * Handles count up from 1 in the order items are registered, so they are only valid for as long as the
+		 * program runs and shouldn't be saved. 0 is never given out, it means no item.
+		 */
+		using ItemHandle = std::uint16_t;
+
+		constexpr ItemHandle NO_ITEM = 0;
+
+		using ItemCallback = std::function<void(ItemInstance& item)>;
+
 		class Item
 		{
 		public:
@@ -47,34 +81,50 @@ namespace qz
 			 * @brief getID - getID of Item
 			 * @return Return a string for the ID of the item
 			 */
-			std::string getID();
+			const std::string& getID() const;
+
+			/**
+			 * @brief Gets the interned form of the ID of the item.
+			 */
+			ItemID getHashedID() const;
+
+			/**
+			 * @brief Gets the handle the item was given when it was registered, or NO_ITEM if it wasn't.
+			 */
+			ItemHandle getHandle() const;
 
 			/**
 			 * @brief getName - Get user friendly name of item
 			 * @return Return a string of the name of the item
 			 */
-			std::string getName();
+			const std::string& getName() const;
 
 			/// @brief Setter: Sets the function executed when an items breaks (damage used up)
-			void setOnBreakCallback(void* callback);
+			void setOnBreakCallback(const ItemCallback& callback);
 			/// @brief Getter: Gets the function executed when an item breaks (damage used up)
-			void* getOnBreakCallback();
+			const ItemCallback& getOnBreakCallback() const;
 
 			/// @brief Setter: Sets the function executed when you use the item
-			void setOnUseCallback(void* callback);
+			void setOnUseCallback(const ItemCallback& callback);
 			/// @brief Getter: Gets the function executed when you use the item
-			void* getOnUseCallback();
+			const ItemCallback& getOnUseCallback() const;
 
 		private:
+			friend class ItemLibrary;
+
 			/// @brief Unique id using the convention mod:name
 			std::string m_id;
+			/// @brief The interned form of m_id
+			ItemID m_hashedID;
+			/// @brief The handle given out by the ItemLibrary
+			ItemHandle m_handle = NO_ITEM;
 			/// @brief Name that will display to the user
 			std::string m_name;
 
-			/// @brief Lambda callback for when the item is broken (well, hopefully lambdas if we can)
-			void* m_onBreakCallback;
-			/// @brief Lambda callback for when the item is used (well, hopefully lambdas if we can)
-			void* m_onUseCallback;
+			/// @brief Callback for when the item is broken
+			ItemCallback m_onBreakCallback;
+			/// @brief Callback for when the item is used
+			ItemCallback m_onUseCallback;
 		};
 
 		class ItemLibrary
@@ -83,15 +133,43 @@ namespace qz
 			/**
 			 * @brief getItemByID - Get an item object based off its unique ID
 			 * @param The unique ID of the item you are trying to find
-			 * @return Returns an item matching the supplied ID
+			 * @return Returns the item matching the supplied ID, or nullptr if there isn't one
 			 */
-			static Item getItemByID(std::string id);
+			static Item* getItemByID(const std::string& id);
+
+			/**
+			 * @brief getItemByHashedID - Get an item object based off its interned ID
+			 * @param The interned ID of the item you are trying to find
+			 * @return Returns the item matching the supplied ID, or nullptr if there isn't one or if more than one
+			 * registered ID hashes to it, in which case getItemByID() or a handle has to be used instead
+			 */
+			static Item* getItemByHashedID(ItemID id);
+
+			/**
+			 * @brief getItem - Get an item object based off its handle
+			 * @param The handle of the item you are trying to find
+			 * @return Returns the item with the handle, or nullptr if there isn't one
+			 */
+			static Item* getItem(ItemHandle handle);
+
+			/**
+			 * @brief getHandle - Get the handle of an item, to look it up quickly from then on
+			 * @param The unique ID of the item
+			 * @return Returns the handle of the item, or NO_ITEM if there isn't one
+			 */
+			static ItemHandle getHandle(const std::string& id);
 
 			static void registerItem(Item* item);
 
 		private:
-			// A registry to keep track of all the registered items
-			static std::vector<Item*> m_itemLibrary;
+			// Every registered item, indexed by handle. The first slot stays empty for NO_ITEM.
+			static std::vector<Item*> m_items;
+
+			// The handles of the registered items, by their IDs
+			static std::unordered_map<std::string, ItemHandle> m_handles;
+
+			// The handles of the registered items, by their interned IDs. IDs that hash the same map to NO_ITEM.
+			static std::unordered_map<ItemID, ItemHandle> m_hashedHandles;
 		};
 	}
 }
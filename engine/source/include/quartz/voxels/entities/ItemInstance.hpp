@@ -31,22 +31,31 @@ namespace qz
 	namespace entities
 	{
 
+		/**
+		 * @brief A single item, the handle of its type and how damaged it is.
+		 */
 		class ItemInstance
 		{
 		public:
-			ItemInstance(std::string id);
-			ItemInstance(std::string id, int baseDamage);
-			~ItemInstance();
+			ItemInstance(ItemHandle item, int baseDamage = 0);
+
+			/**
+			 * @brief Creates an item from its ID, which is looked up once here.
+			 */
+			ItemInstance(const std::string& id, int baseDamage = 0);
+			~ItemInstance() = default;
 
 			// Getters for universal data shared between all items of this type
 			// something getTextures();
-			std::string getID() const;
+			ItemHandle getHandle() const;
+			Item* getItem() const;
+			const std::string& getID() const;
 
 			int getDamage() const;
 			void setDamage(int damage);
 
 		private:
-			std::string m_id;
+			ItemHandle m_item;
 			int m_damage;
 		};
 
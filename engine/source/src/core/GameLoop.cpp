@@ -0,0 +1,113 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#include <quartz/core/QuartzPCH.hpp>
+#include <quartz/core/GameLoop.hpp>
+
+#include <thread>
+
+using namespace qz;
+
+// If the simulation falls this many ticks behind, the missed time is skipped instead of being caught up in a burst.
+const int MAX_TICKS_BEHIND = 5;
+
+GameLoop::GameLoop(gfx::IWindow* window, int ticksPerSecond) :
+	m_window(window), m_ticksPerSecond(ticksPerSecond),
+	m_tickLength(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / ticksPerSecond))),
+	m_start(0), m_running(false), m_tickCount(0)
+{}
+
+void GameLoop::registerTickListener(events::EventQueue::TypedListener<events::AppTickEvent> listener)
+{
+	m_tickEvents.addListener<events::AppTickEvent>(std::move(listener));
+}
+
+void GameLoop::run(const std::function<void()>& render)
+{
+	m_start = std::chrono::steady_clock::now().time_since_epoch().count();
+	m_running = true;
+
+	std::thread simulation(&GameLoop::simulate, this);
+
+	while (m_running && m_window->isRunning())
+	{
+		m_window->startFrame();
+		render();
+		m_window->endFrame();
+	}
+
+	m_running = false;
+	simulation.join();
+}
+
+void GameLoop::stop()
+{
+	m_running = false;
+}
+
+int GameLoop::getTicksPerSecond() const
+{
+	return m_ticksPerSecond;
+}
+
+std::uint64_t GameLoop::getTickCount() const
+{
+	return m_tickCount;
+}
+
+float GameLoop::getInterpolation(std::uint64_t tick) const
+{
+	const std::chrono::steady_clock::time_point start(std::chrono::steady_clock::duration(m_start.load()));
+	const auto tickTime = start + m_tickLength * static_cast<std::int64_t>(tick);
+	const float alpha = std::chrono::duration<float>(std::chrono::steady_clock::now() - tickTime) / m_tickLength;
+
+	return std::min(std::max(alpha, 0.f), 1.f);
+}
+
+void GameLoop::simulate()
+{
+	const float dt = 1.f / m_ticksPerSecond;
+
+	std::uint64_t tick = 0;
+	auto next = std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(m_start.load())) + m_tickLength;
+
+	while (m_running)
+	{
+		std::this_thread::sleep_until(next);
+
+		m_tickEvents.push<events::AppTickEvent>(++tick, dt);
+		m_tickEvents.dispatch();
+
+		m_tickCount = tick;
+
+		next += m_tickLength;
+
+		const auto now = std::chrono::steady_clock::now();
+		if (now - next > m_tickLength * MAX_TICKS_BEHIND)
+		{
+			// Move the start along too, so the ticks after the skip are still interpolated from the right time.
+			m_start += (now - next).count();
+			next = now;
+		}
+	}
+}
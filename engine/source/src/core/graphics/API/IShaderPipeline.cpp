@@ -28,6 +28,18 @@
 
 using namespace qz::gfx::api;
 
+std::string IShaderPipeline::s_binaryCacheDirectory = "cache/shaders";
+
+void IShaderPipeline::setBinaryCacheDirectory(const std::string& directory)
+{
+	s_binaryCacheDirectory = directory;
+}
+
+const std::string& IShaderPipeline::getBinaryCacheDirectory()
+{
+	return s_binaryCacheDirectory;
+}
+
 GraphicsResource<IShaderPipeline> IShaderPipeline::generateShaderPipeline()
 {
 	switch (Context::getRenderingAPI())
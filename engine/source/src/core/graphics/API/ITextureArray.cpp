@@ -28,6 +28,18 @@
 
 using namespace qz::gfx::api;
 
+std::string ITextureArray::s_bakeCacheDirectory = "cache/textures";
+
+void ITextureArray::setBakeCacheDirectory(const std::string& directory)
+{
+	s_bakeCacheDirectory = directory;
+}
+
+const std::string& ITextureArray::getBakeCacheDirectory()
+{
+	return s_bakeCacheDirectory;
+}
+
 GraphicsResource<ITextureArray> ITextureArray::generateTextureArray()
 {
 	switch (Context::getRenderingAPI())
@@ -23,6 +23,12 @@
 
 #include <quartz/core/QuartzPCH.hpp>
 #include <quartz/core/graphics/API/gl/GLShaderPipeline.hpp>
+#include <quartz/core/utilities/FileIO.hpp>
+#include <quartz/core/utilities/Hash.hpp>
+
+#include <filesystem>
+#include <cstdint>
+#include <cstring>
 
 using namespace qz::gfx::api::gl;
 using namespace qz::gfx::api;
@@ -44,7 +50,7 @@ GLShaderPipeline::GLShaderPipeline(GLShaderPipeline&& o) noexcept
 	m_id = o.m_id;
 	o.m_id = 0;
 
-	m_shaders = std::move(o.m_shaders);
+	m_stages = std::move(o.m_stages);
 }
 
 GLShaderPipeline& GLShaderPipeline::operator=(GLShaderPipeline&& o) noexcept
@@ -52,47 +58,196 @@ GLShaderPipeline& GLShaderPipeline::operator=(GLShaderPipeline&& o) noexcept
 	m_id = o.m_id;
 	o.m_id = 0;
 
-	m_shaders = std::move(o.m_shaders);
+	m_stages = std::move(o.m_stages);
 
 	return *this;
 }
 
+/// @brief Identifies a file as a Quartz program binary, and is bumped if the layout of the file ever changes.
+static const std::uint32_t PROGRAM_BINARY_MAGIC = 0x51504231; // "QPB1"
+
+/// @brief The header written in front of every cached program binary.
+struct ProgramBinaryHeader
+{
+	std::uint32_t magic;
+	std::uint32_t format;
+	std::uint32_t length;
+};
+
 void GLShaderPipeline::addStage(ShaderType stage, const std::string& shaderSource)
 {
-	unsigned int shader = GLCheck(glCreateShader(gfxToOpenGL(stage)));
+	// Compilation is deferred to build(), as it may not be needed at all if there is a cached binary.
+	m_stages.emplace_back(stage, shaderSource);
+}
 
-	const char* source = shaderSource.c_str();
-	GLCheck(glShaderSource(shader, 1, &source, nullptr));
-	GLCheck(glCompileShader(shader));
+void GLShaderPipeline::build()
+{
+	const std::string cachePath = getBinaryCachePath();
 
-	int success;
-	char infoLog[1024];
-	GLCheck(glGetShaderiv(shader, GL_COMPILE_STATUS, &success));
-	if (!success)
+	if (cachePath.empty() || !loadBinary(cachePath))
 	{
-		GLCheck(glGetShaderInfoLog(shader, 1024, nullptr, infoLog));
-		LWARNING("[SHADER COMPILATION]", infoLog);
+		if (compileAndLink() && !cachePath.empty())
+			saveBinary(cachePath);
 	}
 
-	m_shaders.push_back(shader);
+	m_stages.clear();
 }
 
-void GLShaderPipeline::build()
+std::string GLShaderPipeline::getBinaryCachePath() const
 {
-	for (unsigned int shader : m_shaders)
+	const std::string& directory = getBinaryCacheDirectory();
+
+	if (directory.empty() || !GLAD_GL_ARB_get_program_binary)
+		return "";
+
+	int formatCount = 0;
+	GLCheck(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount));
+
+	if (formatCount <= 0)
+		return "";
+
+	// Program binaries are only valid for the exact driver that produced them, so the driver details form part of the key.
+	std::uint64_t key = utils::FNV_OFFSET_BASIS;
+	for (const GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION })
 	{
+		const char* str = reinterpret_cast<const char*>(glGetString(name));
+		if (str != nullptr)
+			key = utils::hashString(str, key);
+	}
+
+	for (const auto& stage : m_stages)
+	{
+		const int type = static_cast<int>(stage.first);
+		key = utils::hashBytes(&type, sizeof(type), key);
+		key = utils::hashString(stage.second, key);
+	}
+
+	return directory + "/" + utils::hashToString(key) + ".bin";
+}
+
+bool GLShaderPipeline::loadBinary(const std::string& cachePath)
+{
+	if (!std::ifstream(cachePath))
+		return false;
+
+	bool loaded = false;
+
+	{
+		// Mapped rather than read, so the length in the header is checked against the size of the file before it's trusted.
+		const utils::MappedFile file(cachePath);
+
+		ProgramBinaryHeader header;
+		if (file.size() >= sizeof(header))
+		{
+			std::memcpy(&header, file.data(), sizeof(header));
+
+			if (header.magic == PROGRAM_BINARY_MAGIC && header.length == file.size() - sizeof(header))
+			{
+				GLCheck(glProgramBinary(m_id, header.format, file.data() + sizeof(header), static_cast<GLsizei>(header.length)));
+
+				int success;
+				GLCheck(glGetProgramiv(m_id, GL_LINK_STATUS, &success));
+
+				// A driver update can reject a binary even though the version string matched, in which case just compile as normal.
+				loaded = success;
+				if (!loaded)
+				{
+					LDEBUG("[SHADER CACHE] Cached program ", cachePath, " was rejected by the driver, recompiling.");
+				}
+			}
+		}
+	}
+
+	// Otherwise a corrupt or stale binary would be read again on every start. The file has to be unmapped first, as
+	// Windows won't delete a mapped file.
+	if (!loaded)
+	{
+		std::error_code error;
+		std::filesystem::remove(cachePath, error);
+	}
+
+	return loaded;
+}
+
+void GLShaderPipeline::saveBinary(const std::string& cachePath) const
+{
+	int length = 0;
+	GLCheck(glGetProgramiv(m_id, GL_PROGRAM_BINARY_LENGTH, &length));
+
+	if (length <= 0)
+		return;
+
+	ProgramBinaryHeader header;
+	header.magic = PROGRAM_BINARY_MAGIC;
+	header.length = static_cast<std::uint32_t>(length);
+
+	std::vector<char> binary(header.length);
+	GLenum format = 0;
+	GLCheck(glGetProgramBinary(m_id, length, nullptr, &format, binary.data()));
+	header.format = format;
+
+	std::error_code error;
+	std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), error);
+
+	std::ofstream file(cachePath, std::ios::binary | std::ios::trunc);
+	if (!file)
+	{
+		LWARNING("[SHADER CACHE] Could not write the program binary to ", cachePath);
+		return;
+	}
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(binary.data(), binary.size());
+}
+
+bool GLShaderPipeline::compileAndLink()
+{
+	std::vector<unsigned int> shaders;
+
+	for (const auto& stage : m_stages)
+	{
+		unsigned int shader = GLCheck(glCreateShader(gfxToOpenGL(stage.first)));
+
+		const char* source = stage.second.c_str();
+		GLCheck(glShaderSource(shader, 1, &source, nullptr));
+		GLCheck(glCompileShader(shader));
+
+		int success;
+		char infoLog[1024];
+		GLCheck(glGetShaderiv(shader, GL_COMPILE_STATUS, &success));
+		if (!success)
+		{
+			GLCheck(glGetShaderInfoLog(shader, 1024, nullptr, infoLog));
+			LWARNING("[SHADER COMPILATION]", infoLog);
+		}
+
 		GLCheck(glAttachShader(m_id, shader));
+		shaders.push_back(shader);
+	}
+
+	if (GLAD_GL_ARB_get_program_binary)
+	{
+		GLCheck(glProgramParameteri(m_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
 	}
 
 	GLCheck(glLinkProgram(m_id));
 
-	for (unsigned int shader : m_shaders)
+	for (unsigned int shader : shaders)
 	{
 		GLCheck(glDetachShader(m_id, shader));
 		GLCheck(glDeleteShader(shader));
 	}
 
-	m_shaders.clear();
+	int success;
+	GLCheck(glGetProgramiv(m_id, GL_LINK_STATUS, &success));
+	if (!success)
+	{
+		char infoLog[1024];
+		GLCheck(glGetProgramInfoLog(m_id, 1024, nullptr, infoLog));
+		LWARNING("[SHADER LINKING]", infoLog);
+	}
+
+	return success != 0;
 }
 
 void GLShaderPipeline::use() const
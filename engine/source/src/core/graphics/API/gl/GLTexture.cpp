@@ -23,6 +23,7 @@
 
 #include <quartz/core/QuartzPCH.hpp>
 #include <quartz/core/graphics/API/gl/GLTexture.hpp>
+#include <quartz/core/utilities/VirtualFileSystem.hpp>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
@@ -102,8 +103,11 @@ void GLTexture::unbind() const
 
 void GLTexture::setDataFromFile(const std::string& filepath)
 {
+	std::string buffer;
+	const std::string_view file = utils::VirtualFileSystem::get()->view(filepath, buffer);
+
 	int width = -1, height = -1, nbChannels = -1;
-	unsigned char* image = stbi_load(filepath.c_str(), &width, &height, &nbChannels, 0);
+	unsigned char* image = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(file.data()), static_cast<int>(file.size()), &width, &height, &nbChannels, 0);
 	if (image != nullptr)
 	{
 		GLCheck(glTexSubImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, m_format, GL_UNSIGNED_BYTE, image));
@@ -24,17 +24,173 @@
 #include <quartz/core/QuartzPCH.hpp>
 #include <quartz/core/graphics/API/gl/GLTextureArray.hpp>
 #include <quartz/core/graphics/API/gl/GLCommon.hpp>
+#include <quartz/core/utilities/FileIO.hpp>
+#include <quartz/core/utilities/Hash.hpp>
+#include <quartz/core/utilities/VirtualFileSystem.hpp>
 
 #include <stb_image.h>
 
+#include <cstring>
+#include <filesystem>
+
 using namespace qz::gfx::api::gl;
 using namespace qz::gfx::api;
 
+namespace
+{
+	/// @brief The width and height of every layer, the size the block textures are drawn at.
+	constexpr int TEXTURE_SIZE = 16;
+
+	/// @brief How many layers the array has room for.
+	constexpr int LAYER_CAPACITY = 256;
+
+	/// @brief Every mip level down to 1x1.
+	constexpr int LEVEL_COUNT = 5;
+
+	/// @brief Identifies a file as a baked texture array, and is bumped if the layout of the file ever changes.
+	constexpr std::uint32_t BAKED_ARRAY_MAGIC = 0x51544131; // "QTA1"
+
+	/// @brief The header written in front of every baked texture array.
+	struct BakedArrayHeader
+	{
+		std::uint32_t magic;
+		std::uint32_t size;
+		std::uint32_t levelCount;
+		std::uint32_t layerCount;
+		std::uint64_t key;
+	};
+
+	/// @brief Shown in place of textures that couldn't be decoded, so they stand out.
+	constexpr unsigned char MISSING_TEXTURE_COLOUR[4] = { 255, 0, 255, 255 };
+
+	std::size_t getLevelSize(int level, std::size_t layerCount)
+	{
+		const std::size_t size = TEXTURE_SIZE >> level;
+		return size * size * 4 * layerCount;
+	}
+
+	// Decodes an image through the virtual file system, so packed textures are decoded straight from the archive.
+	unsigned char* loadImage(const std::string& filepath, int& width, int& height, int& nbChannels)
+	{
+		std::string buffer;
+		const std::string_view file = qz::utils::VirtualFileSystem::get()->view(filepath, buffer);
+
+		return stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(file.data()), static_cast<int>(file.size()), &width, &height, &nbChannels, 0);
+	}
+
+	// Averages each 2x2 block of the level above, for every layer.
+	void generateMipLevel(const unsigned char* above, unsigned char* level, int size, std::size_t layerCount)
+	{
+		const int aboveSize = size * 2;
+
+		for (std::size_t layer = 0; layer < layerCount; ++layer)
+		{
+			const unsigned char* source = above + layer * aboveSize * aboveSize * 4;
+			unsigned char* destination = level + layer * size * size * 4;
+
+			for (int y = 0; y < size; ++y)
+			{
+				for (int x = 0; x < size; ++x)
+				{
+					for (int channel = 0; channel < 4; ++channel)
+					{
+						const int topLeft = ((y * 2) * aboveSize + x * 2) * 4 + channel;
+						const int bottomLeft = topLeft + aboveSize * 4;
+
+						const int sum = source[topLeft] + source[topLeft + 4] + source[bottomLeft] + source[bottomLeft + 4];
+						destination[(y * size + x) * 4 + channel] = static_cast<unsigned char>((sum + 2) / 4);
+					}
+				}
+			}
+		}
+	}
+
+	/**
+	 * Decodes the textures into the first level and builds the rest, giving the whole array as it is stored in the
+	 * cache. Returns false if any texture couldn't be used, which should keep the result out of the cache.
+	 */
+	bool bakeTextures(const std::vector<std::pair<std::string, int>>& textures, const std::vector<std::string_view>& sources, std::vector<unsigned char>& pixels)
+	{
+		std::size_t totalSize = 0;
+		for (int level = 0; level < LEVEL_COUNT; ++level)
+			totalSize += getLevelSize(level, textures.size());
+
+		pixels.resize(totalSize);
+
+		bool complete = true;
+		for (std::size_t i = 0; i < textures.size(); ++i)
+		{
+			unsigned char* layer = pixels.data() + getLevelSize(0, i);
+
+			int width = -1, height = -1, nbChannels = -1;
+			unsigned char* image = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(sources[i].data()), static_cast<int>(sources[i].size()), &width, &height, &nbChannels, 4);
+
+			if (image != nullptr && width == TEXTURE_SIZE && height == TEXTURE_SIZE)
+			{
+				std::memcpy(layer, image, getLevelSize(0, 1));
+			}
+			else
+			{
+				qz::utils::Logger::instance()->log(qz::utils::LogVerbosity::WARNING, __FILE__, __LINE__, "[RENDERING][TEXTURING]", "The texture: ", textures[i].first, " could not be found, or isn't ", TEXTURE_SIZE, "x", TEXTURE_SIZE, ".");
+
+				for (std::size_t pixel = 0; pixel < getLevelSize(0, 1); pixel += 4)
+					std::memcpy(layer + pixel, MISSING_TEXTURE_COLOUR, 4);
+
+				complete = false;
+			}
+
+			stbi_image_free(image);
+		}
+
+		unsigned char* above = pixels.data();
+		for (int level = 1; level < LEVEL_COUNT; ++level)
+		{
+			unsigned char* current = above + getLevelSize(level - 1, textures.size());
+			generateMipLevel(above, current, TEXTURE_SIZE >> level, textures.size());
+			above = current;
+		}
+
+		return complete;
+	}
+
+	void saveBaked(const std::string& cachePath, std::uint64_t key, std::size_t layerCount, const std::vector<unsigned char>& pixels)
+	{
+		BakedArrayHeader header;
+		header.magic = BAKED_ARRAY_MAGIC;
+		header.size = TEXTURE_SIZE;
+		header.levelCount = LEVEL_COUNT;
+		header.layerCount = static_cast<std::uint32_t>(layerCount);
+		header.key = key;
+
+		std::error_code error;
+		std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), error);
+
+		std::ofstream file(cachePath, std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			LWARNING("[TEXTURE CACHE] Could not write the baked texture array to ", cachePath);
+			return;
+		}
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(pixels.data()), pixels.size());
+	}
+}
+
 GLTextureArray::GLTextureArray()
 {
 	GLCheck(glGenTextures(1, &m_id));
 	bind();
-	GLCheck(glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, 16, 16, 256, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+
+	// Every level is allocated up front, so baked mipmaps can be uploaded without the driver generating them.
+	for (int level = 0; level < LEVEL_COUNT; ++level)
+	{
+		const int size = TEXTURE_SIZE >> level;
+		GLCheck(glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGBA, size, size, LAYER_CAPACITY, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+	}
+
+	GLCheck(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, LEVEL_COUNT - 1));
+
 	unbind();
 }
 
@@ -82,7 +238,7 @@ void GLTextureArray::add(const std::string& filepath)
 	if (m_texNames.find(filepath) == m_texNames.end())
 	{
 		int width = -1, height = -1, nbChannels = -1;
-		unsigned char* image = stbi_load(filepath.c_str(), &width, &height, &nbChannels, 0);
+		unsigned char* image = loadImage(filepath, width, height, nbChannels);
 		if (image != nullptr)
 		{
 			GLCheck(glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, m_layerNumber, width, height, 1, m_format, GL_UNSIGNED_BYTE, image));
@@ -118,41 +274,112 @@ void GLTextureArray::reserve(const std::string& filepath)
 
 void GLTextureArray::resolveReservations()
 {
-	bind();
-
+	// Ordered by layer, so the baked array can be uploaded a whole level at a time.
+	std::vector<std::pair<std::string, int>> textures;
 	for (const auto& current : m_texReservations)
 	{
 		if (m_texNames.find(current.first) == m_texNames.end())
+			textures.emplace_back(current.first, current.second);
+	}
+
+	m_texReservations.clear();
+
+	if (textures.empty())
+		return;
+
+	std::sort(textures.begin(), textures.end(), [](const auto& a, const auto& b) { return a.second < b.second; });
+
+	std::vector<int> layers;
+
+	// The sources are only hashed here, which is far cheaper than decoding them. Packed ones aren't even copied.
+	std::vector<std::string> buffers(textures.size());
+	std::vector<std::string_view> sources(textures.size());
+
+	std::uint64_t key = utils::hashBytes(&BAKED_ARRAY_MAGIC, sizeof(BAKED_ARRAY_MAGIC));
+	for (std::size_t i = 0; i < textures.size(); ++i)
+	{
+		sources[i] = utils::VirtualFileSystem::get()->view(textures[i].first, buffers[i]);
+		layers.push_back(textures[i].second);
+
+		key = utils::hashString(textures[i].first, key);
+		key = utils::hashBytes(&textures[i].second, sizeof(textures[i].second), key);
+		key = utils::hashBytes(sources[i].data(), sources[i].size(), key);
+	}
+
+	const std::string& directory = getBakeCacheDirectory();
+	const std::string cachePath = directory.empty() ? "" : directory + "/" + utils::hashToString(key) + ".bin";
+
+	bind();
+
+	bool loaded = false;
+	if (!cachePath.empty() && std::ifstream(cachePath))
+	{
+		const utils::MappedFile file(cachePath);
+
+		BakedArrayHeader header;
+		std::size_t expectedSize = sizeof(header);
+		for (int level = 0; level < LEVEL_COUNT; ++level)
+			expectedSize += getLevelSize(level, textures.size());
+
+		if (file.size() == expectedSize)
 		{
-			int width = -1, height = -1, nbChannels = -1;
-			unsigned char* image = stbi_load(current.first.c_str(), &width, &height, &nbChannels, 0);
-			if (image != nullptr)
-			{
-				GLCheck(glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, current.second, width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, image));
+			std::memcpy(&header, file.data(), sizeof(header));
 
-				m_texNames[current.first] = current.second;
-			}
-			else
-			{
-				utils::Logger::instance()->log(utils::LogVerbosity::WARNING, __FILE__, __LINE__, "[RENDERING][TEXTURING]", "The texture: ", current.first, " could not be found.");
-				return;
-			}
-			stbi_image_free(image);
+			loaded = header.magic == BAKED_ARRAY_MAGIC && header.size == TEXTURE_SIZE && header.levelCount == LEVEL_COUNT &&
+				header.layerCount == textures.size() && header.key == key;
 
-			GLCheck(glGenerateMipmap(GL_TEXTURE_2D_ARRAY));
-			GLCheck(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
-			GLCheck(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
-			GLCheck(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT));
-			GLCheck(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT));
-			GLCheck(glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, 16.0f));
+			if (loaded)
+				uploadBaked(reinterpret_cast<const unsigned char*>(file.data() + sizeof(header)), layers);
 		}
 	}
 
-	m_texReservations.clear();
+	if (!loaded)
+	{
+		std::vector<unsigned char> pixels;
+		const bool complete = bakeTextures(textures, sources, pixels);
+
+		uploadBaked(pixels.data(), layers);
+
+		// Missing textures would otherwise be baked in until the cache is cleared.
+		if (complete && !cachePath.empty())
+			saveBaked(cachePath, key, textures.size(), pixels);
+	}
+
+	for (const auto& texture : textures)
+		m_texNames[texture.first] = texture.second;
+
+	GLCheck(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
+	GLCheck(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+	GLCheck(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT));
+	GLCheck(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT));
+	GLCheck(glTexParameterf(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_ANISOTROPY_EXT, 16.0f));
 
 	unbind();
 }
 
+void GLTextureArray::uploadBaked(const unsigned char* pixels, const std::vector<int>& layers) const
+{
+	for (int level = 0; level < LEVEL_COUNT; ++level)
+	{
+		const int size = TEXTURE_SIZE >> level;
+		const std::size_t layerSize = getLevelSize(level, 1);
+
+		// Reservations hand out consecutive layers, so this is normally one upload per level.
+		std::size_t first = 0;
+		while (first < layers.size())
+		{
+			std::size_t last = first + 1;
+			while (last < layers.size() && layers[last] == layers[last - 1] + 1)
+				++last;
+
+			GLCheck(glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, layers[first], size, size, static_cast<GLsizei>(last - first), GL_RGBA, GL_UNSIGNED_BYTE, pixels + first * layerSize));
+			first = last;
+		}
+
+		pixels += layerSize * layers.size();
+	}
+}
+
 void GLTextureArray::bind(int slot) const
 {
 	m_slot = slot;
@@ -41,6 +41,16 @@ FPSCamera::FPSCamera(IWindow* window) : m_window(window)
 	m_projection = Matrix4x4::perspective(windowSize.x / windowSize.y, 45.f, 1000.f, 0.1f);
 
 	m_windowCentre = { std::floor(windowSize.x / 2.f), std::floor(windowSize.y / 2.f) };
+
+	utils::ConfigFile* controls = QZ_REGISTER_CONFIG("Controls");
+
+	m_moveForward = controls->bind("CameraKeyboard", "moveForward", events::Key::KEY_W);
+	m_moveBackwards = controls->bind("CameraKeyboard", "moveBackwards", events::Key::KEY_S);
+	m_strafeLeft = controls->bind("CameraKeyboard", "strafeLeft", events::Key::KEY_A);
+	m_strafeRight = controls->bind("CameraKeyboard", "strafeRight", events::Key::KEY_D);
+
+	m_sensitivity = controls->bind("CameraMisc", "mouseSensitivity", SENSITIVITY);
+	m_moveSpeed = controls->bind("CameraMisc", "moveSpeed", MOVE_SPEED);
 }
 
 qz::Vector3 FPSCamera::getPosition() const
@@ -48,6 +58,11 @@ qz::Vector3 FPSCamera::getPosition() const
 	return m_position;
 }
 
+void FPSCamera::setPosition(const Vector3& position)
+{
+	m_position = position;
+}
+
 qz::Vector3 FPSCamera::getDirection() const
 {
 	return m_direction;
@@ -98,7 +113,7 @@ void FPSCamera::tick(float dt)
 
 	m_window->setCursorPosition(m_windowCentre);
 
-	const float sensitivity = SENSITIVITY;
+	const float sensitivity = m_sensitivity;
 
 	m_rotation.x += sensitivity * dt * (m_windowCentre.x - mousePos.x);
 	m_rotation.y += sensitivity * dt * (m_windowCentre.y - mousePos.y);
@@ -117,22 +132,22 @@ void FPSCamera::tick(float dt)
 
 	m_up = Vector3::cross(right, m_direction);
 
-	const float moveSpeed = MOVE_SPEED;
+	const float moveSpeed = m_moveSpeed;
 
-	if (m_window->isKeyDown(events::Key::KEY_W))
+	if (m_window->isKeyDown(m_moveForward))
 	{
 		m_position += m_direction * dt * moveSpeed;
 	}
-	else if (m_window->isKeyDown(events::Key::KEY_S))
+	else if (m_window->isKeyDown(m_moveBackwards))
 	{
 		m_position -= m_direction * dt * moveSpeed;
 	}
 
-	if (m_window->isKeyDown(events::Key::KEY_A))
+	if (m_window->isKeyDown(m_strafeLeft))
 {
 		m_position -= right * dt * moveSpeed;
 	}
-	else if (m_window->isKeyDown(events::Key::KEY_D))
+	else if (m_window->isKeyDown(m_strafeRight))
 	{
 		m_position += right * dt * moveSpeed;
 	}
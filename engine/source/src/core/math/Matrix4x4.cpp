@@ -24,11 +24,129 @@
 #include <quartz/core/QuartzPCH.hpp>
 #include <quartz/core/math/Matrix4x4.hpp>
 #include <quartz/core/math/MathUtils.hpp>
+#include <quartz/core/math/SIMD.hpp>
 
 #define INDEX_2D(x, y) x + (y * 4)
 
 using namespace qz::math;
 
+#if defined(QZ_SIMD_SSE)
+#	define QZ_SHUFFLE(a, b, x, y, z, w) _mm_shuffle_ps(a, b, _MM_SHUFFLE(w, z, y, x))
+#	define QZ_SWIZZLE(a, x, y, z, w) QZ_SHUFFLE(a, a, x, y, z, w)
+
+// The following helpers operate on a 2x2 matrix packed into a single register as (m00, m01, m10, m11).
+
+/// @brief 2x2 Matrix multiplication, A * B.
+static inline __m128 mat2Mul(__m128 a, __m128 b)
+{
+	return _mm_add_ps(_mm_mul_ps(a, QZ_SWIZZLE(b, 0, 3, 0, 3)), _mm_mul_ps(QZ_SWIZZLE(a, 1, 0, 3, 2), QZ_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+/// @brief 2x2 Matrix adjugate multiplication, adj(A) * B.
+static inline __m128 mat2AdjMul(__m128 a, __m128 b)
+{
+	return _mm_sub_ps(_mm_mul_ps(QZ_SWIZZLE(a, 3, 3, 0, 0), b), _mm_mul_ps(QZ_SWIZZLE(a, 1, 1, 2, 2), QZ_SWIZZLE(b, 2, 3, 0, 1)));
+}
+
+/// @brief 2x2 Matrix multiplication with an adjugate, A * adj(B).
+static inline __m128 mat2MulAdj(__m128 a, __m128 b)
+{
+	return _mm_sub_ps(_mm_mul_ps(a, QZ_SWIZZLE(b, 3, 0, 3, 0)), _mm_mul_ps(QZ_SWIZZLE(a, 1, 0, 3, 2), QZ_SWIZZLE(b, 2, 1, 2, 1)));
+}
+#endif
+
+/**
+ * @brief Multiplies two column major matrices together, out = lhs * rhs.
+ *
+ * out must NOT alias either of the inputs, each column of the result is a linear combination of the columns of lhs,
+ * which maps directly onto 4 wide SIMD registers.
+ */
+static void multiplyMatrices(const float* lhs, const float* rhs, float* out)
+{
+#if defined(QZ_SIMD_SSE)
+	const __m128 col0 = _mm_loadu_ps(lhs + 0);
+	const __m128 col1 = _mm_loadu_ps(lhs + 4);
+	const __m128 col2 = _mm_loadu_ps(lhs + 8);
+	const __m128 col3 = _mm_loadu_ps(lhs + 12);
+
+	for (int i = 0; i < 4; ++i)
+	{
+		const float* column = rhs + i * 4;
+
+		__m128 result = _mm_mul_ps(col0, _mm_set1_ps(column[0]));
+		result = _mm_add_ps(result, _mm_mul_ps(col1, _mm_set1_ps(column[1])));
+		result = _mm_add_ps(result, _mm_mul_ps(col2, _mm_set1_ps(column[2])));
+		result = _mm_add_ps(result, _mm_mul_ps(col3, _mm_set1_ps(column[3])));
+
+		_mm_storeu_ps(out + i * 4, result);
+	}
+#elif defined(QZ_SIMD_NEON)
+	const float32x4_t col0 = vld1q_f32(lhs + 0);
+	const float32x4_t col1 = vld1q_f32(lhs + 4);
+	const float32x4_t col2 = vld1q_f32(lhs + 8);
+	const float32x4_t col3 = vld1q_f32(lhs + 12);
+
+	for (int i = 0; i < 4; ++i)
+	{
+		const float32x4_t column = vld1q_f32(rhs + i * 4);
+
+		float32x4_t result = vmulq_lane_f32(col0, vget_low_f32(column), 0);
+		result = vmlaq_lane_f32(result, col1, vget_low_f32(column), 1);
+		result = vmlaq_lane_f32(result, col2, vget_high_f32(column), 0);
+		result = vmlaq_lane_f32(result, col3, vget_high_f32(column), 1);
+
+		vst1q_f32(out + i * 4, result);
+	}
+#else
+	for (int x = 0; x < 4; ++x)
+	{
+		for (int y = 0; y < 4; ++y)
+		{
+			float xy = 0.f;
+
+			for (int k = 0; k < 4; ++k)
+			{
+				xy += lhs[INDEX_2D(x, k)] * rhs[INDEX_2D(k, y)];
+			}
+
+			out[INDEX_2D(x, y)] = xy;
+		}
+	}
+#endif
+}
+
+/**
+ * @brief Transforms a single 4 component vector by a column major matrix.
+ * @param w The W component of the vector, 1 for points, 0 for directions.
+ */
+static qz::math::Vector3 transformVector(const float* m, const qz::math::Vector3& vec, float w)
+{
+#if defined(QZ_SIMD_SSE)
+	__m128 result = _mm_mul_ps(_mm_loadu_ps(m + 0), _mm_set1_ps(vec.x));
+	result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(m + 4), _mm_set1_ps(vec.y)));
+	result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(m + 8), _mm_set1_ps(vec.z)));
+	result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(m + 12), _mm_set1_ps(w)));
+
+	float out[4];
+	_mm_storeu_ps(out, result);
+
+	return { out[0], out[1], out[2] };
+#elif defined(QZ_SIMD_NEON)
+	float32x4_t result = vmulq_n_f32(vld1q_f32(m + 0), vec.x);
+	result = vmlaq_n_f32(result, vld1q_f32(m + 4), vec.y);
+	result = vmlaq_n_f32(result, vld1q_f32(m + 8), vec.z);
+	result = vmlaq_n_f32(result, vld1q_f32(m + 12), w);
+
+	return { vgetq_lane_f32(result, 0), vgetq_lane_f32(result, 1), vgetq_lane_f32(result, 2) };
+#else
+	return {
+		m[INDEX_2D(0, 0)] * vec.x + m[INDEX_2D(0, 1)] * vec.y + m[INDEX_2D(0, 2)] * vec.z + m[INDEX_2D(0, 3)] * w,
+		m[INDEX_2D(1, 0)] * vec.x + m[INDEX_2D(1, 1)] * vec.y + m[INDEX_2D(1, 2)] * vec.z + m[INDEX_2D(1, 3)] * w,
+		m[INDEX_2D(2, 0)] * vec.x + m[INDEX_2D(2, 1)] * vec.y + m[INDEX_2D(2, 2)] * vec.z + m[INDEX_2D(2, 3)] * w
+	};
+#endif
+}
+
 Matrix4x4::Matrix4x4()
 {
 	for (float& element : elements) element = 0.f;
@@ -123,42 +241,139 @@ Matrix4x4 Matrix4x4::lookAt(const Vector3& eyePos, const Vector3& centre, const
 	return lookAtMatrix;
 }
 
-void Matrix4x4::operator*=(const Matrix4x4& other)
+Matrix4x4 Matrix4x4::inverse() const
 {
-	for (int x = 0; x < 4; ++x)
-	{
-		for (int y = 0; y < 4; ++y)
-		{
-			float xy = 0.f;
+	Matrix4x4 out;
 
-			for (int k = 0; k < 4; ++k)
-			{
-				xy += elements[INDEX_2D(x, k)] * other.elements[INDEX_2D(k, y)];
-			}
+#if defined(QZ_SIMD_SSE)
+	// Block matrix inversion, splitting the matrix into four 2x2 matrices. The transpose of an inverse is the inverse
+	// of a transpose, so the same maths works regardless of whether the storage is treated as rows or columns.
+	const __m128 vec0 = _mm_loadu_ps(elements + 0);
+	const __m128 vec1 = _mm_loadu_ps(elements + 4);
+	const __m128 vec2 = _mm_loadu_ps(elements + 8);
+	const __m128 vec3 = _mm_loadu_ps(elements + 12);
+
+	const __m128 a = _mm_movelh_ps(vec0, vec1);
+	const __m128 b = _mm_movehl_ps(vec1, vec0);
+	const __m128 c = _mm_movelh_ps(vec2, vec3);
+	const __m128 d = _mm_movehl_ps(vec3, vec2);
+
+	// The determinants of the sub matrices, as (|A|, |B|, |C|, |D|).
+	const __m128 detSub = _mm_sub_ps(
+		_mm_mul_ps(QZ_SHUFFLE(vec0, vec2, 0, 2, 0, 2), QZ_SHUFFLE(vec1, vec3, 1, 3, 1, 3)),
+		_mm_mul_ps(QZ_SHUFFLE(vec0, vec2, 1, 3, 1, 3), QZ_SHUFFLE(vec1, vec3, 0, 2, 0, 2))
+	);
 
-			elements[INDEX_2D(x, y)] = xy;
-		}
-	}
+	const __m128 detA = QZ_SWIZZLE(detSub, 0, 0, 0, 0);
+	const __m128 detB = QZ_SWIZZLE(detSub, 1, 1, 1, 1);
+	const __m128 detC = QZ_SWIZZLE(detSub, 2, 2, 2, 2);
+	const __m128 detD = QZ_SWIZZLE(detSub, 3, 3, 3, 3);
+
+	const __m128 dc = mat2AdjMul(d, c);
+	const __m128 ab = mat2AdjMul(a, b);
+
+	__m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), mat2Mul(b, dc));
+	__m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), mat2Mul(c, ab));
+	__m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), mat2MulAdj(d, ab));
+	__m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), mat2MulAdj(a, dc));
+
+	// |M| = |A||D| + |B||C| - tr(adj(A)B * adj(D)C)
+	__m128 trace = _mm_mul_ps(ab, QZ_SWIZZLE(dc, 0, 2, 1, 3));
+	trace = _mm_add_ps(trace, QZ_SWIZZLE(trace, 2, 3, 0, 1));
+	trace = _mm_add_ps(trace, QZ_SWIZZLE(trace, 1, 0, 3, 2));
+
+	const __m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace);
+	const __m128 reciprocalDet = _mm_div_ps(_mm_setr_ps(1.f, -1.f, -1.f, 1.f), det);
+
+	x = _mm_mul_ps(x, reciprocalDet);
+	y = _mm_mul_ps(y, reciprocalDet);
+	z = _mm_mul_ps(z, reciprocalDet);
+	w = _mm_mul_ps(w, reciprocalDet);
+
+	_mm_storeu_ps(out.elements + 0, QZ_SHUFFLE(x, y, 3, 1, 3, 1));
+	_mm_storeu_ps(out.elements + 4, QZ_SHUFFLE(x, y, 2, 0, 2, 0));
+	_mm_storeu_ps(out.elements + 8, QZ_SHUFFLE(z, w, 3, 1, 3, 1));
+	_mm_storeu_ps(out.elements + 12, QZ_SHUFFLE(z, w, 2, 0, 2, 0));
+#else
+	// Cofactor expansion, reusing the 2x2 determinants of the bottom two and top two rows.
+	const float* m = elements;
+	float* inv = out.elements;
+
+	const float s0 = m[0] * m[5] - m[4] * m[1];
+	const float s1 = m[0] * m[6] - m[4] * m[2];
+	const float s2 = m[0] * m[7] - m[4] * m[3];
+	const float s3 = m[1] * m[6] - m[5] * m[2];
+	const float s4 = m[1] * m[7] - m[5] * m[3];
+	const float s5 = m[2] * m[7] - m[6] * m[3];
+
+	const float c5 = m[10] * m[15] - m[14] * m[11];
+	const float c4 = m[9] * m[15] - m[13] * m[11];
+	const float c3 = m[9] * m[14] - m[13] * m[10];
+	const float c2 = m[8] * m[15] - m[12] * m[11];
+	const float c1 = m[8] * m[14] - m[12] * m[10];
+	const float c0 = m[8] * m[13] - m[12] * m[9];
+
+	const float reciprocalDet = 1.f / (s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0);
+
+	inv[0] = (m[5] * c5 - m[6] * c4 + m[7] * c3) * reciprocalDet;
+	inv[1] = (-m[1] * c5 + m[2] * c4 - m[3] * c3) * reciprocalDet;
+	inv[2] = (m[13] * s5 - m[14] * s4 + m[15] * s3) * reciprocalDet;
+	inv[3] = (-m[9] * s5 + m[10] * s4 - m[11] * s3) * reciprocalDet;
+
+	inv[4] = (-m[4] * c5 + m[6] * c2 - m[7] * c1) * reciprocalDet;
+	inv[5] = (m[0] * c5 - m[2] * c2 + m[3] * c1) * reciprocalDet;
+	inv[6] = (-m[12] * s5 + m[14] * s2 - m[15] * s1) * reciprocalDet;
+	inv[7] = (m[8] * s5 - m[10] * s2 + m[11] * s1) * reciprocalDet;
+
+	inv[8] = (m[4] * c4 - m[5] * c2 + m[7] * c0) * reciprocalDet;
+	inv[9] = (-m[0] * c4 + m[1] * c2 - m[3] * c0) * reciprocalDet;
+	inv[10] = (m[12] * s4 - m[13] * s2 + m[15] * s0) * reciprocalDet;
+	inv[11] = (-m[8] * s4 + m[9] * s2 - m[11] * s0) * reciprocalDet;
+
+	inv[12] = (-m[4] * c3 + m[5] * c1 - m[6] * c0) * reciprocalDet;
+	inv[13] = (m[0] * c3 - m[1] * c1 + m[2] * c0) * reciprocalDet;
+	inv[14] = (-m[12] * s3 + m[13] * s1 - m[14] * s0) * reciprocalDet;
+	inv[15] = (m[8] * s3 - m[9] * s1 + m[10] * s0) * reciprocalDet;
+#endif
+
+	return out;
 }
 
-Matrix4x4 Matrix4x4::operator*(const Matrix4x4& other)
+Vector3 Matrix4x4::transformPoint(const Vector3& point) const
 {
-	Matrix4x4 mat4;
+	return transformVector(elements, point, 1.f);
+}
 
-	for (int x = 0; x < 4; ++x)
+Vector3 Matrix4x4::transformDirection(const Vector3& direction) const
+{
+	return transformVector(elements, direction, 0.f);
+}
+
+void Matrix4x4::transformPoints(const Vector3* points, Vector3* out, std::size_t count) const
+{
+	for (std::size_t i = 0; i < count; ++i)
 	{
-		for (int y = 0; y < 4; ++y)
-		{
-			float xy = 0.f;
+		out[i] = transformVector(elements, points[i], 1.f);
+	}
+}
 
-			for (int k = 0; k < 4; ++k)
-			{
-				xy += elements[INDEX_2D(x, k)] * other.elements[INDEX_2D(k, y)];
-			}
+void Matrix4x4::operator*=(const Matrix4x4& other)
+{
+	// The product has to be calculated into a temporary, otherwise elements that have already been
+	// overwritten would be read back in for the remaining columns.
+	float result[16];
+	multiplyMatrices(elements, other.elements, result);
 
-			mat4.elements[INDEX_2D(x, y)] = xy;
-		}
+	for (int i = 0; i < 16; ++i)
+	{
+		elements[i] = result[i];
 	}
+}
+
+Matrix4x4 Matrix4x4::operator*(const Matrix4x4& other) const
+{
+	Matrix4x4 mat4;
+	multiplyMatrices(elements, other.elements, mat4.elements);
 
 	return mat4;
 }
@@ -171,7 +386,7 @@ void Matrix4x4::operator*=(const float& other)
 	}
 }
 
-Matrix4x4 Matrix4x4::operator*(const float& other)
+Matrix4x4 Matrix4x4::operator*(const float& other) const
 {
 	Matrix4x4 matrix;
 	for (int i = 0; i < 16; i++)
@@ -181,7 +396,7 @@ Matrix4x4 Matrix4x4::operator*(const float& other)
 	return matrix;
 }
 
-Vector3 Matrix4x4::operator*(const Vector3& other)
+Vector3 Matrix4x4::operator*(const Vector3& other) const
 {
 	const float x = elements[0 + 0 * 4] * other.x + elements[1 + 0 * 4] * other.y + elements[2 + 0 * 4] * other.z;
 	const float y = elements[0 + 1 * 4] * other.x + elements[1 + 1 * 4] * other.y + elements[2 + 1 * 4] * other.z;
@@ -58,3 +58,13 @@ Vector3 Ray::getCurrentPosition() const
 	return m_currentPosition;
 }
 
+const Vector3& Ray::getStart() const
+{
+	return m_start;
+}
+
+const Vector3& Ray::getDirection() const
+{
+	return m_direction;
+}
+
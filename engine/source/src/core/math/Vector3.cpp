@@ -23,9 +23,71 @@
 
 #include <quartz/core/QuartzPCH.hpp>
 #include <quartz/core/math/Vector3.hpp>
+#include <quartz/core/math/SIMD.hpp>
 
 using namespace qz::math;
 
+// The batch operations treat arrays of vectors as tightly packed floats.
+static_assert(sizeof(Vector3) == sizeof(float) * 3, "Vector3 must be tightly packed for the batch operations.");
+
+/// @brief The operations that can be applied to every component in an array of vectors.
+enum class ComponentOp
+{
+	ADD,
+	SUBTRACT,
+	MULTIPLY
+};
+
+/**
+ * @brief Applies a component wise operation over two arrays of floats.
+ *
+ * Since the operation doesn't care which component it's working on, the vectors don't need to be de-interleaved,
+ * the arrays are just processed 4 floats at a time with a scalar loop for any remainder.
+ */
+template <ComponentOp Op>
+static void applyComponentWise(const float* lhs, const float* rhs, float* out, std::size_t count)
+{
+	std::size_t i = 0;
+
+#if defined(QZ_SIMD_SSE)
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128 a = _mm_loadu_ps(lhs + i);
+		const __m128 b = _mm_loadu_ps(rhs + i);
+
+		switch (Op)
+		{
+		case ComponentOp::ADD:		_mm_storeu_ps(out + i, _mm_add_ps(a, b)); break;
+		case ComponentOp::SUBTRACT:	_mm_storeu_ps(out + i, _mm_sub_ps(a, b)); break;
+		case ComponentOp::MULTIPLY:	_mm_storeu_ps(out + i, _mm_mul_ps(a, b)); break;
+		}
+	}
+#elif defined(QZ_SIMD_NEON)
+	for (; i + 4 <= count; i += 4)
+	{
+		const float32x4_t a = vld1q_f32(lhs + i);
+		const float32x4_t b = vld1q_f32(rhs + i);
+
+		switch (Op)
+		{
+		case ComponentOp::ADD:		vst1q_f32(out + i, vaddq_f32(a, b)); break;
+		case ComponentOp::SUBTRACT:	vst1q_f32(out + i, vsubq_f32(a, b)); break;
+		case ComponentOp::MULTIPLY:	vst1q_f32(out + i, vmulq_f32(a, b)); break;
+		}
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		switch (Op)
+		{
+		case ComponentOp::ADD:		out[i] = lhs[i] + rhs[i]; break;
+		case ComponentOp::SUBTRACT:	out[i] = lhs[i] - rhs[i]; break;
+		case ComponentOp::MULTIPLY:	out[i] = lhs[i] * rhs[i]; break;
+		}
+	}
+}
+
 void Vector3::floor()
 {
 	x = std::floor(x);
@@ -75,3 +137,82 @@ float Vector3::dotProduct(const Vector3& vec1, const Vector3& vec2)
 		vec1.y * vec2.y +
 		vec1.z * vec2.z;
 }
+
+void Vector3::add(const Vector3* vec1, const Vector3* vec2, Vector3* out, std::size_t count)
+{
+	applyComponentWise<ComponentOp::ADD>(&vec1->x, &vec2->x, &out->x, count * 3);
+}
+
+void Vector3::subtract(const Vector3* vec1, const Vector3* vec2, Vector3* out, std::size_t count)
+{
+	applyComponentWise<ComponentOp::SUBTRACT>(&vec1->x, &vec2->x, &out->x, count * 3);
+}
+
+void Vector3::scale(const Vector3* vecs, float scalar, Vector3* out, std::size_t count)
+{
+	std::size_t i = 0;
+	const float* in = &vecs->x;
+	float* result = &out->x;
+	count *= 3;
+
+#if defined(QZ_SIMD_SSE)
+	const __m128 factor = _mm_set1_ps(scalar);
+	for (; i + 4 <= count; i += 4)
+	{
+		_mm_storeu_ps(result + i, _mm_mul_ps(_mm_loadu_ps(in + i), factor));
+	}
+#elif defined(QZ_SIMD_NEON)
+	for (; i + 4 <= count; i += 4)
+	{
+		vst1q_f32(result + i, vmulq_n_f32(vld1q_f32(in + i), scalar));
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		result[i] = in[i] * scalar;
+	}
+}
+
+void Vector3::dotProducts(const Vector3* vec1, const Vector3* vec2, float* out, std::size_t count)
+{
+	std::size_t i = 0;
+
+#if defined(QZ_SIMD_SSE)
+	// 4 vectors fit into 3 registers as (x0 y0 z0 x1) (y1 z1 x2 y2) (z2 x3 y3 z3), the products are multiplied in that
+	// layout and then shuffled into (x0 x1 x2 x3) (y0 y1 y2 y3) (z0 z1 z2 z3) so 4 dot products can be summed at once.
+	for (; i + 4 <= count; i += 4)
+	{
+		const float* a = &vec1[i].x;
+		const float* b = &vec2[i].x;
+
+		const __m128 p0 = _mm_mul_ps(_mm_loadu_ps(a + 0), _mm_loadu_ps(b + 0));
+		const __m128 p1 = _mm_mul_ps(_mm_loadu_ps(a + 4), _mm_loadu_ps(b + 4));
+		const __m128 p2 = _mm_mul_ps(_mm_loadu_ps(a + 8), _mm_loadu_ps(b + 8));
+
+		const __m128 x = _mm_shuffle_ps(p0, _mm_shuffle_ps(p1, p2, _MM_SHUFFLE(0, 1, 0, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+		const __m128 y = _mm_shuffle_ps(_mm_shuffle_ps(p0, p1, _MM_SHUFFLE(0, 0, 0, 1)), _mm_shuffle_ps(p1, p2, _MM_SHUFFLE(0, 2, 0, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+		const __m128 z = _mm_shuffle_ps(_mm_shuffle_ps(p0, p1, _MM_SHUFFLE(0, 1, 0, 2)), p2, _MM_SHUFFLE(3, 0, 2, 0));
+
+		_mm_storeu_ps(out + i, _mm_add_ps(_mm_add_ps(x, y), z));
+	}
+#elif defined(QZ_SIMD_NEON)
+	// NEON can de-interleave the components while loading, so no shuffling is required.
+	for (; i + 4 <= count; i += 4)
+	{
+		const float32x4x3_t a = vld3q_f32(&vec1[i].x);
+		const float32x4x3_t b = vld3q_f32(&vec2[i].x);
+
+		float32x4_t dot = vmulq_f32(a.val[0], b.val[0]);
+		dot = vmlaq_f32(dot, a.val[1], b.val[1]);
+		dot = vmlaq_f32(dot, a.val[2], b.val[2]);
+
+		vst1q_f32(out + i, dot);
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		out[i] = dotProduct(vec1[i], vec2[i]);
+	}
+}
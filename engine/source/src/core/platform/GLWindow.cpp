@@ -48,14 +48,6 @@ void GLWindow::endFrame()
 	pollEvents();
 }
 
-void GLWindow::dispatchToListeners(events::Event&& event)
-{
-	for (std::function<void(events::Event&)>& eventListener : m_eventListeners)
-	{
-		eventListener(event);
-	}
-}
-
 GLWindow::GLWindow(const std::string& title, int width, int height) : m_vsync(false), m_fullscreen(false)
 {
 	SDL_Init(SDL_INIT_EVERYTHING);
@@ -136,35 +128,37 @@ void GLWindow::pollEvents()
 		switch (event.type)
 		{
 		case SDL_QUIT:
-			dispatchToListeners(events::WindowCloseEvent());
+			m_eventQueue.push<events::WindowCloseEvent>();
 			m_running = false;
 			break;
 		case SDL_MOUSEBUTTONDOWN:	
-			dispatchToListeners(events::MouseButtonReleasedEvent(static_cast<events::MouseButton>(event.button.button), { static_cast<float>(event.button.x), static_cast<float>(event.button.y) }));
+			m_eventQueue.push<events::MouseButtonPressedEvent>(static_cast<events::MouseButton>(event.button.button), Vector2(static_cast<float>(event.button.x), static_cast<float>(event.button.y)));
 			break;
 		case SDL_MOUSEBUTTONUP:		
-			dispatchToListeners(events::MouseButtonReleasedEvent(static_cast<events::MouseButton>(event.button.button), { static_cast<float>(event.button.x), static_cast<float>(event.button.y) }));
+			m_eventQueue.push<events::MouseButtonReleasedEvent>(static_cast<events::MouseButton>(event.button.button), Vector2(static_cast<float>(event.button.x), static_cast<float>(event.button.y)));
 			break;
 		case SDL_MOUSEMOTION:		
-			dispatchToListeners(events::MouseMovedEvent({ static_cast<float>(event.motion.x), static_cast<float>(event.motion.y) }));
+			m_eventQueue.push<events::MouseMovedEvent>(Vector2(static_cast<float>(event.motion.x), static_cast<float>(event.motion.y)));
 			break;
 		case SDL_KEYDOWN:			
-			dispatchToListeners(events::KeyPressedEvent(static_cast<events::Key>(event.key.keysym.scancode), event.key.repeat));
+			m_eventQueue.push<events::KeyPressedEvent>(static_cast<events::Key>(event.key.keysym.scancode), event.key.repeat);
 			break;
 		case SDL_KEYUP:				
-			dispatchToListeners(events::KeyReleasedEvent(static_cast<events::Key>(event.key.keysym.scancode)));
+			m_eventQueue.push<events::KeyReleasedEvent>(static_cast<events::Key>(event.key.keysym.scancode));
 			break;
 		case SDL_WINDOWEVENT:
 			switch (event.window.event)
 			{
-			case SDL_WINDOWEVENT_RESIZED:		dispatchToListeners(events::WindowResizeEvent(event.window.data1, event.window.data2)); break;
-			case SDL_WINDOWEVENT_SIZE_CHANGED:	dispatchToListeners(events::WindowResizeEvent(event.window.data1, event.window.data2)); break;
-			case SDL_WINDOWEVENT_FOCUS_GAINED:	dispatchToListeners(events::WindowFocusEvent()); break;
-			case SDL_WINDOWEVENT_FOCUS_LOST:	dispatchToListeners(events::WindowLostFocusEvent()); break;
+			case SDL_WINDOWEVENT_RESIZED:		m_eventQueue.push<events::WindowResizeEvent>(event.window.data1, event.window.data2); break;
+			case SDL_WINDOWEVENT_SIZE_CHANGED:	m_eventQueue.push<events::WindowResizeEvent>(event.window.data1, event.window.data2); break;
+			case SDL_WINDOWEVENT_FOCUS_GAINED:	m_eventQueue.push<events::WindowFocusEvent>(); break;
+			case SDL_WINDOWEVENT_FOCUS_LOST:	m_eventQueue.push<events::WindowLostFocusEvent>(); break;
 			default: break;
 			}
 		}
 	}
+
+	m_eventQueue.dispatch();
 }
 
 void GLWindow::swapBuffers() const
@@ -174,7 +168,7 @@ void GLWindow::swapBuffers() const
 
 void GLWindow::registerEventListener(std::function<void(events::Event&)> listener)
 {
-	m_eventListeners.emplace_back(listener);
+	m_eventQueue.addListener(listener);
 }
 
 void GLWindow::show() const
@@ -0,0 +1,173 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#include <quartz/core/QuartzPCH.hpp>
+#include <quartz/core/scripting/LuaState.hpp>
+#include <quartz/core/utilities/Logger.hpp>
+#include <quartz/core/utilities/VirtualFileSystem.hpp>
+
+#include <lua.hpp>
+
+#include <type_traits>
+
+using namespace qz::scripting;
+using namespace qz;
+
+static_assert(std::is_same<LuaFunction, lua_CFunction>::value, "LuaFunction must match lua_CFunction.");
+static_assert(std::is_same<double, lua_Number>::value, "Lua must be built with double precision numbers.");
+
+LuaRef::LuaRef(const std::shared_ptr<lua_State>& state, int index)
+	: m_state(state)
+{
+	lua_pushvalue(state.get(), index);
+	m_ref = luaL_ref(state.get(), LUA_REGISTRYINDEX);
+}
+
+LuaRef::~LuaRef()
+{
+	release();
+}
+
+LuaRef::LuaRef(LuaRef&& other) noexcept
+{
+	*this = std::move(other);
+}
+
+LuaRef& LuaRef::operator=(LuaRef&& other) noexcept
+{
+	if (this != &other)
+	{
+		release();
+
+		m_state = std::move(other.m_state);
+		m_ref = other.m_ref;
+
+		other.m_state.reset();
+		other.m_ref = NO_REF;
+	}
+
+	return *this;
+}
+
+bool LuaRef::isValid() const
+{
+	static_assert(NO_REF == LUA_NOREF, "LuaRef::NO_REF must match LUA_NOREF.");
+	return m_ref != NO_REF && !m_state.expired();
+}
+
+lua_State* LuaRef::push() const
+{
+	const std::shared_ptr<lua_State> state = m_state.lock();
+	if (state == nullptr || m_ref == NO_REF)
+		return nullptr;
+
+	lua_rawgeti(state.get(), LUA_REGISTRYINDEX, m_ref);
+	return state.get();
+}
+
+void LuaRef::release()
+{
+	// There is nothing to release once the state has been closed.
+	const std::shared_ptr<lua_State> state = m_state.lock();
+	if (state != nullptr && m_ref != NO_REF)
+		luaL_unref(state.get(), LUA_REGISTRYINDEX, m_ref);
+
+	m_state.reset();
+	m_ref = NO_REF;
+}
+
+LuaState::LuaState()
+	: m_state(luaL_newstate(), lua_close)
+{
+	luaL_openlibs(m_state.get());
+}
+
+bool LuaState::runFile(const std::string& filepath)
+{
+	if (!utils::VirtualFileSystem::get()->exists(filepath))
+	{
+		LWARNING("[SCRIPTING] The script ", filepath, " could not be found.");
+		return false;
+	}
+
+	std::string buffer;
+	const std::string_view source = utils::VirtualFileSystem::get()->view(filepath, buffer);
+
+	// The @ tells Lua the chunk is a file, so errors read "path:line:" rather than quoting the source.
+	const std::string chunkName = "@" + filepath;
+
+	if (luaL_loadbuffer(m_state.get(), source.data(), source.size(), chunkName.c_str()) != 0)
+	{
+		LWARNING("[SCRIPTING] ", lua_tostring(m_state.get(), -1));
+		lua_pop(m_state.get(), 1);
+		return false;
+	}
+
+	return call(m_state.get(), 0);
+}
+
+bool LuaState::runString(const std::string& source, const std::string& chunkName, int resultCount)
+{
+	if (luaL_loadbuffer(m_state.get(), source.data(), source.size(), chunkName.c_str()) != 0)
+	{
+		LWARNING("[SCRIPTING] ", lua_tostring(m_state.get(), -1));
+		lua_pop(m_state.get(), 1);
+		return false;
+	}
+
+	return call(m_state.get(), 0, resultCount);
+}
+
+void LuaState::registerFunction(const std::string& name, LuaFunction function)
+{
+	lua_pushcfunction(m_state.get(), function);
+	lua_setglobal(m_state.get(), name.c_str());
+}
+
+void LuaState::setGlobal(const std::string& name, double value)
+{
+	lua_pushnumber(m_state.get(), value);
+	lua_setglobal(m_state.get(), name.c_str());
+}
+
+lua_State* LuaState::getState() const
+{
+	return m_state.get();
+}
+
+const std::shared_ptr<lua_State>& LuaState::getHandle() const
+{
+	return m_state;
+}
+
+bool LuaState::call(lua_State* state, int argumentCount, int resultCount)
+{
+	if (lua_pcall(state, argumentCount, resultCount, 0) != 0)
+	{
+		LWARNING("[SCRIPTING] ", lua_isstring(state, -1) ? lua_tostring(state, -1) : "The error was not a string.");
+		lua_pop(state, 1);
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,265 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#include <quartz/core/QuartzPCH.hpp>
+#include <quartz/core/utilities/Archive.hpp>
+#include <quartz/core/utilities/Compression.hpp>
+#include <quartz/core/utilities/Hash.hpp>
+#include <quartz/core/utilities/Logger.hpp>
+
+#include <cstring>
+#include <fstream>
+
+using namespace qz::utils;
+
+namespace
+{
+	// Only keep the compressed data if it saves at least this much, otherwise it isn't worth decompressing.
+	constexpr double COMPRESSION_THRESHOLD = 0.9;
+
+	std::uint64_t alignOffset(std::uint64_t offset)
+	{
+		return (offset + ARCHIVE_ALIGNMENT - 1) & ~(ARCHIVE_ALIGNMENT - 1);
+	}
+}
+
+bool Archive::open(const std::string& filepath)
+{
+	m_file = MappedFile(filepath);
+	m_entries = nullptr;
+	m_entryCount = 0;
+	m_names = nullptr;
+
+	if (!m_file.isOpen())
+		return false;
+
+	const std::uint64_t fileSize = m_file.size();
+
+	ArchiveHeader header;
+	if (fileSize < sizeof(header))
+	{
+		LWARNING("The archive ", filepath, " is too small to be an archive.");
+		return false;
+	}
+
+	std::memcpy(&header, m_file.data(), sizeof(header));
+
+	if (std::memcmp(header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0 || header.version != ARCHIVE_VERSION)
+	{
+		LWARNING("The archive ", filepath, " isn't an archive, or was packed by a different version.");
+		return false;
+	}
+
+	const std::uint64_t namesOffset = sizeof(header) + std::uint64_t(header.entryCount) * sizeof(ArchiveEntry);
+	if (namesOffset + header.namesSize > fileSize)
+	{
+		LWARNING("The archive ", filepath, " is truncated.");
+		return false;
+	}
+
+	const ArchiveEntry* entries = reinterpret_cast<const ArchiveEntry*>(m_file.data() + sizeof(header));
+
+	// Check every entry now, so nothing has to be checked when reading.
+	for (std::uint32_t i = 0; i < header.entryCount; ++i)
+	{
+		const ArchiveEntry& entry = entries[i];
+
+		if (entry.offset > fileSize || entry.storedSize > fileSize - entry.offset ||
+			std::uint64_t(entry.nameOffset) + entry.nameLength > header.namesSize ||
+			(!(entry.flags & ARCHIVE_ENTRY_COMPRESSED) && entry.storedSize != entry.size))
+		{
+			LWARNING("The archive ", filepath, " has a corrupt entry.");
+			return false;
+		}
+	}
+
+	m_entries = entries;
+	m_entryCount = header.entryCount;
+	m_names = m_file.data() + namesOffset;
+
+	return true;
+}
+
+const ArchiveEntry* Archive::find(std::string_view path) const
+{
+	if (m_entries == nullptr)
+		return nullptr;
+
+	const std::uint64_t hash = hashBytes(path.data(), path.size());
+
+	const ArchiveEntry* end = m_entries + m_entryCount;
+	const ArchiveEntry* entry = std::lower_bound(m_entries, end, hash,
+		[](const ArchiveEntry& entry, std::uint64_t hash) { return entry.hash < hash; });
+
+	// Different paths can share a hash, so check every entry with it.
+	for (; entry != end && entry->hash == hash; ++entry)
+	{
+		if (getName(*entry) == path)
+			return entry;
+	}
+
+	return nullptr;
+}
+
+std::string_view Archive::getName(const ArchiveEntry& entry) const
+{
+	return { m_names + entry.nameOffset, entry.nameLength };
+}
+
+std::string_view Archive::getStoredData(const ArchiveEntry& entry) const
+{
+	return { m_file.data() + entry.offset, static_cast<std::size_t>(entry.storedSize) };
+}
+
+bool Archive::read(const ArchiveEntry& entry, std::string& out) const
+{
+	const std::string_view stored = getStoredData(entry);
+
+	if (!(entry.flags & ARCHIVE_ENTRY_COMPRESSED))
+	{
+		out.assign(stored.data(), stored.size());
+		return true;
+	}
+
+	out.resize(static_cast<std::size_t>(entry.size));
+	if (!Compression::decompress(stored, &out[0], out.size()))
+	{
+		LWARNING("The archive entry ", getName(entry), " is corrupt.");
+		out.clear();
+		return false;
+	}
+
+	return true;
+}
+
+std::string Archive::normalizePath(std::string_view path)
+{
+	std::string normalized(path);
+	std::replace(normalized.begin(), normalized.end(), '\\', '/');
+
+	while (normalized.compare(0, 2, "./") == 0)
+		normalized.erase(0, 2);
+
+	return normalized;
+}
+
+void ArchiveWriter::add(std::string_view path, std::string data, bool compress)
+{
+	File file;
+	file.path = Archive::normalizePath(path);
+	file.size = data.size();
+	file.compressed = false;
+
+	if (compress && !data.empty())
+	{
+		std::string compressed = Compression::compress(data);
+		if (compressed.size() < data.size() * COMPRESSION_THRESHOLD)
+		{
+			data = std::move(compressed);
+			file.compressed = true;
+		}
+	}
+
+	file.data = std::move(data);
+
+	for (File& existing : m_files)
+	{
+		if (existing.path == file.path)
+		{
+			existing = std::move(file);
+			return;
+		}
+	}
+
+	m_files.push_back(std::move(file));
+}
+
+bool ArchiveWriter::write(const std::string& filepath) const
+{
+	std::vector<const File*> files;
+	for (const File& file : m_files)
+		files.push_back(&file);
+
+	std::sort(files.begin(), files.end(), [](const File* a, const File* b) { return hashString(a->path) < hashString(b->path); });
+
+	ArchiveHeader header;
+	std::memcpy(header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+	header.version = ARCHIVE_VERSION;
+	header.entryCount = static_cast<std::uint32_t>(files.size());
+	header.namesSize = 0;
+
+	std::string names;
+	std::vector<ArchiveEntry> entries(files.size());
+
+	for (std::size_t i = 0; i < files.size(); ++i)
+	{
+		ArchiveEntry& entry = entries[i];
+		entry.hash = hashString(files[i]->path);
+		entry.storedSize = files[i]->data.size();
+		entry.size = files[i]->size;
+		entry.nameOffset = static_cast<std::uint32_t>(names.size());
+		entry.nameLength = static_cast<std::uint32_t>(files[i]->path.size());
+		entry.flags = files[i]->compressed ? ARCHIVE_ENTRY_COMPRESSED : 0;
+		entry.reserved = 0;
+
+		names += files[i]->path;
+	}
+
+	header.namesSize = static_cast<std::uint32_t>(names.size());
+
+	std::uint64_t offset = sizeof(header) + entries.size() * sizeof(ArchiveEntry) + names.size();
+	for (ArchiveEntry& entry : entries)
+	{
+		entry.offset = alignOffset(offset);
+		offset = entry.offset + entry.storedSize;
+	}
+
+	std::ofstream out(filepath, std::ios::binary | std::ios::trunc);
+	if (!out)
+	{
+		LWARNING("Couldn't create the archive ", filepath);
+		return false;
+	}
+
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(ArchiveEntry));
+	out.write(names.data(), names.size());
+
+	std::uint64_t written = sizeof(header) + entries.size() * sizeof(ArchiveEntry) + names.size();
+	for (std::size_t i = 0; i < files.size(); ++i)
+	{
+		static const char padding[ARCHIVE_ALIGNMENT] = {};
+		out.write(padding, entries[i].offset - written);
+
+		out.write(files[i]->data.data(), files[i]->data.size());
+		written = entries[i].offset + entries[i].storedSize;
+	}
+
+	if (!out)
+	{
+		LWARNING("Couldn't write the archive ", filepath);
+		return false;
+	}
+
+	return true;
+}
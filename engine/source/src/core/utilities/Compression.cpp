@@ -0,0 +1,206 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#include <quartz/core/QuartzPCH.hpp>
+#include <quartz/core/utilities/Compression.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace qz::utils;
+
+namespace
+{
+	// Matches shorter than this cost more to encode than the literals they replace.
+	constexpr std::size_t MIN_MATCH = 4;
+
+	// The end of the input is always stored as literals, so matches never have to be checked against the end.
+	constexpr std::size_t LAST_LITERALS = 5;
+
+	constexpr std::size_t MAX_OFFSET = 65535;
+
+	constexpr int HASH_BITS = 14;
+	constexpr std::uint32_t NO_POSITION = 0xFFFFFFFF;
+
+	std::uint32_t read32(const unsigned char* data)
+	{
+		std::uint32_t value;
+		std::memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	std::uint32_t hashSequence(std::uint32_t sequence)
+	{
+		return (sequence * 2654435761u) >> (32 - HASH_BITS);
+	}
+
+	// Lengths that don't fit in their half of the token carry on in bytes of 255, ending with a smaller byte.
+	void writeLength(std::string& out, std::size_t length)
+	{
+		for (; length >= 255; length -= 255)
+			out.push_back(static_cast<char>(255));
+
+		out.push_back(static_cast<char>(length));
+	}
+
+	bool readLength(const unsigned char*& in, const unsigned char* end, std::size_t& length)
+	{
+		unsigned char byte;
+		do
+		{
+			if (in == end)
+				return false;
+
+			byte = *in++;
+			length += byte;
+		} while (byte == 255);
+
+		return true;
+	}
+
+	void writeSequence(std::string& out, const unsigned char* literals, std::size_t literalCount, std::size_t offset, std::size_t matchLength)
+	{
+		const std::size_t matchCode = matchLength == 0 ? 0 : matchLength - MIN_MATCH;
+
+		const unsigned char token = static_cast<unsigned char>((std::min<std::size_t>(literalCount, 15) << 4) | std::min<std::size_t>(matchCode, 15));
+		out.push_back(static_cast<char>(token));
+
+		if (literalCount >= 15)
+			writeLength(out, literalCount - 15);
+
+		out.append(reinterpret_cast<const char*>(literals), literalCount);
+
+		// The last sequence is only literals.
+		if (matchLength == 0)
+			return;
+
+		out.push_back(static_cast<char>(offset & 0xFF));
+		out.push_back(static_cast<char>(offset >> 8));
+
+		if (matchCode >= 15)
+			writeLength(out, matchCode - 15);
+	}
+}
+
+std::string Compression::compress(std::string_view input)
+{
+	const unsigned char* data = reinterpret_cast<const unsigned char*>(input.data());
+	const std::size_t size = input.size();
+
+	std::string out;
+	out.reserve(size + size / 255 + 16);
+
+	std::size_t anchor = 0;
+
+	if (size > MIN_MATCH + LAST_LITERALS)
+	{
+		std::vector<std::uint32_t> table(std::size_t(1) << HASH_BITS, NO_POSITION);
+
+		const std::size_t limit = size - LAST_LITERALS;
+
+		std::size_t position = 0;
+		while (position + MIN_MATCH <= limit)
+		{
+			const std::uint32_t sequence = read32(data + position);
+			std::uint32_t& slot = table[hashSequence(sequence)];
+
+			const std::uint32_t candidate = slot;
+			slot = static_cast<std::uint32_t>(position);
+
+			if (candidate == NO_POSITION || position - candidate > MAX_OFFSET || read32(data + candidate) != sequence)
+			{
+				++position;
+				continue;
+			}
+
+			std::size_t length = MIN_MATCH;
+			while (position + length < limit && data[candidate + length] == data[position + length])
+				++length;
+
+			writeSequence(out, data + anchor, position - anchor, position - candidate, length);
+
+			position += length;
+			anchor = position;
+		}
+	}
+
+	writeSequence(out, data + anchor, size - anchor, 0, 0);
+
+	return out;
+}
+
+bool Compression::decompress(std::string_view input, char* output, std::size_t outputSize)
+{
+	const unsigned char* in = reinterpret_cast<const unsigned char*>(input.data());
+	const unsigned char* const end = in + input.size();
+
+	std::size_t written = 0;
+
+	while (in < end)
+	{
+		const unsigned char token = *in++;
+
+		std::size_t literalCount = token >> 4;
+		if (literalCount == 15 && !readLength(in, end, literalCount))
+			return false;
+
+		if (literalCount > static_cast<std::size_t>(end - in) || literalCount > outputSize - written)
+			return false;
+
+		if (literalCount > 0)
+			std::memcpy(output + written, in, literalCount);
+
+		in += literalCount;
+		written += literalCount;
+
+		// The last sequence has no match.
+		if (in == end)
+			break;
+
+		if (end - in < 2)
+			return false;
+
+		const std::size_t offset = in[0] | (in[1] << 8);
+		in += 2;
+
+		std::size_t matchLength = token & 0xF;
+		if (matchLength == 15 && !readLength(in, end, matchLength))
+			return false;
+
+		matchLength += MIN_MATCH;
+
+		if (offset == 0 || offset > written || matchLength > outputSize - written)
+			return false;
+
+		// Matches can overlap what they are writing, which is how runs get repeated, so copy a byte at a time.
+		const char* source = output + written - offset;
+		for (std::size_t i = 0; i < matchLength; ++i)
+			output[written + i] = source[i];
+
+		written += matchLength;
+	}
+
+	return written == outputSize;
+}
@@ -24,73 +24,313 @@
 #include <quartz/core/QuartzPCH.hpp>
 #include <quartz/core/utilities/Config.hpp>
 #include <quartz/core/utilities/Logger.hpp>
+#include <quartz/core/utilities/VirtualFileSystem.hpp>
 
 #include <SDL.h>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
+#include <set>
+
+#ifdef QZ_PLATFORM_LINUX
+#	include <poll.h>
+#	include <sys/inotify.h>
+#	include <unistd.h>
+#endif
 
 using namespace qz::utils;
 using namespace qz;
 
+namespace
+{
+	// INIReader can only parse files on disk, this lets it parse a file read through the virtual file system.
+	class MemoryINIReader : public INIReader
+	{
+	public:
+		explicit MemoryINIReader(std::string_view contents)
+		{
+			_error = ini_parse_stream(&readLine, &contents, ValueHandler, this);
+		}
+
+	private:
+		// Behaves like fgets, reading from the front of the remaining contents.
+		static char* readLine(char* str, int num, void* stream)
+		{
+			std::string_view& contents = *static_cast<std::string_view*>(stream);
+			if (contents.empty() || num <= 1)
+				return nullptr;
+
+			std::size_t length = std::min(contents.size(), static_cast<std::size_t>(num - 1));
+
+			const std::size_t newline = contents.substr(0, length).find('\n');
+			if (newline != std::string_view::npos)
+				length = newline + 1;
+
+			std::memcpy(str, contents.data(), length);
+			str[length] = '\0';
+
+			contents.remove_prefix(length);
+			return str;
+		}
+	};
+}
+
 ConfigManager* ConfigManager::get()
 {
 	static ConfigManager m;
 	return &m;
 }
 
+ConfigManager::~ConfigManager()
+{
+	stopWatching();
+}
+
 ConfigFile* ConfigManager::registerConfig(const std::string & name)
 {
-	m_configfiles.insert(std::make_pair(name, ConfigFile(name + ".ini")));
-	
-	ConfigFile *configFile = &m_configfiles[name];
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto it = m_configfiles.find(name);
+	if (it != m_configfiles.end())
+		return &it->second;
+
+	ConfigFile* configFile = &m_configfiles.emplace(std::piecewise_construct, std::forward_as_tuple(name), std::forward_as_tuple(name + ".ini")).first->second;
 	configFile->reload(); // do initial load
 
+	if (m_watching)
+		addWatch(*configFile);
+
 	return configFile;
 }
 
 ConfigFile* ConfigManager::getConfigFile(const std::string & name)
 {
+	std::lock_guard<std::mutex> lock(m_mutex);
+
 	// Config file has not been registered so return an empty config.
-	if (m_configfiles.find(name) == m_configfiles.end())
+	auto it = m_configfiles.find(name);
+	if (it == m_configfiles.end())
 	{
 		static ConfigFile file;
 		LWARNING("Config file \"", name, "\" has not been registered. Returning default config file.");
 		return &file;
 	}
-	return &m_configfiles[name];
+	return &it->second;
 }
 
-int ConfigFile::getInteger(const std::string & section, const std::string & key, int defaultReturn) const
+namespace
 {
-	return m_inifile.GetInteger(section, key, defaultReturn);
+	/// @brief How often the watcher checks whether it should stop, and how often modification times are checked without inotify.
+	constexpr int WATCH_INTERVAL_MS = 250;
+
+	// Splits a config's path into the directory it is in and its filename, so changes in that directory can be matched to it.
+	std::pair<std::string, std::string> splitPath(const std::string& filepath)
+	{
+		const std::filesystem::path path(filepath);
+		const std::string directory = path.parent_path().generic_string();
+
+		return { directory.empty() ? "." : directory, path.filename().generic_string() };
+	}
 }
 
-char ConfigFile::getChar(const std::string & section, const std::string & key, char defaultReturn) const
+void ConfigManager::startWatching()
+{
+	if (m_watching)
+		return;
+
+#ifdef QZ_PLATFORM_LINUX
+	m_notifyHandle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (m_notifyHandle == -1)
+	{
+		LWARNING("Couldn't start watching config files for changes.");
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (const auto& configFile : m_configfiles)
+		addWatch(configFile.second);
+#endif
+
+	m_watching = true;
+	m_watcher = std::thread(&ConfigManager::watch, this);
+}
+
+void ConfigManager::stopWatching()
+{
+	if (!m_watching)
+		return;
+
+	m_watching = false;
+	m_watcher.join();
+
+#ifdef QZ_PLATFORM_LINUX
+	close(m_notifyHandle);
+	m_notifyHandle = -1;
+	m_watchedDirectories.clear();
+#endif
+}
+
+void ConfigManager::addWatch(const ConfigFile& file)
+{
+#ifdef QZ_PLATFORM_LINUX
+	const std::string directory = splitPath(file.getFilepath()).first;
+
+	for (const auto& watched : m_watchedDirectories)
+	{
+		if (watched.second == directory)
+			return;
+	}
+
+	// Editors often save by writing a new file and renaming it over the old one, so both are watched for.
+	const int watch = inotify_add_watch(m_notifyHandle, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+	if (watch == -1)
+	{
+		LWARNING("Couldn't watch the directory \"", directory, "\" for config changes.");
+		return;
+	}
+
+	m_watchedDirectories[watch] = directory;
+#else
+	static_cast<void>(file);
+#endif
+}
+
+void ConfigManager::watch()
+{
+#ifdef QZ_PLATFORM_LINUX
+	alignas(inotify_event) char buffer[4096];
+
+	while (m_watching)
+	{
+		pollfd descriptor = { m_notifyHandle, POLLIN, 0 };
+		if (poll(&descriptor, 1, WATCH_INTERVAL_MS) <= 0)
+			continue;
+
+		const ssize_t length = read(m_notifyHandle, buffer, sizeof(buffer));
+		if (length <= 0)
+			continue;
+
+		// Saving can raise several events at once, each changed file is only reloaded once.
+		std::set<ConfigFile*> changed;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			for (ssize_t offset = 0; offset < length;)
+			{
+				const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+				offset += sizeof(inotify_event) + event->len;
+
+				auto directory = m_watchedDirectories.find(event->wd);
+				if (event->len == 0 || directory == m_watchedDirectories.end())
+					continue;
+
+				for (auto& configFile : m_configfiles)
+				{
+					const auto path = splitPath(configFile.second.getFilepath());
+					if (path.first == directory->second && path.second == event->name)
+						changed.insert(&configFile.second);
+				}
+			}
+		}
+
+		for (ConfigFile* configFile : changed)
+		{
+			configFile->reload();
+			LINFO("Reloaded the config file \"", configFile->getFilepath(), "\".");
+		}
+	}
+#else
+	std::unordered_map<ConfigFile*, std::filesystem::file_time_type> lastWrites;
+
+	while (m_watching)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(WATCH_INTERVAL_MS));
+
+		std::vector<ConfigFile*> changed;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			for (auto& configFile : m_configfiles)
+			{
+				std::error_code error;
+				const auto lastWrite = std::filesystem::last_write_time(configFile.second.getFilepath(), error);
+				if (error)
+					continue;
+
+				auto known = lastWrites.find(&configFile.second);
+				if (known != lastWrites.end() && known->second != lastWrite)
+					changed.push_back(&configFile.second);
+
+				lastWrites[&configFile.second] = lastWrite;
+			}
+		}
+
+		for (ConfigFile* configFile : changed)
+		{
+			configFile->reload();
+			LINFO("Reloaded the config file \"", configFile->getFilepath(), "\".");
+		}
+	}
+#endif
+}
+
+int ConfigFile::read(const INIReader& inifile, const std::string& section, const std::string& key, int defaultReturn)
+{
+	return inifile.GetInteger(section, key, defaultReturn);
+}
+
+char ConfigFile::read(const INIReader& inifile, const std::string& section, const std::string& key, char defaultReturn)
 {
 	// INI has no concept of single characters only strings, so parse the first letter of the value string as the character.
-	return m_inifile.Get(section, key, std::string(defaultReturn, 1))[0];
+	return inifile.Get(section, key, std::string(1, defaultReturn))[0];
 }
 
-bool ConfigFile::getBool(const std::string & section, const std::string & key, bool defaultReturn) const
+bool ConfigFile::read(const INIReader& inifile, const std::string& section, const std::string& key, bool defaultReturn)
 {
-	return m_inifile.GetBoolean(section, key, defaultReturn);
+	return inifile.GetBoolean(section, key, defaultReturn);
 }
 
-float ConfigFile::getFloat(const std::string & section, const std::string & key, float defaultReturn) const
+float ConfigFile::read(const INIReader& inifile, const std::string& section, const std::string& key, float defaultReturn)
 {
-	return static_cast<float>(m_inifile.GetReal(section, key, static_cast<float>(defaultReturn)));
+	return static_cast<float>(inifile.GetReal(section, key, static_cast<float>(defaultReturn)));
 }
 
-events::Key ConfigFile::getScancode(const std::string & section, const std::string & key, events::Key defaultReturn) const
+events::Key ConfigFile::read(const INIReader& inifile, const std::string& section, const std::string& key, events::Key defaultReturn)
 {
 	// See https://wiki.libsdl.org/SDL_Keycode for a full map of Key Names -> Key Codes -> Scancodes
 
 	SDL_Keycode defaultKey = SDL_GetKeyFromScancode(static_cast<SDL_Scancode>(defaultReturn));
 	const char* defaultName = SDL_GetKeyName(defaultKey);
-	
-	std::string value = m_inifile.Get(section, key, defaultName);
+
+	std::string value = inifile.Get(section, key, defaultName);
 	return static_cast<events::Key>(SDL_GetScancodeFromName(value.c_str()));
 }
 
+int ConfigFile::getInteger(const std::string & section, const std::string & key, int defaultReturn) const
+{
+	return read(*std::atomic_load(&m_inifile), section, key, defaultReturn);
+}
+
+char ConfigFile::getChar(const std::string & section, const std::string & key, char defaultReturn) const
+{
+	return read(*std::atomic_load(&m_inifile), section, key, defaultReturn);
+}
+
+bool ConfigFile::getBool(const std::string & section, const std::string & key, bool defaultReturn) const
+{
+	return read(*std::atomic_load(&m_inifile), section, key, defaultReturn);
+}
+
+float ConfigFile::getFloat(const std::string & section, const std::string & key, float defaultReturn) const
+{
+	return read(*std::atomic_load(&m_inifile), section, key, defaultReturn);
+}
+
+events::Key ConfigFile::getScancode(const std::string & section, const std::string & key, events::Key defaultReturn) const
+{
+	return read(*std::atomic_load(&m_inifile), section, key, defaultReturn);
+}
+
 bool ConfigFile::existsOnDisk() const
 {
 	return !!std::ifstream(m_filepath);
@@ -98,11 +338,28 @@ bool ConfigFile::existsOnDisk() const
 
 void ConfigFile::reload()
 {
-	m_inifile = INIReader(m_filepath);
+	std::shared_ptr<INIReader> inifile;
 
-	if (!existsOnDisk())
+	// Config files are meant to be edited by players, so a copy on disk wins over a packed one.
+	if (existsOnDisk())
+	{
+		inifile = std::make_shared<INIReader>(m_filepath);
+	}
+	else if (VirtualFileSystem::get()->exists(m_filepath))
 	{
+		std::string buffer;
+		inifile = std::make_shared<INIReader>(MemoryINIReader(VirtualFileSystem::get()->view(m_filepath, buffer)));
+	}
+	else
+	{
+		inifile = std::make_shared<INIReader>(m_filepath);
 		LWARNING("Config file \"", m_filepath, "\" does not exist on disk. Default's will be used instead.");
 	}
-}
 
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	std::atomic_store(&m_inifile, std::shared_ptr<const INIReader>(inifile));
+
+	for (auto& binding : m_bindings)
+		binding->resolve(*inifile);
+}
@@ -23,22 +23,168 @@
 
 #include <quartz/core/QuartzPCH.hpp>
 #include <quartz/core/utilities/FileIO.hpp>
+#include <quartz/core/utilities/Logger.hpp>
+#include <quartz/core/utilities/ThreadPool.hpp>
+
+#ifdef QZ_PLATFORM_WINDOWS
+#	include <Windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
 
 using namespace qz::utils;
 
+MappedFile::MappedFile(const std::string& filepath)
+{
+#ifdef QZ_PLATFORM_WINDOWS
+	m_file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (m_file == INVALID_HANDLE_VALUE)
+	{
+		m_file = nullptr;
+		LWARNING("Couldn't open the file: ", filepath);
+		return;
+	}
+
+	LARGE_INTEGER size;
+	GetFileSizeEx(m_file, &size);
+	m_size = static_cast<std::size_t>(size.QuadPart);
+	m_open = true;
+
+	// Empty files can't be mapped, but there is nothing to read from them anyway.
+	if (m_size == 0)
+		return;
+
+	m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (m_mapping != nullptr)
+		m_data = static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+	const int file = open(filepath.c_str(), O_RDONLY);
+	if (file == -1)
+	{
+		LWARNING("Couldn't open the file: ", filepath);
+		return;
+	}
+
+	struct stat info;
+	fstat(file, &info);
+	m_size = static_cast<std::size_t>(info.st_size);
+	m_open = true;
+
+	// Empty files can't be mapped, but there is nothing to read from them anyway.
+	if (m_size > 0)
+	{
+		void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (data != MAP_FAILED)
+			m_data = static_cast<const char*>(data);
+	}
+
+	// The mapping keeps the file open by itself.
+	::close(file);
+#endif
+
+	if (m_size > 0 && m_data == nullptr)
+	{
+		LWARNING("Couldn't map the file: ", filepath);
+		close();
+	}
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+	*this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+	if (this != &other)
+	{
+		close();
+
+		std::swap(m_open, other.m_open);
+		std::swap(m_data, other.m_data);
+		std::swap(m_size, other.m_size);
+
+#ifdef QZ_PLATFORM_WINDOWS
+		std::swap(m_file, other.m_file);
+		std::swap(m_mapping, other.m_mapping);
+#endif
+	}
+
+	return *this;
+}
+
+void MappedFile::close()
+{
+#ifdef QZ_PLATFORM_WINDOWS
+	if (m_data != nullptr)
+		UnmapViewOfFile(m_data);
+
+	if (m_mapping != nullptr)
+		CloseHandle(m_mapping);
+
+	if (m_file != nullptr)
+		CloseHandle(m_file);
+
+	m_file = nullptr;
+	m_mapping = nullptr;
+#else
+	if (m_data != nullptr)
+		munmap(const_cast<char*>(m_data), m_size);
+#endif
+
+	m_open = false;
+	m_data = nullptr;
+	m_size = 0;
+}
+
 std::string FileIO::readAllFile(const std::string& filepath)
 {
-	std::fstream fileHandle;
-	fileHandle.open(filepath.c_str());
+	const MappedFile file(filepath);
+
+	return std::string(file.getContents());
+}
+
+MappedFile FileIO::mapFile(const std::string& filepath)
+{
+	return MappedFile(filepath);
+}
+
+std::future<std::string> FileIO::readAllFileAsync(const std::string& filepath)
+{
+	return runOnIOThread<std::string>([filepath]() { return readAllFile(filepath); });
+}
 
-	std::string fileString;
-	fileString.assign(
-		(std::istreambuf_iterator<char>(fileHandle)),
-		(std::istreambuf_iterator<char>())
-	);
+std::future<MappedFile> FileIO::mapFileAsync(const std::string& filepath)
+{
+	return runOnIOThread<MappedFile>([filepath]()
+	{
+		MappedFile file(filepath);
 
-	fileHandle.close();
+		// Touch every page, so they are read from disk here rather than when the caller first looks at them.
+		constexpr std::size_t PAGE_SIZE = 4096;
 
-	return fileString;
+		char touched = 0;
+		for (std::size_t i = 0; i < file.size(); i += PAGE_SIZE)
+			touched ^= *static_cast<const volatile char*>(file.data() + i);
+
+		static_cast<void>(touched);
+
+		return file;
+	});
 }
 
+void FileIO::queueIOWork(std::function<void()> work)
+{
+	// Reads mostly wait on the disk rather than the CPU, so a couple of threads are enough to keep it busy.
+	static threads::utils::ThreadPool<2> threadPool;
+
+	threadPool.addWork(std::move(work));
+}
@@ -121,6 +121,8 @@ void Logger::logMessage(const std::string& errorFile, int lineNumber, LogVerbosi
 	if (verbosity > m_vbLevel)
 		return;
 
+	std::lock_guard<std::mutex> lock(m_mutex);
+
 	setTerminalTextColor(verbosity);
 
 	const char* verbosityString = g_logVerbToText[static_cast<size_t>(verbosity)];
@@ -0,0 +1,133 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#include <quartz/core/QuartzPCH.hpp>
+#include <quartz/core/utilities/VirtualFileSystem.hpp>
+#include <quartz/core/utilities/Logger.hpp>
+
+#include <fstream>
+
+using namespace qz::utils;
+
+VirtualFileSystem* VirtualFileSystem::get()
+{
+	static VirtualFileSystem vfs;
+	return &vfs;
+}
+
+bool VirtualFileSystem::mountArchive(const std::string& filepath)
+{
+	auto archive = std::make_unique<Archive>();
+	if (!archive->open(filepath))
+		return false;
+
+	LINFO("Mounted the archive ", filepath, " holding ", archive->getEntryCount(), " files.");
+
+	Mount mount;
+	mount.archive = std::move(archive);
+	m_mounts.push_back(std::move(mount));
+
+	return true;
+}
+
+void VirtualFileSystem::mountDirectory(const std::string& directory)
+{
+	Mount mount;
+	mount.directory = Archive::normalizePath(directory);
+
+	if (!mount.directory.empty() && mount.directory != "." && mount.directory.back() != '/')
+		mount.directory += '/';
+
+	if (mount.directory == ".")
+		mount.directory.clear();
+
+	m_mounts.push_back(std::move(mount));
+}
+
+void VirtualFileSystem::unmountAll()
+{
+	m_mounts.clear();
+}
+
+bool VirtualFileSystem::exists(const std::string& path) const
+{
+	const std::string normalized = Archive::normalizePath(path);
+
+	for (auto mount = m_mounts.rbegin(); mount != m_mounts.rend(); ++mount)
+	{
+		if (mount->archive != nullptr ? mount->archive->find(normalized) != nullptr : !!std::ifstream(mount->directory + normalized))
+			return true;
+	}
+
+	return false;
+}
+
+std::string VirtualFileSystem::readAllFile(const std::string& path) const
+{
+	std::string buffer;
+	const std::string_view contents = view(path, buffer);
+
+	// The contents are already in the buffer unless they came straight from an archive.
+	if (contents.data() != buffer.data())
+		buffer.assign(contents.data(), contents.size());
+
+	return buffer;
+}
+
+std::future<std::string> VirtualFileSystem::readAllFileAsync(const std::string& path) const
+{
+	return FileIO::runOnIOThread<std::string>([this, path]() { return readAllFile(path); });
+}
+
+std::string_view VirtualFileSystem::view(const std::string& path, std::string& buffer) const
+{
+	const std::string normalized = Archive::normalizePath(path);
+
+	for (auto mount = m_mounts.rbegin(); mount != m_mounts.rend(); ++mount)
+	{
+		if (mount->archive != nullptr)
+		{
+			const ArchiveEntry* entry = mount->archive->find(normalized);
+			if (entry == nullptr)
+				continue;
+
+			if (!(entry->flags & ARCHIVE_ENTRY_COMPRESSED))
+				return mount->archive->getStoredData(*entry);
+
+			mount->archive->read(*entry, buffer);
+			return buffer;
+		}
+
+		const std::string filepath = mount->directory + normalized;
+		if (!std::ifstream(filepath))
+			continue;
+
+		buffer = FileIO::readAllFile(filepath);
+		return buffer;
+	}
+
+	LWARNING("Couldn't find the file ", path, " in any mounted archive or directory.");
+
+	buffer.clear();
+	return buffer;
+}
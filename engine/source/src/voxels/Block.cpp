@@ -52,26 +52,39 @@ void RegistryBlock::setBlockTextures(const std::vector<std::string>& textures) {
 
 int RegistryBlock::getInitialHP() const { return m_initialHealthPoints; }
 
+void RegistryBlock::setLightEmission(int level) { m_lightEmission = std::clamp(level, 0, 15); }
+int RegistryBlock::getLightEmission() const { return m_lightEmission; }
+
 void RegistryBlock::setPlaceCallback(const BlockCallback& callback) { m_onPlaceCallback = callback; }
 void RegistryBlock::setBreakCallback(const BlockCallback& callback) { m_onBreakCallback = callback; }
 void RegistryBlock::setInteractLeftCallback(const InteractionCallback& callback) { m_interactLeftCallback = callback; }
 void RegistryBlock::setInteractRightCallback(const InteractionCallback& callback) { m_interactRightCallback = callback; }
 
+void RegistryBlock::setRandomTickCallback(const BlockUpdateCallback& callback) { m_randomTickCallback = callback; }
+const BlockUpdateCallback& RegistryBlock::getRandomTickCallback() const { return m_randomTickCallback; }
+
+void RegistryBlock::setScheduledUpdateCallback(const BlockUpdateCallback& callback) { m_scheduledUpdateCallback = callback; }
+const BlockUpdateCallback& RegistryBlock::getScheduledUpdateCallback() const { return m_scheduledUpdateCallback; }
+
 BlockInstance::BlockInstance() :
 	m_blockID("core:unknown")
 {
-	auto it = BlockLibrary::get()->requestBlock(m_blockID);
+	const auto& it = BlockLibrary::get()->requestBlock(m_blockID);
 	m_hitpoints = it.getInitialHP();
 	m_blockType = it.getBlockType();
+	m_lightEmission = it.getLightEmission();
+	m_randomTicks = it.getRandomTickCallback() != nullptr;
 }
 
 BlockInstance::BlockInstance(const std::string& blockID) :
 	m_blockID(blockID)
 {
-	auto it = BlockLibrary::get()->requestBlock(blockID);
+	const auto& it = BlockLibrary::get()->requestBlock(blockID);
 	m_hitpoints = it.getInitialHP();
 	m_blockType = it.getBlockType();
 	m_blockName = it.getBlockName();
+	m_lightEmission = it.getLightEmission();
+	m_randomTicks = it.getRandomTickCallback() != nullptr;
 }
 
 const std::string& BlockInstance::getBlockName() const { return m_blockName; }
@@ -82,6 +95,8 @@ void BlockInstance::setHitpoints(unsigned int hitpoints) { m_hitpoints = hitpoin
 
 const std::string& BlockInstance::getBlockID() const { return m_blockID; }
 BlockType BlockInstance::getBlockType() const { return m_blockType; }
+int BlockInstance::getLightEmission() const { return m_lightEmission; }
+bool BlockInstance::hasRandomTicks() const { return m_randomTicks; }
 
 const std::vector<std::string>& BlockInstance::getBlockTextures() const { return BlockLibrary::get()->requestBlock(m_blockID).getBlockTextures(); }
 
@@ -110,6 +125,29 @@ void BlockLibrary::registerBlock(const RegistryBlock& block)
 	m_registeredBlocks.emplace(blockID, block);
 }
 
+std::size_t BlockLibrary::registerBlocks(std::vector<RegistryBlock>&& blocks)
+{
+	std::size_t registered = 0;
+	m_registeredBlocks.reserve(m_registeredBlocks.size() + blocks.size());
+
+	for (RegistryBlock& block : blocks)
+	{
+		std::string blockID = block.getBlockID();
+
+		if (m_registeredBlocks.find(blockID) != m_registeredBlocks.end())
+		{
+			LWARNING("The Block: ", blockID, " has already been registered, please take action!");
+			continue;
+		}
+
+		m_registeredBlocks.emplace(std::move(blockID), std::move(block));
+		++registered;
+	}
+
+	blocks.clear();
+	return registered;
+}
+
 const RegistryBlock& BlockLibrary::requestBlock(const std::string& blockID) const
 {
 	auto it = m_registeredBlocks.find(blockID);
@@ -117,7 +155,8 @@ const RegistryBlock& BlockLibrary::requestBlock(const std::string& blockID) cons
 	if (it == m_registeredBlocks.end())
 	{
 		LWARNING("The Block: ", blockID, " cannot be found, but is being requested. Using core:unknown block type instead. Please take action!");
-		return RegistryBlock("core:unknown", "Unknown Block", 1, BlockType::SOLID);
+		static const RegistryBlock unknownBlock("core:unknown", "Unknown Block", 1, BlockType::SOLID);
+		return unknownBlock;
 	}
 
 	return it->second;
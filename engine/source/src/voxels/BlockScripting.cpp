@@ -0,0 +1,275 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#include <quartz/core/QuartzPCH.hpp>
+#include <quartz/voxels/BlockScripting.hpp>
+#include <quartz/voxels/Block.hpp>
+#include <quartz/core/utils/Logging.hpp>
+
+#include <lua.hpp>
+
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+using namespace qz::voxels;
+using namespace qz;
+
+namespace
+{
+	// The queue is a flat array of id, definition pairs, so registering is two table stores and nothing else.
+	const char* REGISTRATION_PRELUDE = R"(
+		local pending = {}
+		local count = 0
+
+		function px_register_block(id, definition)
+			pending[count + 1] = id
+			pending[count + 2] = definition
+			count = count + 2
+		end
+
+		return pending, function() count = 0 end
+	)";
+
+	using CallbackRef = std::shared_ptr<scripting::LuaRef>;
+
+	CallbackRef makeCallback(const std::shared_ptr<lua_State>& state, int index, [[maybe_unused]] const std::string& blockID, [[maybe_unused]] const char* field)
+	{
+		if (!lua_isfunction(state.get(), index))
+		{
+			LWARNING("[SCRIPTING] The field ", field, " of the block ", blockID, " must be a function.");
+			return nullptr;
+		}
+
+		return std::make_shared<scripting::LuaRef>(state, index);
+	}
+
+	void callBlockCallback(const CallbackRef& callback)
+	{
+		lua_State* state = callback->push();
+		if (state != nullptr)
+			scripting::LuaState::call(state, 0);
+	}
+
+	void callInteractionCallback(const CallbackRef& callback, int hp)
+	{
+		lua_State* state = callback->push();
+		if (state != nullptr)
+		{
+			lua_pushinteger(state, hp);
+			scripting::LuaState::call(state, 1);
+		}
+	}
+}
+
+BlockScripting::BlockScripting(scripting::LuaState& state)
+	: m_state(state)
+{
+	m_state.setGlobal("BLOCK_GAS", static_cast<double>(BlockType::GAS));
+	m_state.setGlobal("BLOCK_LIQUID", static_cast<double>(BlockType::LIQUID));
+	m_state.setGlobal("BLOCK_SOLID", static_cast<double>(BlockType::SOLID));
+	m_state.setGlobal("BLOCK_WATER", static_cast<double>(BlockType::WATER));
+	m_state.setGlobal("BLOCK_OBJECT", static_cast<double>(BlockType::OBJECT));
+
+	lua_State* L = m_state.getState();
+
+	if (m_state.runString(REGISTRATION_PRELUDE, "=px_register_block", 2))
+	{
+		// The queue and the function that resets its length are kept together in one table.
+		lua_createtable(L, 2, 0);
+		lua_pushvalue(L, -3);
+		lua_rawseti(L, -2, 1);
+		lua_pushvalue(L, -2);
+		lua_rawseti(L, -2, 2);
+
+		m_pending = scripting::LuaRef(m_state.getHandle(), -1);
+		lua_pop(L, 3);
+	}
+}
+
+std::size_t BlockScripting::runScript(const std::string& filepath)
+{
+	// Whatever the script managed to define before an error is still registered.
+	m_state.runFile(filepath);
+	return flush();
+}
+
+std::size_t BlockScripting::flush()
+{
+	lua_State* L = m_pending.push();
+	if (L == nullptr)
+		return 0;
+
+	const int top = lua_gettop(L);
+	const std::shared_ptr<lua_State>& handle = m_state.getHandle();
+
+	lua_rawgeti(L, top, 1);
+	const int queue = lua_gettop(L);
+	const int queued = static_cast<int>(lua_objlen(L, queue));
+
+	std::vector<RegistryBlock> blocks;
+	blocks.reserve(queued / 2);
+
+	// Lua interns its strings, so the same path in any number of definitions is the same pointer.
+	std::unordered_map<const char*, std::string> textures;
+
+	for (int i = 1; i + 1 <= queued; i += 2)
+	{
+		lua_rawgeti(L, queue, i);
+		lua_rawgeti(L, queue, i + 1);
+
+		if (lua_type(L, -2) != LUA_TSTRING || !lua_istable(L, -1))
+		{
+			LWARNING("[SCRIPTING] px_register_block expects a string id and a definition table, skipping entry ", i / 2 + 1, ".");
+			lua_pop(L, 2);
+			continue;
+		}
+
+		const std::string blockID = lua_tostring(L, -2);
+		const int definition = lua_gettop(L);
+
+		std::string displayName = blockID;
+		BlockType type = BlockType::SOLID;
+		int hp = 1;
+		int light = 0;
+		std::vector<std::string> blockTextures;
+		CallbackRef onPlace, onBreak, onInteractLeft, onInteractRight;
+
+		lua_pushnil(L);
+		while (lua_next(L, definition) != 0)
+		{
+			const char* key = lua_type(L, -2) == LUA_TSTRING ? lua_tostring(L, -2) : nullptr;
+
+			if (key == nullptr)
+			{
+				LWARNING("[SCRIPTING] The block ", blockID, " has a field without a name, ignoring it.");
+			}
+			else if (std::strcmp(key, "displayname") == 0 && lua_type(L, -1) == LUA_TSTRING)
+			{
+				displayName = lua_tostring(L, -1);
+			}
+			else if (std::strcmp(key, "type") == 0 && lua_type(L, -1) == LUA_TNUMBER)
+			{
+				const int value = static_cast<int>(lua_tointeger(L, -1));
+				if (value >= static_cast<int>(BlockType::GAS) && value <= static_cast<int>(BlockType::OBJECT))
+				{
+					type = static_cast<BlockType>(value);
+				}
+				else
+				{
+					LWARNING("[SCRIPTING] The block ", blockID, " has an unknown type ", value, ".");
+				}
+			}
+			else if (std::strcmp(key, "hp") == 0 && lua_type(L, -1) == LUA_TNUMBER)
+			{
+				hp = static_cast<int>(lua_tointeger(L, -1));
+			}
+			else if (std::strcmp(key, "light") == 0 && lua_type(L, -1) == LUA_TNUMBER)
+			{
+				light = static_cast<int>(lua_tointeger(L, -1));
+			}
+			else if (std::strcmp(key, "textures") == 0 && lua_istable(L, -1))
+			{
+				const int textureCount = static_cast<int>(lua_objlen(L, -1));
+				blockTextures.reserve(textureCount);
+
+				for (int t = 1; t <= textureCount; ++t)
+				{
+					lua_rawgeti(L, -1, t);
+
+					if (lua_type(L, -1) == LUA_TSTRING)
+					{
+						std::size_t length;
+						const char* path = lua_tolstring(L, -1, &length);
+
+						auto it = textures.find(path);
+						if (it == textures.end())
+							it = textures.emplace(path, std::string(path, length)).first;
+
+						blockTextures.push_back(it->second);
+					}
+					else
+					{
+						LWARNING("[SCRIPTING] The block ", blockID, " has a texture that is not a string.");
+					}
+
+					lua_pop(L, 1);
+				}
+			}
+			else if (std::strcmp(key, "on_place") == 0)
+			{
+				onPlace = makeCallback(handle, -1, blockID, key);
+			}
+			else if (std::strcmp(key, "on_break") == 0)
+			{
+				onBreak = makeCallback(handle, -1, blockID, key);
+			}
+			else if (std::strcmp(key, "on_interact_left") == 0)
+			{
+				onInteractLeft = makeCallback(handle, -1, blockID, key);
+			}
+			else if (std::strcmp(key, "on_interact_right") == 0)
+			{
+				onInteractRight = makeCallback(handle, -1, blockID, key);
+			}
+			else
+			{
+				LWARNING("[SCRIPTING] The block ", blockID, " has an unknown or mistyped field ", key, ", ignoring it.");
+			}
+
+			lua_pop(L, 1);
+		}
+
+		RegistryBlock block(blockID, displayName, hp, type);
+		block.setBlockTextures(blockTextures);
+		block.setLightEmission(light);
+
+		if (onPlace != nullptr)
+			block.setPlaceCallback([onPlace]() { callBlockCallback(onPlace); });
+		if (onBreak != nullptr)
+			block.setBreakCallback([onBreak]() { callBlockCallback(onBreak); });
+		if (onInteractLeft != nullptr)
+			block.setInteractLeftCallback([onInteractLeft](int hp) { callInteractionCallback(onInteractLeft, hp); });
+		if (onInteractRight != nullptr)
+			block.setInteractRightCallback([onInteractRight](int hp) { callInteractionCallback(onInteractRight, hp); });
+
+		blocks.push_back(std::move(block));
+
+		lua_pop(L, 2);
+	}
+
+	// Drop the definitions so the tables can be collected, then reset the queue's length.
+	for (int i = queued; i >= 1; --i)
+	{
+		lua_pushnil(L);
+		lua_rawseti(L, queue, i);
+	}
+
+	lua_rawgeti(L, top, 2);
+	scripting::LuaState::call(L, 0);
+
+	lua_settop(L, top - 1);
+
+	return BlockLibrary::get()->registerBlocks(std::move(blocks));
+}
@@ -0,0 +1,230 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#include <quartz/core/QuartzPCH.hpp>
+#include <quartz/voxels/BlockStorage.hpp>
+
+#include <algorithm>
+
+using namespace qz::voxels;
+
+static bool isSameBlock(const BlockInstance& block1, const BlockInstance& block2)
+{
+	return block1.getBlockID() == block2.getBlockID()
+		&& block1.getHitpoints() == block2.getHitpoints()
+		&& block1.getBlockName() == block2.getBlockName();
+}
+
+template <typename Layout>
+BasicBlockStorage<Layout>::BasicBlockStorage(const BlockInstance& block) :
+	m_uniformBlock(block)
+{}
+
+template <typename Layout>
+BasicBlockStorage<Layout>::BasicBlockStorage(const BasicBlockStorage& other) :
+	m_uniformBlock(other.m_uniformBlock), m_sections(other.m_sections), m_randomTickCounts(other.m_randomTickCounts)
+{}
+
+template <typename Layout>
+BasicBlockStorage<Layout>& BasicBlockStorage<Layout>::operator=(const BasicBlockStorage& other)
+{
+	m_uniformBlock = other.m_uniformBlock;
+	m_sections = other.m_sections;
+	m_ownedSections = 0;
+	m_randomTickCounts = other.m_randomTickCounts;
+
+	return *this;
+}
+
+template <typename Layout>
+bool BasicBlockStorage<Layout>::isUniform() const
+{
+	return std::all_of(m_sections.begin(), m_sections.end(), [](const std::shared_ptr<Section>& section)
+	{
+		return section == nullptr;
+	});
+}
+
+template <typename Layout>
+bool BasicBlockStorage<Layout>::hasRandomTicks() const
+{
+	for (std::size_t i = 0; i < NUM_SECTIONS; ++i)
+	{
+		if (getRandomTickCount(i) > 0)
+			return true;
+	}
+
+	return false;
+}
+
+template <typename Layout>
+void BasicBlockStorage<Layout>::set(std::size_t index, const BlockInstance& block)
+{
+	const std::size_t section = index >> SECTION_SHIFT;
+
+	if (m_sections[section] == nullptr && isSameBlock(block, m_uniformBlock))
+		return;
+
+	Section& writable = makeWritable(section);
+	std::uint8_t& stored = writable.indices[index & SECTION_MASK];
+
+	if (writable.palette[stored].hasRandomTicks() != block.hasRandomTicks())
+		m_randomTickCounts[section] += block.hasRandomTicks() ? 1 : -1;
+
+	stored = getPaletteIndex(writable, index & SECTION_MASK, block);
+}
+
+template <typename Layout>
+void BasicBlockStorage<Layout>::fill(const BlockInstance& block)
+{
+	m_uniformBlock = block;
+
+	for (std::shared_ptr<Section>& section : m_sections)
+		section.reset();
+
+	m_ownedSections = 0;
+}
+
+template <typename Layout>
+void BasicBlockStorage<Layout>::compact()
+{
+	if (isUniform())
+		return;
+
+	const BlockInstance first = get(0);
+
+	bool uniform = true;
+	for (std::size_t i = 1; i < CHUNK_VOLUME && uniform; ++i)
+		uniform = isSameBlock(get(i), first);
+
+	if (uniform)
+	{
+		fill(first);
+		return;
+	}
+
+	// Otherwise just drop the sections that went back to being the uniform block.
+	for (std::size_t i = 0; i < NUM_SECTIONS; ++i)
+	{
+		const Section* section = m_sections[i].get();
+		if (section == nullptr)
+			continue;
+
+		const bool same = std::all_of(section->indices.begin(), section->indices.end(), [this, section](std::uint8_t index)
+		{
+			return isSameBlock(section->palette[index], m_uniformBlock);
+		});
+
+		if (same)
+		{
+			m_sections[i].reset();
+			m_ownedSections &= ~(1u << i);
+		}
+	}
+}
+
+template <typename Layout>
+typename BasicBlockStorage<Layout>::Section& BasicBlockStorage<Layout>::makeWritable(std::size_t section)
+{
+	const std::uint32_t bit = 1u << section;
+
+	if (!(m_ownedSections & bit))
+	{
+		// Whoever else has the section may be reading it, so write to a copy.
+		const Section* shared = m_sections[section].get();
+		if (shared != nullptr)
+		{
+			m_sections[section] = std::make_shared<Section>(*shared);
+		}
+		else
+		{
+			m_sections[section] = std::make_shared<Section>();
+			m_sections[section]->palette.push_back(m_uniformBlock);
+			m_sections[section]->indices.fill(0);
+
+			m_randomTickCounts[section] = m_uniformBlock.hasRandomTicks() ? SECTION_SIZE : 0;
+		}
+
+		m_ownedSections |= bit;
+	}
+
+	return *m_sections[section];
+}
+
+template <typename Layout>
+std::uint8_t BasicBlockStorage<Layout>::getPaletteIndex(Section& section, std::size_t slot, const BlockInstance& block)
+{
+	for (std::size_t i = 0; i < section.palette.size(); ++i)
+	{
+		if (isSameBlock(section.palette[i], block))
+			return static_cast<std::uint8_t>(i);
+	}
+
+	if (section.palette.size() == SECTION_SIZE)
+	{
+		// Entries are never removed as blocks are overwritten, so once the palette is full, drop the ones nothing
+		// uses any more. The slot is about to be overwritten, so it doesn't count, which always leaves room. The
+		// block may be one of the dropped entries, so it has to be copied first.
+		const BlockInstance copy = block;
+
+		std::array<bool, SECTION_SIZE> used = {};
+		for (std::size_t i = 0; i < SECTION_SIZE; ++i)
+		{
+			if (i != slot)
+				used[section.indices[i]] = true;
+		}
+
+		std::array<std::uint8_t, SECTION_SIZE> remap;
+		std::vector<BlockInstance> palette;
+
+		for (std::size_t i = 0; i < section.palette.size(); ++i)
+		{
+			if (!used[i])
+				continue;
+
+			remap[i] = static_cast<std::uint8_t>(palette.size());
+			palette.push_back(std::move(section.palette[i]));
+		}
+
+		for (std::size_t i = 0; i < SECTION_SIZE; ++i)
+			section.indices[i] = i == slot ? 0 : remap[section.indices[i]];
+
+		section.palette = std::move(palette);
+		section.palette.push_back(copy);
+		return static_cast<std::uint8_t>(section.palette.size() - 1);
+	}
+
+	section.palette.push_back(block);
+	return static_cast<std::uint8_t>(section.palette.size() - 1);
+}
+
+namespace qz
+{
+	namespace voxels
+	{
+		template class BasicBlockStorage<LinearLayout>;
+		template class BasicBlockStorage<MortonLayout>;
+		template class BasicBlockStorage<BrickLayout>;
+	}
+}
+
@@ -0,0 +1,214 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#include <quartz/core/QuartzPCH.hpp>
+#include <quartz/voxels/BlockUpdateScheduler.hpp>
+#include <quartz/voxels/ChunkManager.hpp>
+
+#include <algorithm>
+#include <unordered_map>
+
+using namespace qz::voxels;
+using namespace qz;
+
+void BlockUpdate::setBlock(const qz::Vector3i& position, const BlockInstance& block, BlockEditType type)
+{
+	m_edits->push_back({ position, block, type });
+}
+
+void BlockUpdate::scheduleUpdate(const qz::Vector3i& position, unsigned int delay)
+{
+	m_scheduled->push_back({ position, delay });
+}
+
+BlockUpdateScheduler::BlockUpdateScheduler(ChunkManager* world, threads::utils::ThreadPool<>& threadPool) :
+	m_world(world), m_threadPool(threadPool), m_timestep(TICKS_PER_SECOND)
+{}
+
+void BlockUpdateScheduler::update(float dt)
+{
+	const int ticks = m_timestep.consume(dt);
+	for (int i = 0; i < ticks; ++i)
+		tick();
+}
+
+void BlockUpdateScheduler::tick()
+{
+	++m_currentTick;
+
+	std::vector<ChunkJob> jobs;
+	std::unordered_map<std::uint64_t, std::size_t> jobIndices;
+
+	const auto getJob = [&](Chunk* chunk) -> ChunkJob&
+	{
+		const auto it = jobIndices.emplace(chunkKey(chunk->getChunkPos()), jobs.size());
+		if (it.second)
+		{
+			jobs.emplace_back();
+			jobs.back().chunk = chunk;
+			jobs.back().blocks = chunk->getBlocks();
+		}
+
+		return jobs[it.first->second];
+	};
+
+	// Everything in this tick's slot is due, apart from updates that are more than a lap of the wheel away.
+	std::vector<ScheduledUpdate>& slot = m_wheel[m_currentTick % WHEEL_SIZE];
+
+	std::size_t waiting = 0;
+	for (ScheduledUpdate& update : slot)
+	{
+		if (update.rounds > 0)
+		{
+			--update.rounds;
+			slot[waiting++] = update;
+			continue;
+		}
+
+		Chunk* chunk = m_world->getChunk(worldToChunk(update.position));
+		if (chunk == nullptr)
+			continue;
+
+		getJob(chunk).scheduled.push_back(static_cast<std::uint16_t>(localToIndex(worldToLocal(update.position))));
+	}
+
+	slot.resize(waiting);
+
+	m_world->forEachChunk([&](Chunk* chunk)
+	{
+		// Checking the counts of a chunk without any blocks that tick is cheap, but there's no point making a job.
+		const std::shared_ptr<const BlockStorage> blocks = chunk->getBlocks();
+		if (!blocks->hasRandomTicks())
+			return;
+
+		ChunkJob& job = getJob(chunk);
+		job.blocks = blocks;
+		job.randomTicks = true;
+	});
+
+	if (jobs.empty())
+		return;
+
+	if (jobs.size() == 1)
+	{
+		run(jobs.front());
+	}
+	else
+	{
+		for (ChunkJob& job : jobs)
+			m_threadPool.addWork([this, &job]() { run(job); });
+
+		m_threadPool.wait();
+	}
+
+	std::vector<BlockEdit> edits;
+	for (ChunkJob& job : jobs)
+	{
+		edits.insert(edits.end(), std::make_move_iterator(job.edits.begin()), std::make_move_iterator(job.edits.end()));
+
+		for (const BlockUpdate::Scheduled& scheduled : job.newlyScheduled)
+			schedule(scheduled.position, scheduled.delay);
+	}
+
+	if (!edits.empty())
+		m_world->applyEdits(edits);
+}
+
+void BlockUpdateScheduler::schedule(const qz::Vector3i& position, unsigned int delay)
+{
+	delay = std::max(delay, 1u);
+
+	const std::uint64_t due = m_currentTick + delay;
+	m_wheel[due % WHEEL_SIZE].push_back({ position, static_cast<std::uint32_t>((delay - 1) / WHEEL_SIZE) });
+}
+
+void BlockUpdateScheduler::unloadChunk(const qz::Vector3i& chunkPos)
+{
+	for (std::vector<ScheduledUpdate>& slot : m_wheel)
+	{
+		slot.erase(std::remove_if(slot.begin(), slot.end(), [&chunkPos](const ScheduledUpdate& update)
+		{
+			return worldToChunk(update.position) == chunkPos;
+		}), slot.end());
+	}
+}
+
+std::size_t BlockUpdateScheduler::getScheduledCount() const
+{
+	std::size_t count = 0;
+	for (const std::vector<ScheduledUpdate>& slot : m_wheel)
+		count += slot.size();
+
+	return count;
+}
+
+void BlockUpdateScheduler::run(ChunkJob& job) const
+{
+	const Vector3i origin = chunkToWorld(job.chunk->getChunkPos());
+	const BlockLibrary* library = BlockLibrary::get();
+
+	// Seeded from the chunk and the tick, so the same world plays out the same way however the jobs are spread out.
+	std::minstd_rand random(static_cast<std::uint32_t>(chunkKey(job.chunk->getChunkPos()) * 0x9E3779B97F4A7C15ull >> 32) ^ static_cast<std::uint32_t>(m_currentTick));
+
+	BlockUpdate update;
+	update.m_world = m_world;
+	update.m_random = &random;
+	update.m_edits = &job.edits;
+	update.m_scheduled = &job.newlyScheduled;
+
+	for (std::uint16_t index : job.scheduled)
+	{
+		const BlockInstance& block = job.blocks->get(index);
+
+		const BlockUpdateCallback& callback = library->requestBlock(block.getBlockID()).getScheduledUpdateCallback();
+		if (callback == nullptr)
+			continue;
+
+		update.m_position = origin + indexToLocal(index);
+		update.m_block = &block;
+		callback(update);
+	}
+
+	if (!job.randomTicks)
+		return;
+
+	for (std::size_t section = 0; section < BlockStorage::NUM_SECTIONS; ++section)
+	{
+		if (job.blocks->getRandomTickCount(section) == 0)
+			continue;
+
+		for (int i = 0; i < RANDOM_TICKS_PER_SECTION; ++i)
+		{
+			const std::size_t index = (section << BlockStorage::SECTION_SHIFT) | (random() & BlockStorage::SECTION_MASK);
+
+			const BlockInstance& block = job.blocks->get(index);
+			if (!block.hasRandomTicks())
+				continue;
+
+			update.m_position = origin + indexToLocal(index);
+			update.m_block = &block;
+			library->requestBlock(block.getBlockID()).getRandomTickCallback()(update);
+		}
+	}
+}
+
@@ -23,10 +23,15 @@
 
 #include <quartz/core/QuartzPCH.hpp>
 #include <quartz/voxels/Chunk.hpp>
+#include <quartz/voxels/ChunkManager.hpp>
 
 #include <quartz/core/graphics/gl/VertexAttrib.hpp>
 #include <quartz/voxels/terrain/PerlinNoise.hpp>
 
+#if defined(_MSC_VER)
+#	include <intrin.h>
+#endif
+
 using namespace qz::voxels;
 using namespace qz;
 
@@ -134,39 +139,298 @@ const int ACTUAL_CUBE_SIZE = 2;
 const int NUM_FACES_IN_CUBE = 6;
 const int NUM_VERTS_IN_FACE = 6;
 
-struct ChunkVert3D
+// The faces are stored as 2 triangles, the 4 unique corners of the quad are at these offsets.
+static const int QUAD_CORNERS[] = { 0, 1, 2, 4 };
+
+// The corners of the quad to use for each vertex, the flipped order splits the quad along the other diagonal.
+static const int QUAD_ORDER[] = { 0, 1, 2, 2, 3, 0 };
+static const int FLIPPED_QUAD_ORDER[] = { 1, 2, 3, 3, 0, 1 };
+
+// Indexed by BlockFace.
+static const Vector3i FACE_NORMALS[] = {
+	{ 0, 0, -1 },
+	{ 0, 0, 1 },
+	{ -1, 0, 0 },
+	{ 1, 0, 0 },
+	{ 0, -1, 0 },
+	{ 0, 1, 0 },
+};
+
+// The order faces of a block are added to the mesh in, which also decides the order textures are reserved in.
+static const BlockFace MESHING_FACE_ORDER[] = {
+	BlockFace::RIGHT, BlockFace::LEFT,
+	BlockFace::BOTTOM, BlockFace::TOP,
+	BlockFace::FRONT, BlockFace::BACK,
+};
+
+// The brightness of a corner for each ambient occlusion value.
+static const float AO_LEVELS[] = { 0.f, 1.f / 3.f, 2.f / 3.f, 1.f };
+
+// Coarse meshes are only seen from far away, where ambient occlusion is too small to make out.
+static const std::array<std::uint8_t, 4> LOD_FACE_AO = { 3, 3, 3, 3 };
+
+// The number of cells at the finest level of detail that is downsampled, each a cube of 2 blocks.
+static const std::size_t LOD_GRID_VOLUME = CHUNK_VOLUME / 8;
+
+const int PADDED_CHUNK_SIZE = CHUNK_SIZE + 2;
+
+// Every block in a row along x, as bits.
+using RowMask = std::uint32_t;
+
+const RowMask FULL_ROW = (1u << CHUNK_SIZE) - 1;
+
+static_assert(CHUNK_SIZE + 2 <= 32, "A padded row of the chunk must fit in a RowMask.");
+
+static int countTrailingZeros(RowMask bits)
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, bits);
+	return static_cast<int>(index);
+#else
+	return __builtin_ctz(bits);
+#endif
+}
+
+/**
+ * @brief Whether each block in a chunk is solid, plus a 1 block border taken from the neighbouring chunks.
+ *
+ * The neighbouring chunks are only searched for once while filling the cache, so ambient occlusion can look at the
+ * blocks around each corner with a plain array index.
+ *
+ * The same information is also kept as a bitmask per row along x, so the mesher can find the visible faces of a
+ * whole row at once instead of testing each block.
+ */
+class PaddedSolidCache
 {
-	qz::Vector3 verts;
-	qz::Vector2 uvs;
+public:
+	PaddedSolidCache(const BlockStorage& blocks, const Vector3i& chunkPos, const ChunkManager* manager)
+	{
+		if (blocks.isUniform())
+		{
+			const BlockType type = blocks.getUniformBlock().getBlockType();
+
+			// The border is overwritten below, so the whole cache can take the value of the interior.
+			m_solid.fill(type == BlockType::SOLID);
+			m_solidRows.fill(type == BlockType::SOLID ? ~RowMask(0) : 0);
+			m_filledRows.fill(type != BlockType::GAS ? FULL_ROW : 0);
+		}
+		else
+		{
+			m_solidRows.fill(0);
+			m_filledRows.fill(0);
+
+			for (std::size_t i = 0; i < CHUNK_VOLUME; ++i)
+			{
+				const Vector3i local = indexToLocal(i);
+				const BlockType type = blocks.get(i).getBlockType();
+
+				setSolid(local, type == BlockType::SOLID);
+				m_filledRows[local.y + CHUNK_SIZE * local.z] |= static_cast<RowMask>(type != BlockType::GAS) << local.x;
+			}
+		}
+
+		// Snapshots of the neighbours, so they stay the same while the border is filled in.
+		std::shared_ptr<const BlockStorage> neighbours[27];
+		for (int i = 0; i < 27; ++i)
+		{
+			const Chunk* neighbour = manager->getChunk(chunkPos + Vector3i(i % 3 - 1, (i / 3) % 3 - 1, i / 9 - 1));
+			if (neighbour != nullptr)
+				neighbours[i] = neighbour->getBlocks();
+		}
+
+		const auto neighbourOffset = [](int coord) { return coord < 0 ? 0 : (coord < CHUNK_SIZE ? 1 : 2); };
+
+		for (int z = -1; z <= CHUNK_SIZE; ++z)
+		{
+			for (int y = -1; y <= CHUNK_SIZE; ++y)
+			{
+				for (int x = -1; x <= CHUNK_SIZE; ++x)
+				{
+					const Vector3i local = { x, y, z };
+					if (isLocalInBounds(local))
+						continue;
+
+					const BlockStorage* neighbour = neighbours[neighbourOffset(x) + neighbourOffset(y) * 3 + neighbourOffset(z) * 9].get();
+					setSolid(local, neighbour != nullptr && neighbour->get(localToIndex(worldToLocal(local))).getBlockType() == BlockType::SOLID);
+				}
+			}
+		}
+	}
+
+	bool isSolid(std::size_t index) const { return m_solid[index] != 0; }
+
+	/**
+	 * @brief Gets the solid blocks along a row of the padded chunk, bit 0 is the border block at x = -1.
+	 */
+	RowMask getSolidRow(int y, int z) const { return m_solidRows[(y + 1) + PADDED_CHUNK_SIZE * (z + 1)]; }
+
+	/**
+	 * @brief Gets the blocks along a row of the chunk that are not gas and so need meshing, bit 0 is x = 0.
+	 */
+	RowMask getFilledRow(int y, int z) const { return m_filledRows[y + CHUNK_SIZE * z]; }
+
+	static std::size_t getIndex(const Vector3i& local)
+	{
+		return (local.x + 1) + PADDED_CHUNK_SIZE * ((local.y + 1) + PADDED_CHUNK_SIZE * (local.z + 1));
+	}
+
+private:
+	void setSolid(const Vector3i& local, bool solid)
+	{
+		m_solid[getIndex(local)] = solid;
+
+		RowMask& row = m_solidRows[(local.y + 1) + PADDED_CHUNK_SIZE * (local.z + 1)];
+		const RowMask bit = 1u << (local.x + 1);
 
-	int texLayer;
+		row = solid ? (row | bit) : (row & ~bit);
+	}
 
-	ChunkVert3D(const qz::Vector3& vertices, const qz::Vector2& UVs, const int textureLayer) :
-		verts(vertices), uvs(UVs), texLayer(textureLayer)
-	{}
+	std::array<std::uint8_t, PADDED_CHUNK_SIZE * PADDED_CHUNK_SIZE * PADDED_CHUNK_SIZE> m_solid;
+	std::array<RowMask, PADDED_CHUNK_SIZE * PADDED_CHUNK_SIZE> m_solidRows;
+	std::array<RowMask, CHUNK_SIZE * CHUNK_SIZE> m_filledRows;
 };
 
-void Mesh::reset()
+/**
+ * @brief The blocks that darken a corner of a face, as offsets into a PaddedSolidCache from the block the face faces.
+ *
+ * Each corner is darkened by the 2 blocks along its edges and the block diagonally across from it.
+ */
+struct CornerNeighbours
 {
-	vertices.clear();
-	vertices.shrink_to_fit();
+	int edge1;
+	int edge2;
+	int diagonal;
+};
+
+using FaceAOTable = std::array<std::array<CornerNeighbours, 4>, NUM_FACES_IN_CUBE>;
+
+static FaceAOTable buildFaceAOTable()
+{
+	const auto offset = [](const Vector3i& direction)
+	{
+		return direction.x + PADDED_CHUNK_SIZE * (direction.y + PADDED_CHUNK_SIZE * direction.z);
+	};
+
+	FaceAOTable table;
 
-	normals.clear();
-	normals.shrink_to_fit();
+	for (int face = 0; face < NUM_FACES_IN_CUBE; ++face)
+	{
+		const Vector3i& normal = FACE_NORMALS[face];
+
+		for (int corner = 0; corner < 4; ++corner)
+		{
+			const Vector3& vertex = CUBE_VERTS[(face * NUM_FACES_IN_CUBE) + QUAD_CORNERS[corner]];
 
-	uvs.clear();
-	uvs.shrink_to_fit();
+			// The direction of the corner from the center of the face.
+			const Vector3i direction = {
+				normal.x != 0 ? 0 : (vertex.x > 0.f ? 1 : -1),
+				normal.y != 0 ? 0 : (vertex.y > 0.f ? 1 : -1),
+				normal.z != 0 ? 0 : (vertex.z > 0.f ? 1 : -1)
+			};
 
-	texLayers.clear();
-	uvs.shrink_to_fit();
+			const Vector3i side1 = direction.x != 0 ? Vector3i(direction.x, 0, 0) : Vector3i(0, direction.y, 0);
+			const Vector3i side2 = direction - side1;
+
+			table[face][corner] = { offset(side1), offset(side2), offset(direction) };
+		}
+	}
+
+	return table;
 }
 
-void Mesh::update(const Mesh& other)
+static const FaceAOTable FACE_AO_TABLE = buildFaceAOTable();
+
+/**
+ * @brief Calculates the ambient occlusion at each corner of a face.
+ * @param solid The solid blocks in and around the chunk.
+ * @param paddedIndex The index of the block within the solid cache.
+ * @param face The face of the block to calculate the occlusion for.
+ * @return The occlusion of each corner, from 0 (fully occluded) to 3 (unoccluded).
+ *
+ * If both edges of a corner are solid it's fully occluded, whatever is on the diagonal.
+ *
+ * Define QZ_VOXEL_DISABLE_AO through the build system to leave every corner unoccluded, which is how the cost of
+ * ambient occlusion is benchmarked.
+ */
+#if defined(QZ_VOXEL_DISABLE_AO)
+static std::array<std::uint8_t, 4> calculateFaceAO(const PaddedSolidCache&, std::size_t, BlockFace)
 {
-	vertices = other.vertices;
-	normals = other.normals;
-	uvs = other.uvs;
-	texLayers = other.texLayers;
+	return LOD_FACE_AO;
+}
+#else
+static std::array<std::uint8_t, 4> calculateFaceAO(const PaddedSolidCache& solid, std::size_t paddedIndex, BlockFace face)
+{
+	const int faceIndex = static_cast<int>(face);
+
+	const Vector3i& normal = FACE_NORMALS[faceIndex];
+	const std::size_t front = paddedIndex + normal.x + PADDED_CHUNK_SIZE * (normal.y + PADDED_CHUNK_SIZE * normal.z);
+
+	std::array<std::uint8_t, 4> ao;
+
+	for (int corner = 0; corner < 4; ++corner)
+	{
+		const CornerNeighbours& neighbours = FACE_AO_TABLE[faceIndex][corner];
+
+		const int edge1 = solid.isSolid(front + neighbours.edge1);
+		const int edge2 = solid.isSolid(front + neighbours.edge2);
+		const int diagonal = solid.isSolid(front + neighbours.diagonal);
+
+		ao[corner] = static_cast<std::uint8_t>((edge1 && edge2) ? 0 : 3 - (edge1 + edge2 + diagonal));
+	}
+
+	return ao;
+}
+#endif
+
+/**
+ * @brief Collects the callbacks for a batch of edits so they can all be fired once the chunk is unlocked.
+ *
+ * Edits tend to use the same few blocks over and over, so the last looked up block is remembered rather than going
+ * back to the BlockLibrary for each one.
+ */
+class EditCallbacks
+{
+public:
+	void add(const std::string& blockID, BlockEditType type)
+	{
+		if (type == BlockEditType::SET)
+			return;
+
+		if (m_lastBlock == nullptr || m_lastBlock->getBlockID() != blockID)
+			m_lastBlock = &BlockLibrary::get()->requestBlock(blockID);
+
+		const BlockCallback& callback = type == BlockEditType::PLACE ? m_lastBlock->getPlaceCallback() : m_lastBlock->getBreakCallback();
+		if (callback != nullptr)
+			m_pending.push_back(&callback);
+	}
+
+	void fire() const
+	{
+		for (const BlockCallback* callback : m_pending)
+			(*callback)();
+	}
+
+private:
+	std::vector<const BlockCallback*> m_pending;
+	const RegistryBlock* m_lastBlock = nullptr;
+};
+
+static void applyEdit(BlockStorage& blocks, std::size_t index, const BlockInstance& block, BlockEditType type, EditCallbacks& callbacks)
+{
+	callbacks.add(type == BlockEditType::BREAK ? blocks.get(index).getBlockID() : block.getBlockID(), type);
+	blocks.set(index, block);
+}
+
+void Mesh::reset()
+{
+	if (vertices.capacity() > 0)
+		MeshBufferPool::get()->release(std::move(vertices));
+}
+
+void Mesh::clear()
+{
+	vertices.clear();
 }
 
 std::size_t Mesh::triangleCount() const
@@ -199,7 +463,7 @@ ChunkMesh& ChunkMesh::operator=(ChunkMesh&& other)
 	return *this;
 }
 
-void ChunkMesh::add(const BlockInstance& block, BlockFace face, qz::Vector3 chunkPos, qz::Vector3 blockPos, Chunk* chunk)
+void ChunkMesh::add(const BlockInstance& block, BlockFace face, const qz::Vector3i& chunkPos, const qz::Vector3i& blockPos, std::uint8_t light, const std::array<std::uint8_t, 4>& ao, Chunk* chunk, int size)
 {
 	if (block.getBlockType() == BlockType::SOLID)
 	{
@@ -211,26 +475,93 @@ void ChunkMesh::add(const BlockInstance& block, BlockFace face, qz::Vector3 chun
 
 		if (static_cast<std::size_t>(face) < blockTexList.size())
 		{
-			renderer.reserveTexture(blockTexList[static_cast<int>(face)]);
-			texLayer = renderer.getTexLayer(blockTexList[static_cast<int>(face)]);
+			texLayer = renderer.reserveTexture(blockTexList[static_cast<int>(face)]);
 		}
 
-		for (int i = 0; i < NUM_VERTS_IN_FACE; ++i)
+		// Multiply by 2, as that is the size of the actual cube edges, indicated by the cube vertices.
+		const qz::Vector3i worldPos = (chunkToWorld(chunkPos) + blockPos) * ACTUAL_CUBE_SIZE;
+
+		const float skyLight = static_cast<float>(light >> 4) / LightMap::MAX_LIGHT;
+		const float blockLight = static_cast<float>(light & 0x0F) / LightMap::MAX_LIGHT;
+
+		// Interpolating the occlusion across the triangles looks different depending on which diagonal the quad is
+		// split along, so always split along the darker one to keep the shading consistent.
+		const int* quadOrder = (ao[0] + ao[2] > ao[1] + ao[3]) ? FLIPPED_QUAD_ORDER : QUAD_ORDER;
+
+		if (m_blockMesh.vertices.capacity() == 0)
+			m_blockMesh.vertices = MeshBufferPool::get()->acquire(m_blockVertexHint);
+
+		// The vertices of each face go in backwards, which gives the triangles the winding the renderer culls with.
+		// A cube several blocks wide grows away from its lowest block, and its texture repeats once per block.
+		const float scale = static_cast<float>(size);
+		const float offset = static_cast<float>(size - 1);
+
+		for (int i = NUM_VERTS_IN_FACE - 1; i >= 0; --i)
 		{
-			qz::Vector3 blockVertices = CUBE_VERTS[(static_cast<int>(face) * NUM_FACES_IN_CUBE) + i];
-			blockVertices.x += (blockPos.x * ACTUAL_CUBE_SIZE) + (chunkPos.x * ACTUAL_CUBE_SIZE); // Multiply by 2, as that is the size of the actual cube edges, indicated by the cube vertices.
-			blockVertices.y += (blockPos.y * ACTUAL_CUBE_SIZE) + (chunkPos.y * ACTUAL_CUBE_SIZE);
-			blockVertices.z += (blockPos.z * ACTUAL_CUBE_SIZE) + (chunkPos.z * ACTUAL_CUBE_SIZE);
+			const int corner = quadOrder[i];
+			const int vertIndex = (static_cast<int>(face) * NUM_FACES_IN_CUBE) + QUAD_CORNERS[corner];
+
+			qz::Vector3 blockVertices = CUBE_VERTS[vertIndex] * scale;
+			blockVertices.x += offset + static_cast<float>(worldPos.x);
+			blockVertices.y += offset + static_cast<float>(worldPos.y);
+			blockVertices.z += offset + static_cast<float>(worldPos.z);
 
-			qz::Vector2 cubeUVs = CUBE_UV[(static_cast<int>(face) * NUM_FACES_IN_CUBE) + i];
+			qz::Vector2 uvs = CUBE_UV[vertIndex];
+			uvs.x *= scale;
+			uvs.y *= scale;
 
-			m_blockMesh.vertices.push_back(blockVertices);
-			m_blockMesh.uvs.push_back(cubeUVs);
-			m_blockMesh.texLayers.push_back(texLayer);
+			m_blockMesh.vertices.emplace_back(blockVertices, uvs, static_cast<float>(texLayer), qz::Vector3(skyLight, blockLight, AO_LEVELS[ao[corner]]));
 		}
 	}
 }
 
+void ChunkMesh::addFluid(const BlockInstance& block, BlockFace face, const qz::Vector3i& chunkPos, const qz::Vector3i& blockPos, std::uint8_t light, float height, Chunk* chunk)
+{
+	ChunkRenderer& renderer = chunk->getWaterRenderer();
+
+	int texLayer = -1;
+
+	auto& blockTexList = block.getBlockTextures();
+
+	if (static_cast<std::size_t>(face) < blockTexList.size())
+	{
+		texLayer = renderer.reserveTexture(blockTexList[static_cast<int>(face)]);
+	}
+
+	const qz::Vector3i worldPos = (chunkToWorld(chunkPos) + blockPos) * ACTUAL_CUBE_SIZE;
+
+	const float skyLight = static_cast<float>(light >> 4) / LightMap::MAX_LIGHT;
+	const float blockLight = static_cast<float>(light & 0x0F) / LightMap::MAX_LIGHT;
+
+	// The top of the cube is lowered to the surface of the fluid.
+	const float top = height * ACTUAL_CUBE_SIZE - 1.f;
+
+	if (m_waterMesh.vertices.capacity() == 0)
+		m_waterMesh.vertices = MeshBufferPool::get()->acquire(m_waterVertexHint);
+
+	for (int i = NUM_VERTS_IN_FACE - 1; i >= 0; --i)
+	{
+		const int vertIndex = (static_cast<int>(face) * NUM_FACES_IN_CUBE) + QUAD_CORNERS[QUAD_ORDER[i]];
+
+		qz::Vector3 fluidVertices = CUBE_VERTS[vertIndex];
+		if (fluidVertices.y > 0.f)
+			fluidVertices.y = top;
+
+		fluidVertices.x += static_cast<float>(worldPos.x);
+		fluidVertices.y += static_cast<float>(worldPos.y);
+		fluidVertices.z += static_cast<float>(worldPos.z);
+
+		m_waterMesh.vertices.emplace_back(fluidVertices, CUBE_UV[vertIndex], static_cast<float>(texLayer), qz::Vector3(skyLight, blockLight, AO_LEVELS[3]));
+	}
+}
+
+void ChunkMesh::clearAll()
+{
+	m_blockMesh.clear();
+	m_objectMesh.clear();
+	m_waterMesh.clear();
+}
+
 const Mesh& ChunkMesh::getBlockMesh() const
 {
 	return m_blockMesh;
@@ -246,6 +577,20 @@ const Mesh& ChunkMesh::getWaterMesh() const
 	return m_waterMesh;
 }
 
+Mesh ChunkMesh::takeBlockMesh()
+{
+	m_blockVertexHint = m_blockMesh.vertices.size();
+
+	return std::move(m_blockMesh);
+}
+
+Mesh ChunkMesh::takeWaterMesh()
+{
+	m_waterVertexHint = m_waterMesh.vertices.size();
+
+	return std::move(m_waterMesh);
+}
+
 void ChunkMesh::resetAll()
 {
 	m_blockMesh.reset();
@@ -306,23 +651,27 @@ ChunkRenderer& ChunkRenderer::operator=(ChunkRenderer&& other)
 void ChunkRenderer::resetMesh()
 {
 	m_mesh.reset();
+	m_vertexCount = 0;
 }
 
-void ChunkRenderer::updateMesh(const Mesh& mesh)
+void ChunkRenderer::updateMesh(Mesh&& mesh)
 {
-	m_mesh.update(mesh);
+	// A mesh that never got uploaded is simply replaced.
+	m_mesh.reset();
+	m_mesh = std::move(mesh);
 }
 
-void ChunkRenderer::reserveTexture(const std::string& path)
+int ChunkRenderer::reserveTexture(const std::string& path)
 {
-	if (m_texReservations.find(path) == m_texReservations.end())
-	{
-		if (m_textureArray != nullptr)
-			m_currentLayer = m_textureArray->getCurrentLayer();
+	const auto it = m_texReservations.find(path);
+	if (it != m_texReservations.end())
+		return it->second;
 
-		m_texReservations.emplace(path, m_currentLayer);
-		m_currentLayer++;
-	}
+	if (m_textureArray != nullptr)
+		m_currentLayer = m_textureArray->getCurrentLayer();
+
+	m_texReservations.emplace(path, m_currentLayer);
+	return m_currentLayer++;
 }
 
 int ChunkRenderer::getTexLayer(const std::string& path)
@@ -347,6 +696,8 @@ void ChunkRenderer::loadTextures()
 
 void ChunkRenderer::bufferData()
 {
+	m_vertexCount = m_mesh.vertices.size();
+
 	if (m_mesh.vertices.empty())
 		return;
 
@@ -358,52 +709,53 @@ void ChunkRenderer::bufferData()
 	if (m_vbo == nullptr)
 		m_vbo = new gfx::gl::VertexBuffer(gfx::gl::BufferTarget::ARRAY_BUFFER, gfx::gl::BufferUsage::DYNAMIC_DRAW);
 
-	std::vector<ChunkVert3D> temp;
-
-	// Not doing vector::size() - 1, i >= 0; as std::size_t is a variant of an unsigned int, which does not go below 0, making it an infinitely running loop. 
-	// (i mean, shit would DEFINITELY hit the ceiling first, but who even fucking cares)
-	for (std::size_t i = m_mesh.vertices.size(); i > 0; i--)
-	{
-		temp.emplace_back(m_mesh.vertices[i - 1], m_mesh.uvs[i - 1], m_mesh.texLayers[i - 1]);
-	}
-
 	m_vbo->bind();
-	m_vbo->setData(static_cast<void*>(temp.data()), sizeof(ChunkVert3D) * temp.size());
+	m_vbo->setData(static_cast<void*>(m_mesh.vertices.data()), sizeof(ChunkVert3D) * m_mesh.vertices.size());
 
 	gfx::gl::VertexAttrib vertAttrib	= gfx::gl::VertexAttrib(0, 3, sizeof(ChunkVert3D), offsetof(ChunkVert3D, verts),	gfx::gl::GLType::FLOAT);
 	gfx::gl::VertexAttrib uvAttrib		= gfx::gl::VertexAttrib(1, 2, sizeof(ChunkVert3D), offsetof(ChunkVert3D, uvs),		gfx::gl::GLType::FLOAT);
 	gfx::gl::VertexAttrib layerAttrib	= gfx::gl::VertexAttrib(2, 1, sizeof(ChunkVert3D), offsetof(ChunkVert3D, texLayer),	gfx::gl::GLType::FLOAT);
+	gfx::gl::VertexAttrib shadingAttrib	= gfx::gl::VertexAttrib(3, 3, sizeof(ChunkVert3D), offsetof(ChunkVert3D, shading),	gfx::gl::GLType::FLOAT);
 
 	vertAttrib.enable();
 	uvAttrib.enable();
 	layerAttrib.enable();
+	shadingAttrib.enable();
 
 	m_vao->unbind();
 
 	// bufferData() is usually called just before a render call, meaning that if the textureArray is a nullptr, then things will go south pretty fucking fast.
 	if (m_textureArray == nullptr)
 		m_textureArray = new gfx::gl::TextureArray();
+
+	// The GPU has its own copy now, so the memory can go towards the next mesh.
+	m_mesh.reset();
 }
 
 void ChunkRenderer::render() const
 {
-	if (m_mesh.vertices.empty())
+	if (m_vertexCount == 0)
 		return;
 
 	m_textureArray->bind(10);
 	m_vao->bind();
-	GLCheck(glDrawArrays(GL_TRIANGLES, 0, m_mesh.vertices.size()));
+	GLCheck(glDrawArrays(GL_TRIANGLES, 0, m_vertexCount));
+}
+
+const Mesh& ChunkRenderer::getMesh() const
+{
+	return m_mesh;
 }
 
 std::size_t ChunkRenderer::getTrianglesCount() const
 {
-	return m_mesh.triangleCount();
+	return m_vertexCount / 3;
 }
 
-Chunk::Chunk(const Chunk& other) : m_chunkFlags(NEEDS_MESHING)
+Chunk::Chunk(const Chunk& other) : m_chunkFlags(NEEDS_MESHING), m_lod(other.getLOD()), m_blocks(other.getBlocks())
 {
+	m_manager = other.m_manager;
 	m_chunkPos = other.m_chunkPos;
-	m_chunkSize = other.m_chunkSize;
 
 	m_mesh = other.m_mesh;
 
@@ -412,7 +764,8 @@ Chunk::Chunk(const Chunk& other) : m_chunkFlags(NEEDS_MESHING)
 	m_waterRenderer = ChunkRenderer();
 
 	m_defaultBlockID = other.m_defaultBlockID;
-	m_chunkBlocks = other.m_chunkBlocks;
+	m_lightMap = other.m_lightMap;
+	m_fluidMap = other.m_fluidMap;
 }
 
 Chunk& Chunk::operator=(const Chunk& other)
@@ -420,8 +773,8 @@ Chunk& Chunk::operator=(const Chunk& other)
 	if (&other == this)
 		return *this;
 
+	m_manager = other.m_manager;
 	m_chunkPos = other.m_chunkPos;
-	m_chunkSize = other.m_chunkSize;
 
 	m_mesh = other.m_mesh;
 
@@ -429,16 +782,20 @@ Chunk& Chunk::operator=(const Chunk& other)
 	m_objectRenderer = ChunkRenderer();
 	m_waterRenderer = ChunkRenderer();
 
+	m_lod = other.getLOD();
+
 	m_defaultBlockID = other.m_defaultBlockID;
-	m_chunkBlocks = other.m_chunkBlocks;
+	std::atomic_store(&m_blocks, other.getBlocks());
+	m_lightMap = other.m_lightMap;
+	m_fluidMap = other.m_fluidMap;
 
 	return *this;
 }
 
-Chunk::Chunk(Chunk&& other)
+Chunk::Chunk(Chunk&& other) : m_lod(other.getLOD()), m_blocks(other.getBlocks())
 {
+	m_manager = other.m_manager;
 	m_chunkPos = other.m_chunkPos;
-	m_chunkSize = other.m_chunkSize;
 
 	m_mesh = std::move(other.m_mesh);
 
@@ -449,13 +806,14 @@ Chunk::Chunk(Chunk&& other)
 	m_chunkFlags = NEEDS_MESHING;
 
 	m_defaultBlockID = std::move(other.m_defaultBlockID);
-	m_chunkBlocks = std::move(other.m_chunkBlocks);
+	m_lightMap = std::move(other.m_lightMap);
+	m_fluidMap = std::move(other.m_fluidMap);
 }
 
 Chunk& Chunk::operator=(Chunk&& other)
 {
+	m_manager = other.m_manager;
 	m_chunkPos = other.m_chunkPos;
-	m_chunkSize = other.m_chunkSize;
 
 	m_mesh = std::move(other.m_mesh);
 
@@ -464,173 +822,567 @@ Chunk& Chunk::operator=(Chunk&& other)
 	m_waterRenderer = std::move(other.m_waterRenderer);
 
 	m_chunkFlags = NEEDS_MESHING;
+	m_lod = other.getLOD();
 
 	m_defaultBlockID = std::move(other.m_defaultBlockID);
 
-	m_chunkBlocks = std::move(other.m_chunkBlocks);
+	std::atomic_store(&m_blocks, other.getBlocks());
+	m_lightMap = std::move(other.m_lightMap);
+	m_fluidMap = std::move(other.m_fluidMap);
 
 	return *this;
 }
 
-Chunk::Chunk(qz::Vector3 chunkPos, unsigned int chunkSize, const std::string& defaultBlockID)
+Chunk::Chunk(ChunkManager* manager, const qz::Vector3i& chunkPos, const std::string& defaultBlockID) :
+	m_lod(0), m_blocks(std::make_shared<BlockStorage>(BlockInstance(defaultBlockID)))
 {
+	m_manager = manager;
 	m_chunkPos = chunkPos;
-	m_chunkSize = chunkSize;
 	m_defaultBlockID = defaultBlockID;
 }
 
 void Chunk::populateData(unsigned int seed)
 {
-	std::lock_guard<std::mutex> lock(m_chunkMutex);
+	std::lock_guard<std::mutex> lock(m_writeMutex);
 
-	for (std::size_t i = 0; i < m_chunkSize * m_chunkSize * m_chunkSize; ++i)
-		m_chunkBlocks.emplace_back(m_defaultBlockID);
+	// Generation replaces every block, so there is nothing to copy from the current blocks.
+	auto blocks = std::make_shared<BlockStorage>(BlockInstance(m_defaultBlockID));
 
 	PerlinNoise* terrainGenerator = new PerlinNoise(seed);
-	terrainGenerator->generateFor(m_chunkBlocks, m_chunkPos, m_chunkSize);
+	terrainGenerator->generateFor(*blocks, m_chunkPos);
 	delete terrainGenerator;
 
+	// Generation may have written the same block everywhere, such as a chunk full of stone.
+	blocks->compact();
+
+	publish(std::move(blocks));
+
 	if (!(m_chunkFlags & NEEDS_MESHING))
 		m_chunkFlags |= NEEDS_MESHING;
 }
 
 void Chunk::buildMesh()
 {
-	std::lock_guard<std::mutex> lock(m_chunkMutex);
-
-	m_mesh.resetAll();
-	
-	for (std::size_t i = 0; i < m_chunkSize * m_chunkSize * m_chunkSize; ++i)
-	{
-		BlockInstance& block = m_chunkBlocks[i];
+	std::lock_guard<std::mutex> lock(m_meshMutex);
 
-		if (block.getBlockType() == BlockType::GAS)
-			continue;
-
-		const std::size_t x = i % m_chunkSize;
-		const std::size_t y = (i / m_chunkSize) % m_chunkSize;
-		const std::size_t z = i / (m_chunkSize * m_chunkSize);
+	// Cleared before taking the snapshot, so an edit published while meshing flags the chunk again.
+	m_chunkFlags &= ~NEEDS_MESHING;
 
-		if (x == 0 || m_chunkBlocks[getVectorIndex(x - 1, y, z)].getBlockType() != BlockType::SOLID)
-			m_mesh.add(block, BlockFace::RIGHT, m_chunkPos, { static_cast<float>(x), static_cast<float>(y), static_cast<float>(z) }, this);
-		if (x == m_chunkSize - 1 || m_chunkBlocks[getVectorIndex(x + 1, y, z)].getBlockType() != BlockType::SOLID)
-			m_mesh.add(block, BlockFace::LEFT, m_chunkPos, { static_cast<float>(x), static_cast<float>(y), static_cast<float>(z) }, this);
+	const std::shared_ptr<const BlockStorage> blocks = getBlocks();
 
-		if (y == 0 || m_chunkBlocks[getVectorIndex(x, y - 1, z)].getBlockType() != BlockType::SOLID)
-			m_mesh.add(block, BlockFace::BOTTOM, m_chunkPos, { static_cast<float>(x), static_cast<float>(y), static_cast<float>(z) }, this);
-		if (y == m_chunkSize - 1 || m_chunkBlocks[getVectorIndex(x, y + 1, z)].getBlockType() != BlockType::SOLID)
-			m_mesh.add(block, BlockFace::TOP, m_chunkPos, { static_cast<float>(x), static_cast<float>(y), static_cast<float>(z) }, this);
+	m_mesh.clearAll();
 
-		if (z == 0 || m_chunkBlocks[getVectorIndex(x, y, z - 1)].getBlockType() != BlockType::SOLID)
-			m_mesh.add(block, BlockFace::FRONT, m_chunkPos, { static_cast<float>(x), static_cast<float>(y), static_cast<float>(z) }, this);
-		if (z == m_chunkSize - 1 || m_chunkBlocks[getVectorIndex(x, y, z + 1)].getBlockType() != BlockType::SOLID)
-			m_mesh.add(block, BlockFace::BACK, m_chunkPos, { static_cast<float>(x), static_cast<float>(y), static_cast<float>(z) }, this);
+	// A chunk of nothing but air has nothing to draw, and neither does solid rock with solid rock on every side, so
+	// skip the cache and the scan and just drop the old mesh. Editing a neighbour's border flags this chunk again.
+	if ((blocks->isUniform() && blocks->getUniformBlock().getBlockType() == BlockType::GAS) || isBuried(*blocks))
+	{
+		m_chunkFlags &= ~(BLOCKS_NEED_BUFFERING | BLOCKS_NEED_TEXTURING | WATER_NEEDS_BUFFERING | WATER_NEEDS_TEXTURING);
 
+		m_blockRenderer.resetMesh();
+		m_waterRenderer.resetMesh();
+		return;
 	}
 
+	const int lod = getLOD();
+	if (lod > 0)
+		buildLODMesh(*blocks, lod);
+	else if (blocks->isUniform() && blocks->getUniformBlock().getBlockType() == BlockType::SOLID)
+		buildShellMesh(*blocks);
+	else
+		buildFullMesh(*blocks);
+
 	if (!(m_chunkFlags & BLOCKS_NEED_BUFFERING))
 		m_chunkFlags |= BLOCKS_NEED_BUFFERING;
 
 	if (!(m_chunkFlags & BLOCKS_NEED_TEXTURING))
 		m_chunkFlags |= BLOCKS_NEED_TEXTURING;
 
-	m_chunkFlags &= ~NEEDS_MESHING;
+	m_blockRenderer.updateMesh(m_mesh.takeBlockMesh());
 
-	m_blockRenderer.resetMesh();
-	m_blockRenderer.updateMesh(m_mesh.getBlockMesh());
+	// Most chunks have no water, so only bother the water renderer if there is some now or there was before.
+	Mesh water = m_mesh.takeWaterMesh();
+	if (!water.vertices.empty() || m_waterRenderer.getTrianglesCount() > 0)
+	{
+		m_chunkFlags |= WATER_NEEDS_BUFFERING | WATER_NEEDS_TEXTURING;
+		m_waterRenderer.updateMesh(std::move(water));
+	}
 }
 
-const ChunkMesh& Chunk::getChunkMesh() const
+void Chunk::setLOD(int lod)
 {
-	return m_mesh;
+	lod = std::max(0, std::min(lod, MAX_CHUNK_LOD));
+
+	if (m_lod.exchange(lod) != lod)
+		flagForMeshing();
 }
 
-const Vector3& Chunk::getChunkPos() const
+int Chunk::getLOD() const
 {
-	return m_chunkPos;
+	return m_lod;
 }
 
-void Chunk::breakBlockAt(qz::Vector3 position, const BlockInstance& block)
+void Chunk::buildFullMesh(const BlockStorage& blocks)
 {
-	if (position.x < m_chunkSize)
+	const PaddedSolidCache solidCache(blocks, m_chunkPos, m_manager);
+
+	for (int z = 0; z < CHUNK_SIZE; ++z)
 	{
-		if (position.y < m_chunkSize)
+		for (int y = 0; y < CHUNK_SIZE; ++y)
 		{
-			if (position.z < m_chunkSize)
+			const RowMask filled = solidCache.getFilledRow(y, z);
+			if (filled == 0)
+				continue;
+
+			// Solid rows are padded, so bit x + 1 is the block at x. Shifting a row right by 1 lines it up with this
+			// one, and faces on the border of the chunk are always kept.
+			const RowMask row = solidCache.getSolidRow(y, z);
+
+			std::array<RowMask, NUM_FACES_IN_CUBE> faces;
+			faces[static_cast<int>(BlockFace::RIGHT)]	= filled & (~row | 1u);
+			faces[static_cast<int>(BlockFace::LEFT)]	= filled & (~(row >> 2) | (1u << (CHUNK_SIZE - 1)));
+			faces[static_cast<int>(BlockFace::BOTTOM)]	= filled & (~(solidCache.getSolidRow(y - 1, z) >> 1) | (y == 0 ? FULL_ROW : 0));
+			faces[static_cast<int>(BlockFace::TOP)]		= filled & (~(solidCache.getSolidRow(y + 1, z) >> 1) | (y == CHUNK_SIZE - 1 ? FULL_ROW : 0));
+			faces[static_cast<int>(BlockFace::FRONT)]	= filled & (~(solidCache.getSolidRow(y, z - 1) >> 1) | (z == 0 ? FULL_ROW : 0));
+			faces[static_cast<int>(BlockFace::BACK)]	= filled & (~(solidCache.getSolidRow(y, z + 1) >> 1) | (z == CHUNK_SIZE - 1 ? FULL_ROW : 0));
+
+			RowMask visible = 0;
+			for (RowMask mask : faces)
+				visible |= mask;
+
+			while (visible != 0)
 			{
-				std::unique_lock<std::mutex> lock(m_chunkMutex);
-				
-				BlockInstance& orig = m_chunkBlocks[getVectorIndex(static_cast<int>(position.x), static_cast<int>(position.y), static_cast<int>(position.z))];
+				const int x = countTrailingZeros(visible);
+				visible &= visible - 1;
+
+				const qz::Vector3i pos = { x, y, z };
+				const BlockInstance& block = blocks.get(localToIndex(pos));
+
+				if (isFluid(block.getBlockType()))
+				{
+					unsigned int openFaces = 0;
+					for (int face = 0; face < NUM_FACES_IN_CUBE; ++face)
+						openFaces |= ((faces[face] >> x) & 1u) << face;
 
-				auto& breakCallback = BlockLibrary::get()->requestBlock(orig.getBlockID()).getBreakCallback();
-				if (breakCallback != nullptr)
-					breakCallback();
+					addFluidFaces(blocks, block, pos, openFaces);
+					continue;
+				}
 
-				orig = block;
+				const std::size_t padded = PaddedSolidCache::getIndex(pos);
 
-				if (!(m_chunkFlags & NEEDS_MESHING))
-					m_chunkFlags |= NEEDS_MESHING;
+				for (BlockFace blockFace : MESHING_FACE_ORDER)
+				{
+					const int face = static_cast<int>(blockFace);
+					if (!(faces[face] & (1u << x)))
+						continue;
+
+					m_mesh.add(block, blockFace, m_chunkPos, pos, getFaceLight(pos + FACE_NORMALS[face]), calculateFaceAO(solidCache, padded, blockFace), this);
+				}
 			}
 		}
 	}
 }
 
-void Chunk::placeBlockAt(qz::Vector3 position, const BlockInstance& block)
+void Chunk::buildShellMesh(const BlockStorage& blocks)
 {
-	if (position.x < m_chunkSize)
+	// The ambient occlusion of the shell depends on the blocks in the neighbouring chunks, which the cache gathers.
+	const PaddedSolidCache solidCache(blocks, m_chunkPos, m_manager);
+	const BlockInstance& block = blocks.getUniformBlock();
+
+	// Every block inside the chunk is solid, so only the faces on the border are visible. Blocks are visited in the
+	// same order as buildFullMesh(), so the mesh comes out the same as scanning for them.
+	for (int z = 0; z < CHUNK_SIZE; ++z)
 	{
-		if (position.y < m_chunkSize)
+		for (int y = 0; y < CHUNK_SIZE; ++y)
 		{
-			if (position.z < m_chunkSize)
+			std::array<RowMask, NUM_FACES_IN_CUBE> faces;
+			faces[static_cast<int>(BlockFace::RIGHT)]	= 1u;
+			faces[static_cast<int>(BlockFace::LEFT)]	= 1u << (CHUNK_SIZE - 1);
+			faces[static_cast<int>(BlockFace::BOTTOM)]	= y == 0 ? FULL_ROW : 0;
+			faces[static_cast<int>(BlockFace::TOP)]		= y == CHUNK_SIZE - 1 ? FULL_ROW : 0;
+			faces[static_cast<int>(BlockFace::FRONT)]	= z == 0 ? FULL_ROW : 0;
+			faces[static_cast<int>(BlockFace::BACK)]	= z == CHUNK_SIZE - 1 ? FULL_ROW : 0;
+
+			RowMask visible = 0;
+			for (RowMask mask : faces)
+				visible |= mask;
+
+			while (visible != 0)
 			{
-				std::unique_lock<std::mutex> lock(m_chunkMutex);
+				const int x = countTrailingZeros(visible);
+				visible &= visible - 1;
 
-				auto& placeCallback = BlockLibrary::get()->requestBlock(block.getBlockID()).getPlaceCallback();
-				if (placeCallback != nullptr)
-					placeCallback();
+				const qz::Vector3i pos = { x, y, z };
+				const std::size_t padded = PaddedSolidCache::getIndex(pos);
 
-				m_chunkBlocks[getVectorIndex(static_cast<int>(position.x), static_cast<int>(position.y), static_cast<int>(position.z))] = block;
+				for (BlockFace blockFace : MESHING_FACE_ORDER)
+				{
+					const int face = static_cast<int>(blockFace);
+					if (!(faces[face] & (1u << x)))
+						continue;
 
-				if (!(m_chunkFlags & NEEDS_MESHING))
-					m_chunkFlags |= NEEDS_MESHING;
+					m_mesh.add(block, blockFace, m_chunkPos, pos, getFaceLight(pos + FACE_NORMALS[face]), calculateFaceAO(solidCache, padded, blockFace), this);
+				}
 			}
 		}
 	}
 }
 
-BlockInstance Chunk::getBlockAt(qz::Vector3 position) const
+bool Chunk::isBuried(const BlockStorage& blocks) const
 {
-	if (position.x < m_chunkSize)
+	if (!blocks.isUniform() || blocks.getUniformBlock().getBlockType() != BlockType::SOLID)
+		return false;
+
+	for (const Vector3i& normal : FACE_NORMALS)
 	{
-		if (position.y < m_chunkSize)
+		const Chunk* neighbour = m_manager->getChunk(m_chunkPos + normal);
+		if (neighbour == nullptr)
+			return false;
+
+		const std::shared_ptr<const BlockStorage> neighbourBlocks = neighbour->getBlocks();
+		if (!neighbourBlocks->isUniform() || neighbourBlocks->getUniformBlock().getBlockType() != BlockType::SOLID)
+			return false;
+	}
+
+	return true;
+}
+
+void Chunk::buildLODMesh(const BlockStorage& blocks, int lod)
+{
+	const int cellSize = 1 << lod;
+	const int cells = CHUNK_SIZE >> lod;
+	const int cellVolume = cellSize * cellSize * cellSize;
+
+	const auto cellIndex = [cells](const qz::Vector3i& cell)
+	{
+		return static_cast<std::size_t>(cell.x + cells * (cell.y + cells * cell.z));
+	};
+
+	// Each cell of the coarse grid stands in for a cube of blocks. It is filled if at least half of them are solid, so
+	// terrain keeps roughly its height, and it shows the topmost of them so grass stays on top.
+	std::array<const BlockInstance*, LOD_GRID_VOLUME> grid;
+
+	for (int cz = 0; cz < cells; ++cz)
+	{
+		for (int cy = 0; cy < cells; ++cy)
 		{
-			if (position.z < m_chunkSize)
+			for (int cx = 0; cx < cells; ++cx)
 			{
-				return m_chunkBlocks[getVectorIndex(static_cast<int>(position.x), static_cast<int>(position.y), static_cast<int>(position.z))];
+				const qz::Vector3i cell = { cx, cy, cz };
+				const qz::Vector3i origin = cell * cellSize;
+
+				const BlockInstance* top = nullptr;
+				int solid = 0;
+
+				for (int y = cellSize - 1; y >= 0; --y)
+				{
+					for (int z = 0; z < cellSize; ++z)
+					{
+						for (int x = 0; x < cellSize; ++x)
+						{
+							const BlockInstance& block = blocks.get(localToIndex(origin + qz::Vector3i(x, y, z)));
+							if (block.getBlockType() != BlockType::SOLID)
+								continue;
+
+							if (top == nullptr)
+								top = &block;
+
+							++solid;
+						}
+					}
+				}
+
+				grid[cellIndex(cell)] = (solid * 2 >= cellVolume) ? top : nullptr;
 			}
 		}
 	}
 
-	return BlockInstance("core:out_of_bounds");
+	const auto isFilled = [&](const qz::Vector3i& cell)
+	{
+		return cell.x >= 0 && cell.y >= 0 && cell.z >= 0 && cell.x < cells && cell.y < cells && cell.z < cells &&
+			grid[cellIndex(cell)] != nullptr;
+	};
+
+	// Light is taken from the middle of a face, just outside the cell, one axis at a time.
+	const auto lightSample = [cellSize](int origin, int normal)
+	{
+		return normal > 0 ? origin + cellSize : normal < 0 ? origin - 1 : origin + cellSize / 2;
+	};
+
+	for (int cz = 0; cz < cells; ++cz)
+	{
+		for (int cy = 0; cy < cells; ++cy)
+		{
+			for (int cx = 0; cx < cells; ++cx)
+			{
+				const qz::Vector3i cell = { cx, cy, cz };
+
+				const BlockInstance* block = grid[cellIndex(cell)];
+				if (block == nullptr)
+					continue;
+
+				const qz::Vector3i origin = cell * cellSize;
+
+				for (BlockFace blockFace : MESHING_FACE_ORDER)
+				{
+					const qz::Vector3i& normal = FACE_NORMALS[static_cast<int>(blockFace)];
+
+					// Faces on the border of the chunk are always kept, as they are at full detail. They double as
+					// skirts where neighbouring chunks are at different levels of detail: the two surfaces don't line
+					// up along the border, and the walls on either side of it cover the gap between them.
+					if (isFilled(cell + normal))
+						continue;
+
+					const qz::Vector3i lightPos = { lightSample(origin.x, normal.x), lightSample(origin.y, normal.y), lightSample(origin.z, normal.z) };
+
+					m_mesh.add(*block, blockFace, m_chunkPos, origin, getFaceLight(lightPos), LOD_FACE_AO, this, cellSize);
+				}
+			}
+		}
+	}
+}
+
+void Chunk::addFluidFaces(const BlockStorage& blocks, const BlockInstance& block, const qz::Vector3i& pos, unsigned int openFaces)
+{
+	const auto blockIDAt = [&](const qz::Vector3i& local) -> std::string
+	{
+		if (isLocalInBounds(local))
+			return blocks.get(localToIndex(local)).getBlockID();
+
+		return m_manager->getBlockAt(chunkToWorld(m_chunkPos) + local).getBlockID();
+	};
+
+	// Fluid with more of the same fluid on top is full, otherwise it is as full as its level.
+	float height = 1.f;
+	if (blockIDAt(pos + FACE_NORMALS[static_cast<int>(BlockFace::TOP)]) != block.getBlockID())
+	{
+		const int level = m_fluidMap.getLevel(localToIndex(pos));
+
+		// Fluid that hasn't been simulated yet is a source, and sources are as full as fluid gets.
+		height = static_cast<float>(level == 0 ? FluidMap::MAX_LEVEL : level) / (FluidMap::MAX_LEVEL + 1);
+	}
+
+	for (BlockFace blockFace : MESHING_FACE_ORDER)
+	{
+		const int face = static_cast<int>(blockFace);
+		if (!(openFaces & (1u << face)))
+			continue;
+
+		// Faces between two blocks of the same fluid are inside it.
+		const qz::Vector3i neighbour = pos + FACE_NORMALS[face];
+		if (blockIDAt(neighbour) == block.getBlockID())
+			continue;
+
+		m_mesh.addFluid(block, blockFace, m_chunkPos, pos, getFaceLight(neighbour), height, this);
+	}
+}
+
+std::uint8_t Chunk::getFaceLight(const qz::Vector3i& neighbour) const
+{
+	if (isLocalInBounds(neighbour))
+		return m_lightMap.getPacked(localToIndex(neighbour));
+
+	return m_manager->getLightAt(chunkToWorld(m_chunkPos) + neighbour);
+}
+
+const ChunkMesh& Chunk::getChunkMesh() const
+{
+	return m_mesh;
+}
+
+const Vector3i& Chunk::getChunkPos() const
+{
+	return m_chunkPos;
+}
+
+bool Chunk::isUniform() const
+{
+	return getBlocks()->isUniform();
+}
+
+bool Chunk::isEmpty() const
+{
+	const std::shared_ptr<const BlockStorage> blocks = getBlocks();
+	return blocks->isUniform() && blocks->getUniformBlock().getBlockType() == BlockType::GAS;
+}
+
+std::shared_ptr<const BlockStorage> Chunk::getBlocks() const
+{
+	return std::atomic_load(&m_blocks);
+}
+
+std::shared_ptr<BlockStorage> Chunk::beginWrite() const
+{
+	// Only writers replace m_blocks and they hold m_writeMutex, so this copy is of the latest version. Copying only
+	// shares the sections, the edit copies the ones it writes to.
+	return std::make_shared<BlockStorage>(*m_blocks);
+}
+
+void Chunk::publish(std::shared_ptr<BlockStorage> blocks)
+{
+	std::atomic_store(&m_blocks, std::shared_ptr<const BlockStorage>(std::move(blocks)));
+
+	// Flagged after publishing, so the mesher is guaranteed to see the new blocks.
+	if (!(m_chunkFlags & NEEDS_MESHING))
+		m_chunkFlags |= NEEDS_MESHING;
+}
+
+void Chunk::breakBlockAt(const qz::Vector3i& position, const BlockInstance& block)
+{
+	if (!isLocalInBounds(position))
+		return;
+
+	EditCallbacks callbacks;
+
+	{
+		std::unique_lock<std::mutex> lock(m_writeMutex);
+
+		auto blocks = beginWrite();
+		applyEdit(*blocks, localToIndex(position), block, BlockEditType::BREAK, callbacks);
+
+		publish(std::move(blocks));
+	}
+
+	// Fired once the chunk is unlocked, so the callback can edit the world.
+	callbacks.fire();
+}
+
+void Chunk::placeBlockAt(const qz::Vector3i& position, const BlockInstance& block)
+{
+	if (!isLocalInBounds(position))
+		return;
+
+	EditCallbacks callbacks;
+
+	{
+		std::unique_lock<std::mutex> lock(m_writeMutex);
+
+		auto blocks = beginWrite();
+		applyEdit(*blocks, localToIndex(position), block, BlockEditType::PLACE, callbacks);
+
+		publish(std::move(blocks));
+	}
+
+	callbacks.fire();
+}
+
+BlockInstance Chunk::getBlockAt(const qz::Vector3i& position) const
+{
+	if (!isLocalInBounds(position))
+		return BlockInstance("core:out_of_bounds");
+
+	return getBlocks()->get(localToIndex(position));
+}
+
+BlockType Chunk::getBlockTypeAt(const qz::Vector3i& position) const
+{
+	if (!isLocalInBounds(position))
+		return BlockType::GAS;
+
+	return getBlocks()->get(localToIndex(position)).getBlockType();
 }
 
-void Chunk::setBlockAt(qz::Vector3 position, const BlockInstance& newBlock)
+int Chunk::getLightEmissionAt(const qz::Vector3i& position) const
 {
-	if (position.x < m_chunkSize)
+	if (!isLocalInBounds(position))
+		return 0;
+
+	return getBlocks()->get(localToIndex(position)).getLightEmission();
+}
+
+void Chunk::setBlockAt(const qz::Vector3i& position, const BlockInstance& newBlock)
+{
+	if (!isLocalInBounds(position))
+		return;
+
+	std::unique_lock<std::mutex> lock(m_writeMutex);
+
+	auto blocks = beginWrite();
+	blocks->set(localToIndex(position), newBlock);
+
+	publish(std::move(blocks));
+}
+
+void Chunk::applyEdits(const std::vector<const BlockEdit*>& edits)
+{
+	if (edits.empty())
+		return;
+
+	EditCallbacks callbacks;
+
+	{
+		std::unique_lock<std::mutex> lock(m_writeMutex);
+
+		auto blocks = beginWrite();
+
+		for (const BlockEdit* edit : edits)
+			applyEdit(*blocks, localToIndex(worldToLocal(edit->position)), edit->block, edit->type, callbacks);
+
+		publish(std::move(blocks));
+	}
+
+	callbacks.fire();
+}
+
+void Chunk::fillRegion(const qz::Vector3i& min, const qz::Vector3i& max, const BlockInstance& block, BlockEditType type)
+{
+	if (!isLocalInBounds(min) || !isLocalInBounds(max))
+		return;
+
+	EditCallbacks callbacks;
+
 	{
-		if (position.y < m_chunkSize)
+		std::unique_lock<std::mutex> lock(m_writeMutex);
+
+		const bool wholeChunk = min == Vector3i(0, 0, 0) && max == Vector3i(CHUNK_SIZE_MASK, CHUNK_SIZE_MASK, CHUNK_SIZE_MASK);
+
+		// Setting every block in the chunk needs no callbacks, so the chunk can just become uniform.
+		if (wholeChunk && type == BlockEditType::SET)
 		{
-			if (position.z < m_chunkSize)
-			{
-				std::unique_lock<std::mutex> lock(m_chunkMutex);
+			publish(std::make_shared<BlockStorage>(block));
+			return;
+		}
 
-				m_chunkBlocks[getVectorIndex(static_cast<int>(position.x), static_cast<int>(position.y), static_cast<int>(position.z))] = newBlock;
+		auto blocks = beginWrite();
 
-				if (!(m_chunkFlags & NEEDS_MESHING))
-					m_chunkFlags |= NEEDS_MESHING;
+		for (int z = min.z; z <= max.z; ++z)
+		{
+			for (int y = min.y; y <= max.y; ++y)
+			{
+				for (int x = min.x; x <= max.x; ++x)
+					applyEdit(*blocks, localToIndex({ x, y, z }), block, type, callbacks);
 			}
 		}
+
+		publish(std::move(blocks));
 	}
+
+	callbacks.fire();
+}
+
+LightMap& Chunk::getLightMap()
+{
+	return m_lightMap;
+}
+
+const LightMap& Chunk::getLightMap() const
+{
+	return m_lightMap;
+}
+
+FluidMap& Chunk::getFluidMap()
+{
+	return m_fluidMap;
+}
+
+const FluidMap& Chunk::getFluidMap() const
+{
+	return m_fluidMap;
+}
+
+void Chunk::flagForMeshing()
+{
+	if (!(m_chunkFlags & NEEDS_MESHING))
+		m_chunkFlags |= NEEDS_MESHING;
 }
 
 ChunkRenderer& Chunk::getBlockRenderer()
@@ -682,7 +1434,6 @@ void Chunk::renderBlocks(int* counter)
 			return;
 
 		buildMesh();
-		m_chunkFlags &= ~NEEDS_MESHING;
 	}
 }
 
@@ -693,6 +1444,29 @@ void Chunk::renderObjects(int* counter)
 
 void Chunk::renderWater(int* counter)
 {
-	// TODO: Write function for rendering water. (TO BE DONE ONCE WE ACTUALLY HAVE WATER)
+	// Water is meshed along with the blocks, in renderBlocks(), this only uploads and draws it.
+	if (m_chunkFlags & WATER_NEEDS_BUFFERING)
+	{
+		if (*counter > 0)
+			(*counter)--;
+		else
+			return;
+
+		m_waterRenderer.bufferData();
+		m_chunkFlags &= ~WATER_NEEDS_BUFFERING;
+	}
+
+	if (m_chunkFlags & WATER_NEEDS_TEXTURING)
+	{
+		if (*counter > 0)
+			(*counter)--;
+		else
+			return;
+
+		m_waterRenderer.loadTextures();
+		m_chunkFlags &= ~WATER_NEEDS_TEXTURING;
+	}
+
+	m_waterRenderer.render();
 }
 
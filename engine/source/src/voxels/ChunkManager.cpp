@@ -25,15 +25,37 @@
 #include <quartz/voxels/ChunkManager.hpp>
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
 #include <utility>
 
 using namespace qz::voxels;
 
-const int VIEW_DISTANCE = 16; // 96 blocks, 6 chunks.
+// In chunks, both can be changed with setViewDistance(). Terrain is only a chunk tall, so looking further up or down
+// would only load air.
+const int VIEW_DISTANCE = 16;
+const int VERTICAL_VIEW_DISTANCE = 1;
 
-ChunkManager::ChunkManager(const std::string& blockID, int chunkSize, unsigned int seed) :
-	m_seed(seed), m_chunkSize(chunkSize),
-	m_defaultBlockID(blockID)
+// Levels 1, 2 and 3 start 4, 8 and 12 chunks away from the camera, so all of them are used within the view distance.
+const std::array<int, MAX_CHUNK_LOD> LOD_DISTANCES = { 4, 8, 12 };
+
+// How many chunks determineGeneration() generates at most each time it's called, nearest first. Without a limit,
+// the first frame would generate the whole view distance at once.
+const std::size_t CHUNK_GENERATION_BUDGET = 4;
+
+// How far past the view distance a chunk must be before it's unloaded, in chunks.
+const int UNLOAD_HYSTERESIS = 2;
+
+// How far past the distance a level starts at a chunk must be before it switches, in chunks. Without it, chunks on
+// the boundary would be meshed again and again as the camera moves back and forth across it.
+const int LOD_HYSTERESIS = 1;
+
+ChunkManager::ChunkManager(const std::string& blockID, unsigned int seed) :
+	m_seed(seed), m_defaultBlockID(blockID),
+	m_lightEngine(this), m_fluidEngine(this, blockID, m_threadPool), m_blockUpdates(this, m_threadPool),
+	m_physics(this, m_entities.getRegistry(), m_threadPool),
+	m_viewDistance(VIEW_DISTANCE), m_verticalViewDistance(VERTICAL_VIEW_DISTANCE),
+	m_lodDistances(LOD_DISTANCES)
 {}
 
 void ChunkManager::toggleWireframe()
@@ -52,261 +74,464 @@ void ChunkManager::determineGeneration(qz::Vector3 cameraPosition)
 	cameraPosition = cameraPosition / 2.f;
 	cameraPosition += 0.5f;
 
-	const int posX = static_cast<int>(cameraPosition.x) / m_chunkSize;
-	const int posY = static_cast<int>(cameraPosition.y) / m_chunkSize;
-	const int posZ = static_cast<int>(cameraPosition.z) / m_chunkSize;
+	const qz::Vector3i cameraChunk = worldToChunk(worldToBlock(cameraPosition));
 
-	// Get diameter to generate for.
-	const int chunkViewDistance = VIEW_DISTANCE / m_chunkSize;
+	if (cameraChunk != m_cameraChunk)
+	{
+		m_cameraChunk = cameraChunk;
+		m_lodNeedsUpdate = true;
 
-	for (int x = -chunkViewDistance; x <= chunkViewDistance; x++)
+		unloadRedundant();
+	}
+
+	// The chunks in view that still need generating, and how far they are from the camera.
+	std::vector<std::pair<int, qz::Vector3i>> missing;
+
+	for (int x = -m_viewDistance; x <= m_viewDistance; x++)
 	{
-		for (int y = -chunkViewDistance; y <= chunkViewDistance; y++)
+		for (int y = -m_verticalViewDistance; y <= m_verticalViewDistance; y++)
 		{
-			for (int z = -chunkViewDistance; z <= chunkViewDistance; z++)
+			for (int z = -m_viewDistance; z <= m_viewDistance; z++)
 			{
-				qz::Vector3 chunkToCheck = {
-					static_cast<float>(x) * chunkViewDistance + posX,
-					static_cast<float>(y) * chunkViewDistance + posY,
-					static_cast<float>(z) * chunkViewDistance + posZ
-				};
+				const qz::Vector3i chunkToCheck = cameraChunk + qz::Vector3i(x, y, z);
 
-				chunkToCheck = chunkToCheck * static_cast<float>(m_chunkSize);
-
-				auto result = std::find_if(m_chunks.begin(), m_chunks.end(),
-					[chunkToCheck](const Chunk& o) -> bool
-					{
-						return o.getChunkPos() == chunkToCheck;
-					});
-
-				if (result == m_chunks.end())
-				{
-					m_chunks.emplace_back(chunkToCheck, m_chunkSize, m_defaultBlockID);
-					m_chunks.back().populateData(m_seed);
-				}
+				if (m_chunks.find(chunkKey(chunkToCheck)) == m_chunks.end())
+					missing.emplace_back(std::max({ std::abs(x), std::abs(y), std::abs(z) }), chunkToCheck);
 			}
 		}
 	}
-}
 
-void ChunkManager::testGeneration()
-{
-	for (int i = 0; i < 5; ++i)
+	const std::size_t count = std::min(missing.size(), CHUNK_GENERATION_BUDGET);
+	std::partial_sort(missing.begin(), missing.begin() + count, missing.end(),
+		[](const std::pair<int, qz::Vector3i>& a, const std::pair<int, qz::Vector3i>& b) { return a.first < b.first; });
+
+	for (std::size_t i = 0; i < count; ++i)
 	{
-		qz::Vector3 pain = { i * 16.f, 0, 0 };
+		const qz::Vector3i& chunkPos = missing[i].second;
 
-		m_chunks.emplace_back(pain, m_chunkSize, m_defaultBlockID);
-		m_chunks.back().populateData(m_seed);
+		std::unique_ptr<Chunk>& chunk = m_chunks[chunkKey(chunkPos)];
+		chunk = std::make_unique<Chunk>(this, chunkPos, m_defaultBlockID);
+		chunk->setLOD(getLODForDistance(missing[i].first));
+		chunk->populateData(m_seed);
+
+		m_lightEngine.lightChunk(chunk.get());
+		m_fluidEngine.wakeChunk(chunk.get());
 	}
+
+	// Levels of detail only change as the camera crosses into another chunk.
+	if (m_lodNeedsUpdate)
+		updateLOD();
 }
 
-void ChunkManager::unloadRedundant()
+void ChunkManager::update(float dt)
 {
-	// TODO this.
+	m_fluidEngine.update(dt);
+	m_blockUpdates.update(dt);
+	m_physics.update(dt);
+	m_entities.update(dt);
 }
 
-void ChunkManager::setBlockAt(qz::Vector3 position, const BlockInstance& block)
+qz::entities::EntityWorld& ChunkManager::getEntities()
 {
-	int posX = static_cast<int>(position.x / m_chunkSize);
-	int posY = static_cast<int>(position.y / m_chunkSize);
-	int posZ = static_cast<int>(position.z / m_chunkSize);
+	return m_entities;
+}
 
-	position.x = static_cast<float>(static_cast<int>(position.x) % m_chunkSize);
-	if (position.x < 0)
-	{
-		posX -= 1;
-		position.x += m_chunkSize;
-	}
+const qz::entities::EntityWorld& ChunkManager::getEntities() const
+{
+	return m_entities;
+}
 
-	position.y = static_cast<float>(static_cast<int>(position.y) % m_chunkSize);
-	if (position.y < 0)
-	{
-		posY -= 1;
-		position.y += m_chunkSize;
-	}
+PhysicsSystem& ChunkManager::getPhysics()
+{
+	return m_physics;
+}
 
-	position.z = static_cast<float>(static_cast<int>(position.z) % m_chunkSize);
-	if (position.z < 0)
-	{
-		posZ -= 1;
-		position.z += m_chunkSize;
-	}
+const PhysicsSystem& ChunkManager::getPhysics() const
+{
+	return m_physics;
+}
 
-	const qz::Vector3 chunkPosition = qz::Vector3(static_cast<float>(posX * m_chunkSize),
-		static_cast<float>(posY * m_chunkSize),
-		static_cast<float>(posZ * m_chunkSize));
+void ChunkManager::scheduleBlockUpdate(const qz::Vector3i& position, unsigned int delay)
+{
+	m_blockUpdates.schedule(position, delay);
+}
 
+void ChunkManager::forEachChunk(const std::function<void(Chunk*)>& function)
+{
 	for (auto& chunk : m_chunks)
-	{
-		if (chunk.getChunkPos() == chunkPosition)
-		{
-			chunk.setBlockAt(
-				{ // "INLINE" VECTOR 3 DECLARATION
-				position.x, // x position IN the chunk, not overall 
-				position.y, // y position IN the chunk, not overall 
-				position.z  // z position IN the chunk, not overall 
-				},
-				block
-			);
+		function(chunk.second.get());
+}
 
-			break;
-		}
-	}
+void ChunkManager::setViewDistance(int horizontal, int vertical)
+{
+	m_viewDistance = std::max(horizontal, 0);
+	m_verticalViewDistance = std::max(vertical, 0);
+
+	unloadRedundant();
 }
 
-BlockInstance ChunkManager::getBlockAt(qz::Vector3 position) const
+int ChunkManager::getViewDistance() const
 {
-	int posX = static_cast<int>(position.x / m_chunkSize);
-	int posY = static_cast<int>(position.y / m_chunkSize);
-	int posZ = static_cast<int>(position.z / m_chunkSize);
+	return m_viewDistance;
+}
 
-	position.x = static_cast<float>(static_cast<int>(position.x) % m_chunkSize);
-	if (position.x < 0)
-	{
-		posX -= 1;
-		position.x += m_chunkSize;
-	}
+int ChunkManager::getVerticalViewDistance() const
+{
+	return m_verticalViewDistance;
+}
 
-	position.y = static_cast<float>(static_cast<int>(position.y) % m_chunkSize);
-	if (position.y < 0)
+void ChunkManager::setLODDistances(const std::array<int, MAX_CHUNK_LOD>& distances)
+{
+	m_lodDistances = distances;
+	m_lodNeedsUpdate = true;
+}
+
+int ChunkManager::getLODForDistance(int distance) const
+{
+	int lod = 0;
+	while (lod < MAX_CHUNK_LOD && distance >= m_lodDistances[lod])
+		++lod;
+
+	return lod;
+}
+
+void ChunkManager::updateLOD()
+{
+	m_lodNeedsUpdate = false;
+
+	for (auto& entry : m_chunks)
 	{
-		posY -= 1;
-		position.y += m_chunkSize;
+		Chunk* chunk = entry.second.get();
+
+		const qz::Vector3i offset = chunk->getChunkPos() - m_cameraChunk;
+		const int distance = std::max({ std::abs(offset.x), std::abs(offset.y), std::abs(offset.z) });
+
+		// A chunk only switches once it is LOD_HYSTERESIS chunks past where the new level starts, in either
+		// direction, so the levels it would pick from a little closer and a little further must agree.
+		const int current = chunk->getLOD();
+		const int coarser = getLODForDistance(distance - LOD_HYSTERESIS);
+		const int finer = getLODForDistance(distance + LOD_HYSTERESIS);
+
+		if (coarser > current)
+			chunk->setLOD(coarser);
+		else if (finer < current)
+			chunk->setLOD(finer);
 	}
+}
 
-	position.z = static_cast<float>(static_cast<int>(position.z) % m_chunkSize);
-	if (position.z < 0)
+void ChunkManager::testGeneration()
+{
+	for (int i = 0; i < 5; ++i)
 	{
-		posZ -= 1;
-		position.z += m_chunkSize;
+		const qz::Vector3i pain = { i, 0, 0 };
+
+		std::unique_ptr<Chunk>& chunk = m_chunks[chunkKey(pain)];
+		chunk = std::make_unique<Chunk>(this, pain, m_defaultBlockID);
+		chunk->populateData(m_seed);
+
+		m_lightEngine.lightChunk(chunk.get());
+		m_fluidEngine.wakeChunk(chunk.get());
 	}
+}
 
-	const qz::Vector3 chunkPosition = qz::Vector3(static_cast<float>(posX * m_chunkSize),
-		static_cast<float>(posY * m_chunkSize),
-		static_cast<float>(posZ * m_chunkSize));
+void ChunkManager::unloadRedundant()
+{
+	const int horizontal = m_viewDistance + UNLOAD_HYSTERESIS;
+	const int vertical = m_verticalViewDistance + UNLOAD_HYSTERESIS;
 
-	for (auto& chunk : m_chunks)
+	for (auto it = m_chunks.begin(); it != m_chunks.end();)
 	{
-		if (chunk.getChunkPos() == chunkPosition)
+		Chunk* chunk = it->second.get();
+		const qz::Vector3i offset = chunk->getChunkPos() - m_cameraChunk;
+
+		if (std::abs(offset.x) <= horizontal && std::abs(offset.z) <= horizontal && std::abs(offset.y) <= vertical)
 		{
-			return chunk.getBlockAt(
-				{ // "INLINE" VECTOR 3 DECLARATION
-				position.x, // x position IN the chunk, not overall 
-				position.y, // y position IN the chunk, not overall 
-				position.z  // z position IN the chunk, not overall 
-				}
-			);
+			++it;
+			continue;
 		}
+
+		m_lightEngine.unloadChunk(chunk);
+		m_fluidEngine.unloadChunk(chunk->getChunkPos());
+		m_blockUpdates.unloadChunk(chunk->getChunkPos());
+
+		it = m_chunks.erase(it);
 	}
+}
+
+std::size_t ChunkManager::getChunkCount() const
+{
+	return m_chunks.size();
+}
+
+Chunk* ChunkManager::getChunk(const qz::Vector3i& chunkPos)
+{
+	const auto it = m_chunks.find(chunkKey(chunkPos));
+	return it == m_chunks.end() ? nullptr : it->second.get();
+}
+
+const Chunk* ChunkManager::getChunk(const qz::Vector3i& chunkPos) const
+{
+	const auto it = m_chunks.find(chunkKey(chunkPos));
+	return it == m_chunks.end() ? nullptr : it->second.get();
+}
+
+void ChunkManager::setBlockAt(const qz::Vector3i& position, const BlockInstance& block)
+{
+	Chunk* chunk = getChunk(worldToChunk(position));
+	if (chunk == nullptr)
+		return;
+
+	chunk->setBlockAt(worldToLocal(position), block);
+
+	m_lightEngine.queueBlockChange(position);
+	m_lightEngine.propagate();
+
+	m_fluidEngine.queueBlockChange(position);
+}
+
+int ChunkManager::getFluidLevelAt(const qz::Vector3i& position) const
+{
+	const Chunk* chunk = getChunk(worldToChunk(position));
+	if (chunk != nullptr)
+		return chunk->getFluidMap().getLevel(localToIndex(worldToLocal(position)));
+
+	return 0;
+}
+
+std::uint8_t ChunkManager::getLightAt(const qz::Vector3i& position) const
+{
+	const Chunk* chunk = getChunk(worldToChunk(position));
+	if (chunk != nullptr)
+		return chunk->getLightMap().getPacked(localToIndex(worldToLocal(position)));
+
+	return LightMap::MAX_LIGHT << 4;
+}
+
+BlockInstance ChunkManager::getBlockAt(const qz::Vector3i& position) const
+{
+	const Chunk* chunk = getChunk(worldToChunk(position));
+	if (chunk != nullptr)
+		return chunk->getBlockAt(worldToLocal(position));
 
 	return BlockInstance("core:out_of_bounds");
 }
 
-void ChunkManager::breakBlockAt(qz::Vector3 position, const BlockInstance& block)
+void ChunkManager::breakBlockAt(const qz::Vector3i& position, const BlockInstance& block)
 {
-	int posX = static_cast<int>(position.x / m_chunkSize);
-	int posY = static_cast<int>(position.y / m_chunkSize);
-	int posZ = static_cast<int>(position.z / m_chunkSize);
+	Chunk* chunk = getChunk(worldToChunk(position));
+	if (chunk == nullptr)
+		return;
 
-	position.x = static_cast<float>(static_cast<int>(position.x) % m_chunkSize);
-	if (position.x < 0)
-	{
-		posX -= 1;
-		position.x += m_chunkSize;
-	}
+	chunk->breakBlockAt(worldToLocal(position), block);
 
-	position.y = static_cast<float>(static_cast<int>(position.y) % m_chunkSize);
-	if (position.y < 0)
+	m_lightEngine.queueBlockChange(position);
+	m_lightEngine.propagate();
+
+	m_fluidEngine.queueBlockChange(position);
+}
+
+void ChunkManager::placeBlockAt(const qz::Vector3i& position, const BlockInstance& block)
+{
+	Chunk* chunk = getChunk(worldToChunk(position));
+	if (chunk == nullptr)
+		return;
+
+	chunk->placeBlockAt(worldToLocal(position), block);
+
+	m_lightEngine.queueBlockChange(position);
+	m_lightEngine.propagate();
+
+	m_fluidEngine.queueBlockChange(position);
+}
+
+void ChunkManager::applyEdits(const std::vector<BlockEdit>& edits)
+{
+	std::unordered_map<std::uint64_t, std::vector<const BlockEdit*>> editsByChunk;
+
+	// Edits are usually spatially coherent, so remember the last group to skip most of the hashing.
+	std::uint64_t lastKey = 0;
+	std::vector<const BlockEdit*>* lastGroup = nullptr;
+
+	for (const BlockEdit& edit : edits)
 	{
-		posY -= 1;
-		position.y += m_chunkSize;
+		const std::uint64_t key = chunkKey(worldToChunk(edit.position));
+
+		if (lastGroup == nullptr || key != lastKey)
+		{
+			lastKey = key;
+			lastGroup = &editsByChunk[key];
+		}
+
+		lastGroup->push_back(&edit);
 	}
 
-	position.z = static_cast<float>(static_cast<int>(position.z) % m_chunkSize);
-	if (position.z < 0)
+	for (auto& group : editsByChunk)
 	{
-		posZ -= 1;
-		position.z += m_chunkSize;
+		const auto chunk = m_chunks.find(group.first);
+		if (chunk == m_chunks.end())
+			continue;
+
+		chunk->second->applyEdits(group.second);
+
+		for (const BlockEdit* edit : group.second)
+		{
+			m_lightEngine.queueBlockChange(edit->position);
+			m_fluidEngine.queueBlockChange(edit->position);
+		}
 	}
 
-	const qz::Vector3 chunkPosition = qz::Vector3(static_cast<float>(posX * m_chunkSize),
-		static_cast<float>(posY * m_chunkSize),
-		static_cast<float>(posZ * m_chunkSize));
+	m_lightEngine.propagate();
+}
+
+void ChunkManager::fillRegion(const qz::Vector3i& min, const qz::Vector3i& max, const BlockInstance& block, BlockEditType type)
+{
+	const qz::Vector3i minChunk = worldToChunk(min);
+	const qz::Vector3i maxChunk = worldToChunk(max);
 
-	for (auto& chunk : m_chunks)
+	for (int x = minChunk.x; x <= maxChunk.x; ++x)
 	{
-		if (chunk.getChunkPos() == chunkPosition)
+		for (int y = minChunk.y; y <= maxChunk.y; ++y)
 		{
-			chunk.breakBlockAt(
-				{ // "INLINE" VECTOR 3 DECLARATION
-				position.x, // x position IN the chunk, not overall 
-				position.y, // y position IN the chunk, not overall 
-				position.z  // z position IN the chunk, not overall 
-				},
-				block
-			);
+			for (int z = minChunk.z; z <= maxChunk.z; ++z)
+			{
+				Chunk* chunk = getChunk({ x, y, z });
+				if (chunk == nullptr)
+					continue;
+
+				// Clamp the box to this chunk, then move it into the chunks local space.
+				const qz::Vector3i origin = chunkToWorld({ x, y, z });
+				const qz::Vector3i last = origin + qz::Vector3i(CHUNK_SIZE - 1);
+
+				const qz::Vector3i localMin = {
+					std::max(min.x, origin.x) - origin.x,
+					std::max(min.y, origin.y) - origin.y,
+					std::max(min.z, origin.z) - origin.z
+				};
 
-			break;
+				const qz::Vector3i localMax = {
+					std::min(max.x, last.x) - origin.x,
+					std::min(max.y, last.y) - origin.y,
+					std::min(max.z, last.z) - origin.z
+				};
+
+				chunk->fillRegion(localMin, localMax, block, type);
+
+				for (int lz = localMin.z; lz <= localMax.z; ++lz)
+				{
+					for (int ly = localMin.y; ly <= localMax.y; ++ly)
+					{
+						for (int lx = localMin.x; lx <= localMax.x; ++lx)
+						{
+							m_lightEngine.queueBlockChange(origin + qz::Vector3i(lx, ly, lz));
+							m_fluidEngine.queueBlockChange(origin + qz::Vector3i(lx, ly, lz));
+						}
+					}
+				}
+			}
 		}
 	}
+
+	m_lightEngine.propagate();
 }
 
-void ChunkManager::placeBlockAt(qz::Vector3 position, const BlockInstance& block)
+bool ChunkManager::raycast(const math::Ray& ray, float maxDistance, RaycastHit& hit) const
 {
-	int posX = static_cast<int>(position.x / m_chunkSize);
-	int posY = static_cast<int>(position.y / m_chunkSize);
-	int posZ = static_cast<int>(position.z / m_chunkSize);
+	const qz::Vector3 origin = ray.getStart();
+	const qz::Vector3 direction = qz::Vector3::normalize(ray.getDirection());
 
-	position.x = static_cast<float>(static_cast<int>(position.x) % m_chunkSize);
-	if (position.x < 0)
-	{
-		posX -= 1;
-		position.x += m_chunkSize;
-	}
+	const float infinity = std::numeric_limits<float>::infinity();
 
-	position.y = static_cast<float>(static_cast<int>(position.y) % m_chunkSize);
-	if (position.y < 0)
-	{
-		posY -= 1;
-		position.y += m_chunkSize;
-	}
+	const float originAxes[3] = { origin.x, origin.y, origin.z };
+	const float directionAxes[3] = { direction.x, direction.y, direction.z };
+
+	const qz::Vector3i startBlock = worldToBlock(origin);
+	int block[3] = { startBlock.x, startBlock.y, startBlock.z };
 
-	position.z = static_cast<float>(static_cast<int>(position.z) % m_chunkSize);
-	if (position.z < 0)
+	int step[3];
+	float tMax[3];		// The distance along the ray to the next block boundary on each axis.
+	float tDelta[3];	// The distance along the ray between block boundaries on each axis.
+
+	for (int axis = 0; axis < 3; ++axis)
 	{
-		posZ -= 1;
-		position.z += m_chunkSize;
+		if (directionAxes[axis] > 0.f)
+		{
+			step[axis] = 1;
+			tDelta[axis] = 1.f / directionAxes[axis];
+			tMax[axis] = (static_cast<float>(block[axis] + 1) - originAxes[axis]) * tDelta[axis];
+		}
+		else if (directionAxes[axis] < 0.f)
+		{
+			step[axis] = -1;
+			tDelta[axis] = -1.f / directionAxes[axis];
+			tMax[axis] = (originAxes[axis] - static_cast<float>(block[axis])) * tDelta[axis];
+		}
+		else
+		{
+			step[axis] = 0;
+			tDelta[axis] = infinity;
+			tMax[axis] = infinity;
+		}
 	}
 
-	const qz::Vector3 chunkPosition = qz::Vector3(static_cast<float>(posX * m_chunkSize),
-		static_cast<float>(posY * m_chunkSize),
-		static_cast<float>(posZ * m_chunkSize));
+	// The chunk is only looked up again when the ray crosses into another one.
+	qz::Vector3i chunkPos = worldToChunk(startBlock);
+	const Chunk* chunk = getChunk(chunkPos);
 
-	for (auto& chunk : m_chunks)
+	int normal[3] = { 0, 0, 0 };
+	float distance = 0.f;
+
+	while (distance <= maxDistance)
 	{
-		if (chunk.getChunkPos() == chunkPosition)
+		const qz::Vector3i position = { block[0], block[1], block[2] };
+
+		if (chunk != nullptr && chunk->getBlockTypeAt(worldToLocal(position)) != BlockType::GAS)
 		{
-			chunk.placeBlockAt(
-				{ // "INLINE" VECTOR 3 DECLARATION
-				position.x, // x position IN the chunk, not overall 
-				position.y, // y position IN the chunk, not overall 
-				position.z  // z position IN the chunk, not overall 
-				},
-				block
-			);
+			hit.block = chunk->getBlockAt(worldToLocal(position));
+			hit.position = position;
+			hit.normal = { normal[0], normal[1], normal[2] };
+			hit.distance = distance;
+
+			return true;
+		}
+
+		int axis = tMax[0] < tMax[1] ? 0 : 1;
+		if (tMax[2] < tMax[axis])
+			axis = 2;
 
+		if (step[axis] == 0)
 			break;
+
+		block[axis] += step[axis];
+		distance = tMax[axis];
+		tMax[axis] += tDelta[axis];
+
+		normal[0] = normal[1] = normal[2] = 0;
+		normal[axis] = -step[axis];
+
+		const qz::Vector3i newChunkPos = worldToChunk({ block[0], block[1], block[2] });
+		if (newChunkPos != chunkPos)
+		{
+			chunkPos = newChunkPos;
+			chunk = getChunk(chunkPos);
 		}
 	}
+
+	return false;
 }
 
 void ChunkManager::render(int bufferCounter)
 {
 	int count1 = bufferCounter;
 
-	for (Chunk& chunk : m_chunks)
+	for (auto& chunk : m_chunks)
+	{
+		chunk.second->renderBlocks(&count1);
+	}
+
+	// Water can be seen through, so it goes on top of all of the blocks.
+	for (auto& chunk : m_chunks)
 	{
-		chunk.renderBlocks(&count1);
+		chunk.second->renderWater(&count1);
 	}
 }
 
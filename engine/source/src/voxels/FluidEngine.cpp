@@ -0,0 +1,345 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#include <quartz/core/QuartzPCH.hpp>
+#include <quartz/voxels/FluidEngine.hpp>
+#include <quartz/voxels/ChunkManager.hpp>
+
+#include <array>
+#include <memory>
+
+using namespace qz::voxels;
+using namespace qz;
+
+static const Vector3i HORIZONTAL_OFFSETS[] = {
+	{ 1, 0, 0 }, { -1, 0, 0 },
+	{ 0, 0, 1 }, { 0, 0, -1 },
+};
+
+static const Vector3i UP = { 0, 1, 0 };
+
+namespace
+{
+	/**
+	 * @brief Looks up blocks and fluid around a single chunk, for a tick running on the thread pool.
+	 *
+	 * A block's next level only depends on blocks next to it, so every lookup is in the chunk or in one of the chunks
+	 * around it. Their snapshots are taken once, the first time each one is needed.
+	 */
+	class FluidView
+	{
+	public:
+		FluidView(const ChunkManager* world, const Vector3i& chunkPos) :
+			m_world(world), m_chunkPos(chunkPos)
+		{
+			m_loaded.fill(false);
+		}
+
+		/**
+		 * @brief Finds a block and its fluid.
+		 * @param position The world coordinates of the block, at most one chunk away from the view's chunk.
+		 * @return Whether the block is loaded, blocks that aren't are treated as solid walls.
+		 */
+		bool read(const Vector3i& position, const BlockInstance*& block, std::uint8_t& fluid)
+		{
+			const Vector3i offset = worldToChunk(position) - m_chunkPos;
+			const std::size_t slot = static_cast<std::size_t>((offset.x + 1) + 3 * ((offset.y + 1) + 3 * (offset.z + 1)));
+
+			if (!m_loaded[slot])
+			{
+				m_loaded[slot] = true;
+				m_chunks[slot] = m_world->getChunk(m_chunkPos + offset);
+
+				if (m_chunks[slot] != nullptr)
+					m_blocks[slot] = m_chunks[slot]->getBlocks();
+			}
+
+			if (m_chunks[slot] == nullptr)
+				return false;
+
+			const std::size_t index = localToIndex(worldToLocal(position));
+
+			block = &m_blocks[slot]->get(index);
+			fluid = m_chunks[slot]->getFluidMap().getPacked(index);
+
+			return true;
+		}
+
+	private:
+		const ChunkManager* m_world;
+		Vector3i m_chunkPos;
+
+		std::array<bool, 27> m_loaded;
+		std::array<const Chunk*, 27> m_chunks;
+		std::array<std::shared_ptr<const BlockStorage>, 27> m_blocks;
+	};
+}
+
+FluidEngine::FluidEngine(ChunkManager* world, const std::string& emptyBlockID, threads::utils::ThreadPool<>& threadPool) :
+	m_world(world), m_emptyBlockID(emptyBlockID), m_timestep(TICKS_PER_SECOND), m_threadPool(threadPool)
+{}
+
+void FluidEngine::update(float dt)
+{
+	const int ticks = m_timestep.consume(dt);
+	for (int i = 0; i < ticks; ++i)
+		tick();
+}
+
+void FluidEngine::tick()
+{
+	if (m_active.empty())
+		return;
+
+	std::vector<ChunkJob> jobs;
+	jobs.reserve(m_active.size());
+
+	for (auto& entry : m_active)
+	{
+		Chunk* chunk = m_world->getChunk(entry.second.chunkPos);
+		if (chunk == nullptr)
+			continue;
+
+		jobs.push_back({ chunk, std::move(entry.second.blocks), {} });
+	}
+
+	// Anything woken while applying this tick is for the next one.
+	m_active.clear();
+
+	// Every chunk is worked out from the levels the last tick left behind and only the results are written, so the
+	// chunks can all be worked out at the same time without locking.
+	if (jobs.size() == 1)
+	{
+		simulate(jobs.front());
+	}
+	else
+	{
+		for (ChunkJob& job : jobs)
+			m_threadPool.addWork([this, &job]() { simulate(job); });
+
+		m_threadPool.wait();
+	}
+
+	for (ChunkJob& job : jobs)
+		apply(job);
+}
+
+void FluidEngine::queueBlockChange(const qz::Vector3i& position)
+{
+	Chunk* chunk = m_world->getChunk(worldToChunk(position));
+	if (chunk == nullptr)
+		return;
+
+	// Whatever was there has been replaced, so the fluid starts over. If the new block is a fluid it is a source.
+	chunk->getFluidMap().setPacked(localToIndex(worldToLocal(position)), 0);
+
+	wake(position);
+	wakeDependents(position);
+}
+
+void FluidEngine::wakeChunk(Chunk* chunk)
+{
+	chunk->getFluidMap().clear();
+
+	const std::shared_ptr<const BlockStorage> blocks = chunk->getBlocks();
+	if (blocks->isUniform() && !isFluid(blocks->getUniformBlock().getBlockType()))
+		return;
+
+	const Vector3i origin = chunkToWorld(chunk->getChunkPos());
+
+	for (std::size_t i = 0; i < CHUNK_VOLUME; ++i)
+	{
+		if (isFluid(blocks->get(i).getBlockType()))
+			wake(origin + indexToLocal(i));
+	}
+}
+
+std::size_t FluidEngine::getActiveCount() const
+{
+	std::size_t count = 0;
+	for (const auto& entry : m_active)
+		count += entry.second.blocks.size();
+
+	return count;
+}
+
+void FluidEngine::unloadChunk(const qz::Vector3i& chunkPos)
+{
+	m_active.erase(chunkKey(chunkPos));
+}
+
+void FluidEngine::wake(const qz::Vector3i& position)
+{
+	const Vector3i chunkPos = worldToChunk(position);
+	const std::uint64_t key = chunkKey(chunkPos);
+
+	auto it = m_active.find(key);
+	if (it == m_active.end())
+	{
+		// Fluid can't flow into chunks that aren't loaded, so there is no point remembering them.
+		if (m_world->getChunk(chunkPos) == nullptr)
+			return;
+
+		it = m_active.emplace(key, ActiveSet()).first;
+		it->second.chunkPos = chunkPos;
+	}
+
+	const std::size_t index = localToIndex(worldToLocal(position));
+	if (it->second.queued[index])
+		return;
+
+	it->second.queued[index] = true;
+	it->second.blocks.push_back(static_cast<std::uint16_t>(index));
+}
+
+void FluidEngine::wakeDependents(const qz::Vector3i& position)
+{
+	// The blocks whose next level depends on this one: the block below it falls from it, the blocks beside it
+	// spread from it, and the blocks beside the one above it spread from it only if it holds that one up.
+	wake(position - UP);
+
+	for (const Vector3i& offset : HORIZONTAL_OFFSETS)
+	{
+		wake(position + offset);
+		wake(position + UP + offset);
+	}
+}
+
+void FluidEngine::simulate(ChunkJob& job) const
+{
+	const Vector3i chunkPos = job.chunk->getChunkPos();
+	const Vector3i origin = chunkToWorld(chunkPos);
+
+	FluidView view(m_world, chunkPos);
+
+	for (std::uint16_t index : job.blocks)
+	{
+		const Vector3i position = origin + indexToLocal(index);
+
+		const BlockInstance* block = nullptr;
+		std::uint8_t fluid = 0;
+		view.read(position, block, fluid);
+
+		const BlockType type = block->getBlockType();
+
+		std::uint8_t next = 0;
+		const BlockInstance* source = nullptr;
+
+		if (type == BlockType::SOLID || type == BlockType::OBJECT)
+		{
+			next = 0;
+		}
+		else if (isFluid(type) && (fluid == 0 || (fluid & FluidMap::SOURCE)))
+		{
+			next = FluidMap::SOURCE | FluidMap::MAX_LEVEL;
+		}
+		else
+		{
+			const BlockInstance* neighbour = nullptr;
+			std::uint8_t neighbourFluid = 0;
+
+			// Falling fluid is always full.
+			if (view.read(position + UP, neighbour, neighbourFluid) && (neighbourFluid & 0x0F) > 0)
+			{
+				next = FluidMap::MAX_LEVEL;
+				source = neighbour;
+			}
+			else
+			{
+				for (const Vector3i& offset : HORIZONTAL_OFFSETS)
+				{
+					if (!view.read(position + offset, neighbour, neighbourFluid))
+						continue;
+
+					const int level = neighbourFluid & 0x0F;
+					if (level - 1 <= next)
+						continue;
+
+					// Fluid only spreads sideways once it has landed on something solid or on a pool of sources,
+					// otherwise it keeps falling.
+					const BlockInstance* below = nullptr;
+					std::uint8_t belowFluid = 0;
+
+					if (!view.read(position + offset - UP, below, belowFluid))
+						continue;
+
+					const BlockType belowType = below->getBlockType();
+					if (!(belowFluid & FluidMap::SOURCE) && (belowType == BlockType::GAS || isFluid(belowType)))
+						continue;
+
+					next = static_cast<std::uint8_t>(level - 1);
+					source = neighbour;
+				}
+			}
+		}
+
+		std::string blockID;
+		if (next > 0 && source != nullptr && block->getBlockID() != source->getBlockID())
+			blockID = source->getBlockID();
+		else if (next == 0 && isFluid(type))
+			blockID = m_emptyBlockID;
+
+		if (next != fluid || !blockID.empty())
+			job.changes.push_back({ index, next, std::move(blockID) });
+	}
+}
+
+void FluidEngine::apply(ChunkJob& job)
+{
+	if (job.changes.empty())
+		return;
+
+	FluidMap& fluidMap = job.chunk->getFluidMap();
+	const Vector3i origin = chunkToWorld(job.chunk->getChunkPos());
+
+	std::vector<BlockEdit> edits;
+
+	for (const FluidChange& change : job.changes)
+	{
+		const Vector3i position = origin + indexToLocal(change.index);
+
+		fluidMap.setPacked(change.index, change.fluid);
+
+		if (!change.blockID.empty())
+			edits.push_back({ position, BlockInstance(change.blockID), BlockEditType::SET });
+
+		// Blocks in neighbouring chunks are handed over to those chunks here, ready for the next tick.
+		wakeDependents(position);
+	}
+
+	// Fluid blocks let light through and don't give any off, so the lighting doesn't need to change.
+	if (edits.empty())
+	{
+		job.chunk->flagForMeshing();
+		return;
+	}
+
+	std::vector<const BlockEdit*> editPointers;
+	editPointers.reserve(edits.size());
+
+	for (const BlockEdit& edit : edits)
+		editPointers.push_back(&edit);
+
+	job.chunk->applyEdits(editPointers);
+}
+
@@ -0,0 +1,403 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#include <quartz/core/QuartzPCH.hpp>
+#include <quartz/voxels/LightEngine.hpp>
+#include <quartz/voxels/ChunkManager.hpp>
+
+using namespace qz::voxels;
+using namespace qz;
+
+static const Vector3i NEIGHBOUR_OFFSETS[] = {
+	{ 1, 0, 0 }, { -1, 0, 0 },
+	{ 0, 1, 0 }, { 0, -1, 0 },
+	{ 0, 0, 1 }, { 0, 0, -1 },
+};
+
+const int NEIGHBOUR_UP = 2;
+const int NEIGHBOUR_DOWN = 3;
+
+const LightChannel LIGHT_CHANNELS[] = { LightChannel::SKY, LightChannel::BLOCK };
+
+static bool isTransparent(BlockType type)
+{
+	return type != BlockType::SOLID;
+}
+
+LightEngine::LightEngine(ChunkManager* world) :
+	m_world(world)
+{}
+
+void LightEngine::lightChunk(Chunk* chunk)
+{
+	LightMap& light = chunk->getLightMap();
+	light.clear();
+
+	const Vector3i chunkPos = chunk->getChunkPos();
+	const Vector3i origin = chunkToWorld(chunkPos);
+
+	const std::shared_ptr<const BlockStorage> blocks = chunk->getBlocks();
+	const bool uniform = blocks->isUniform();
+
+	// Nothing can get into a chunk that is solid all the way through, it stays dark unless it glows.
+	if (uniform && !isTransparent(blocks->getUniformBlock().getBlockType()) && blocks->getUniformBlock().getLightEmission() == 0)
+	{
+		chunk->flagForMeshing();
+		return;
+	}
+
+	const bool openSky = m_world->getChunk(chunkPos + NEIGHBOUR_OFFSETS[NEIGHBOUR_UP]) == nullptr;
+
+	if (openSky && uniform && isTransparent(blocks->getUniformBlock().getBlockType()))
+	{
+		// Every column of an empty chunk is fully lit, so only the shell has anywhere to spread light to.
+		for (std::size_t i = 0; i < CHUNK_VOLUME; ++i)
+			light.setSkyLight(i, LightMap::MAX_LIGHT);
+
+		for (int z = 0; z < CHUNK_SIZE; ++z)
+		{
+			for (int y = 0; y < CHUNK_SIZE; ++y)
+			{
+				const bool edge = z == 0 || z == CHUNK_SIZE_MASK || y == 0 || y == CHUNK_SIZE_MASK;
+				const int step = edge ? 1 : CHUNK_SIZE_MASK;
+
+				for (int x = 0; x < CHUNK_SIZE; x += step)
+					m_skyQueues.add.push({ origin + Vector3i(x, y, z), LightMap::MAX_LIGHT });
+			}
+		}
+	}
+	else if (openSky)
+	{
+		// Sky light falls straight down each column until it hits something solid.
+		for (int z = 0; z < CHUNK_SIZE; ++z)
+		{
+			for (int x = 0; x < CHUNK_SIZE; ++x)
+			{
+				for (int y = CHUNK_SIZE - 1; y >= 0; --y)
+				{
+					const Vector3i local = { x, y, z };
+
+					if (!isTransparent(blocks->get(localToIndex(local)).getBlockType()))
+						break;
+
+					light.setSkyLight(localToIndex(local), LightMap::MAX_LIGHT);
+					m_skyQueues.add.push({ origin + local, LightMap::MAX_LIGHT });
+				}
+			}
+		}
+	}
+
+	if (!uniform || blocks->getUniformBlock().getLightEmission() > 0)
+	{
+		for (std::size_t i = 0; i < CHUNK_VOLUME; ++i)
+		{
+			const int emission = blocks->get(i).getLightEmission();
+			if (emission > 0)
+			{
+				light.setBlockLight(i, emission);
+				m_blockQueues.add.push({ origin + indexToLocal(i), emission });
+			}
+		}
+	}
+
+	// Pull in the light from the faces of any loaded neighbours, the flood fill carries it across the border.
+	for (const Vector3i& offset : NEIGHBOUR_OFFSETS)
+	{
+		Chunk* neighbour = m_world->getChunk(chunkPos + offset);
+		if (neighbour == nullptr)
+			continue;
+
+		const int offsets[3] = { offset.x, offset.y, offset.z };
+		const int axis = offset.x != 0 ? 0 : (offset.y != 0 ? 1 : 2);
+
+		const Vector3i neighbourOrigin = chunkToWorld(chunkPos + offset);
+		const LightMap& neighbourLight = neighbour->getLightMap();
+
+		for (int a = 0; a < CHUNK_SIZE; ++a)
+		{
+			for (int b = 0; b < CHUNK_SIZE; ++b)
+			{
+				int coords[3];
+				coords[axis] = offsets[axis] > 0 ? 0 : CHUNK_SIZE_MASK;
+				coords[(axis + 1) % 3] = a;
+				coords[(axis + 2) % 3] = b;
+
+				const Vector3i local = { coords[0], coords[1], coords[2] };
+				const std::size_t index = localToIndex(local);
+
+				for (LightChannel channel : LIGHT_CHANNELS)
+				{
+					const int level = neighbourLight.getLight(channel, index);
+					if (level > 0)
+						getQueues(channel).add.push({ neighbourOrigin + local, level });
+				}
+			}
+		}
+	}
+
+	chunk->flagForMeshing();
+
+	propagate();
+}
+
+void LightEngine::queueBlockChange(const Vector3i& position)
+{
+	// The block was just edited, so any snapshot still cached from before the edit is out of date.
+	m_cachedChunk = nullptr;
+
+	Chunk* chunk = getChunkFor(position);
+	if (chunk == nullptr)
+		return;
+
+	const Vector3i local = worldToLocal(position);
+	const std::size_t index = localToIndex(local);
+
+	LightMap& light = chunk->getLightMap();
+
+	// Flood out whatever light used to be here, the add pass will fill the hole back in.
+	for (LightChannel channel : LIGHT_CHANNELS)
+	{
+		const int level = light.getLight(channel, index);
+		if (level > 0)
+		{
+			light.setLight(channel, index, 0);
+			getQueues(channel).remove.push({ position, level });
+		}
+	}
+
+	const int emission = getCachedBlock(local).getLightEmission();
+	if (emission > 0)
+	{
+		light.setBlockLight(index, emission);
+		m_blockQueues.add.push({ position, emission });
+	}
+
+	// If light can now pass through the block, let the light around it flow in.
+	if (isTransparent(getCachedBlock(local).getBlockType()))
+	{
+		for (int i = 0; i < 6; ++i)
+		{
+			const Vector3i neighbourPos = position + NEIGHBOUR_OFFSETS[i];
+
+			Chunk* neighbour = getChunkFor(neighbourPos);
+			if (neighbour == nullptr)
+			{
+				if (i == NEIGHBOUR_UP)
+				{
+					light.setSkyLight(index, LightMap::MAX_LIGHT);
+					m_skyQueues.add.push({ position, LightMap::MAX_LIGHT });
+				}
+
+				continue;
+			}
+
+			const std::size_t neighbourIndex = localToIndex(worldToLocal(neighbourPos));
+
+			for (LightChannel channel : LIGHT_CHANNELS)
+			{
+				const int level = neighbour->getLightMap().getLight(channel, neighbourIndex);
+				if (level > 0)
+					getQueues(channel).add.push({ neighbourPos, level });
+			}
+		}
+	}
+
+	markDirty(chunk, local, position);
+}
+
+void LightEngine::propagate()
+{
+	propagateRemove(LightChannel::SKY);
+	propagateRemove(LightChannel::BLOCK);
+
+	propagateAdd(LightChannel::SKY);
+	propagateAdd(LightChannel::BLOCK);
+
+	for (Chunk* chunk : m_dirtyChunks)
+		chunk->flagForMeshing();
+
+	m_dirtyChunks.clear();
+
+	// Chunks may be unloaded before the next update, so don't hold on to any of them.
+	m_cachedChunk = nullptr;
+	m_cachedBlocks.reset();
+}
+
+void LightEngine::unloadChunk(Chunk* chunk)
+{
+	m_dirtyChunks.erase(chunk);
+
+	if (m_cachedChunk == chunk)
+	{
+		m_cachedChunk = nullptr;
+		m_cachedBlocks.reset();
+	}
+}
+
+LightEngine::ChannelQueues& LightEngine::getQueues(LightChannel channel)
+{
+	return channel == LightChannel::SKY ? m_skyQueues : m_blockQueues;
+}
+
+Chunk* LightEngine::getChunkFor(const Vector3i& position)
+{
+	const Vector3i chunkPos = worldToChunk(position);
+
+	if (m_cachedChunk == nullptr || chunkPos != m_cachedChunkPos)
+	{
+		m_cachedChunk = m_world->getChunk(chunkPos);
+		m_cachedChunkPos = chunkPos;
+
+		if (m_cachedChunk != nullptr)
+			m_cachedBlocks = m_cachedChunk->getBlocks();
+	}
+
+	return m_cachedChunk;
+}
+
+const BlockInstance& LightEngine::getCachedBlock(const Vector3i& local) const
+{
+	return m_cachedBlocks->get(localToIndex(local));
+}
+
+void LightEngine::markDirty(Chunk* chunk, const Vector3i& local, const Vector3i& position)
+{
+	m_dirtyChunks.insert(chunk);
+
+	// Faces in neighbouring chunks are lit by the blocks along the border, so those need meshing again too.
+	const int coords[3] = { local.x, local.y, local.z };
+
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		if (coords[axis] != 0 && coords[axis] != CHUNK_SIZE_MASK)
+			continue;
+
+		const Vector3i& offset = NEIGHBOUR_OFFSETS[axis * 2 + (coords[axis] == 0 ? 1 : 0)];
+
+		Chunk* neighbour = m_world->getChunk(worldToChunk(position + offset));
+		if (neighbour != nullptr)
+			m_dirtyChunks.insert(neighbour);
+	}
+}
+
+void LightEngine::propagateRemove(LightChannel channel)
+{
+	ChannelQueues& queues = getQueues(channel);
+
+	while (!queues.remove.empty())
+	{
+		const LightNode node = queues.remove.front();
+		queues.remove.pop();
+
+		for (int i = 0; i < 6; ++i)
+		{
+			const Vector3i neighbourPos = node.position + NEIGHBOUR_OFFSETS[i];
+
+			Chunk* neighbour = getChunkFor(neighbourPos);
+			if (neighbour == nullptr)
+				continue;
+
+			const Vector3i local = worldToLocal(neighbourPos);
+			const std::size_t index = localToIndex(local);
+
+			LightMap& light = neighbour->getLightMap();
+
+			const int level = light.getLight(channel, index);
+			if (level == 0)
+				continue;
+
+			// Full sky light falls straight down without fading, so the whole column below came from this block.
+			const bool skyColumn = channel == LightChannel::SKY && i == NEIGHBOUR_DOWN && node.level == LightMap::MAX_LIGHT;
+
+			if (level < node.level || skyColumn)
+			{
+				light.setLight(channel, index, 0);
+				queues.remove.push({ neighbourPos, level });
+				markDirty(neighbour, local, neighbourPos);
+
+				// Light sources that got caught up in the removal still need to shine.
+				if (channel == LightChannel::BLOCK)
+				{
+					const int emission = getCachedBlock(local).getLightEmission();
+					if (emission > 0)
+					{
+						light.setBlockLight(index, emission);
+						queues.add.push({ neighbourPos, emission });
+					}
+				}
+			}
+			else
+			{
+				// This light came from somewhere else, so it gets to flow back into the area that was removed.
+				queues.add.push({ neighbourPos, level });
+			}
+		}
+	}
+}
+
+void LightEngine::propagateAdd(LightChannel channel)
+{
+	ChannelQueues& queues = getQueues(channel);
+
+	while (!queues.add.empty())
+	{
+		const LightNode node = queues.add.front();
+		queues.add.pop();
+
+		Chunk* chunk = getChunkFor(node.position);
+		if (chunk == nullptr)
+			continue;
+
+		// The light may have changed since this was queued, so always spread what's actually there.
+		const int level = chunk->getLightMap().getLight(channel, localToIndex(worldToLocal(node.position)));
+		if (level <= 1)
+			continue;
+
+		for (int i = 0; i < 6; ++i)
+		{
+			const Vector3i neighbourPos = node.position + NEIGHBOUR_OFFSETS[i];
+
+			Chunk* neighbour = getChunkFor(neighbourPos);
+			if (neighbour == nullptr)
+				continue;
+
+			const Vector3i local = worldToLocal(neighbourPos);
+
+			if (!isTransparent(getCachedBlock(local).getBlockType()))
+				continue;
+
+			const bool skyColumn = channel == LightChannel::SKY && i == NEIGHBOUR_DOWN && level == LightMap::MAX_LIGHT;
+			const int newLevel = skyColumn ? level : level - 1;
+
+			const std::size_t index = localToIndex(local);
+			LightMap& light = neighbour->getLightMap();
+
+			if (light.getLight(channel, index) < newLevel)
+			{
+				light.setLight(channel, index, newLevel);
+				queues.add.push({ neighbourPos, newLevel });
+				markDirty(neighbour, local, neighbourPos);
+			}
+		}
+	}
+}
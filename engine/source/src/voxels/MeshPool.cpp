@@ -0,0 +1,88 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#include <quartz/core/QuartzPCH.hpp>
+#include <quartz/voxels/MeshPool.hpp>
+
+using namespace qz::voxels;
+
+MeshBufferPool* MeshBufferPool::get()
+{
+	static MeshBufferPool pool;
+	return &pool;
+}
+
+MeshBufferPool::Buffer MeshBufferPool::acquire(std::size_t minVertices)
+{
+	int sizeClass = 0;
+	while (sizeClass < NUM_SIZE_CLASSES - 1 && getClassCapacity(sizeClass) < minVertices)
+		++sizeClass;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		// Every buffer in a class can hold at least that class's capacity, so any larger class will do too.
+		for (int i = sizeClass; i < NUM_SIZE_CLASSES; ++i)
+		{
+			std::vector<Buffer>& freeBuffers = m_freeBuffers[i];
+			if (freeBuffers.empty() || freeBuffers.back().capacity() < minVertices)
+				continue;
+
+			Buffer buffer = std::move(freeBuffers.back());
+			freeBuffers.pop_back();
+
+			return buffer;
+		}
+	}
+
+	Buffer buffer;
+	buffer.reserve(std::max(minVertices, getClassCapacity(sizeClass)));
+
+	return buffer;
+}
+
+void MeshBufferPool::release(Buffer&& buffer)
+{
+	Buffer released = std::move(buffer);
+	released.clear();
+
+	if (released.capacity() < MIN_CAPACITY)
+		return;
+
+	// File it under the largest class it can fully hold.
+	int sizeClass = 0;
+	while (sizeClass < NUM_SIZE_CLASSES - 1 && getClassCapacity(sizeClass + 1) <= released.capacity())
+		++sizeClass;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	std::vector<Buffer>& freeBuffers = m_freeBuffers[sizeClass];
+	if (freeBuffers.size() < MAX_BUFFERS_PER_CLASS)
+		freeBuffers.push_back(std::move(released));
+}
+
+std::size_t MeshBufferPool::getClassCapacity(int sizeClass)
+{
+	return MIN_CAPACITY << sizeClass;
+}
+
@@ -0,0 +1,276 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#include <quartz/core/QuartzPCH.hpp>
+#include <quartz/voxels/Physics.hpp>
+#include <quartz/voxels/ChunkManager.hpp>
+
+#include <algorithm>
+
+using namespace qz::voxels;
+using namespace qz;
+
+// Boxes closer than this are treated as touching. A box that comes to rest on a block can end up a rounding error
+// inside it, which would otherwise let it fall through on the next move.
+const float EPSILON = 1e-3f;
+
+// Axes are swept in this order. Going down first means a box walking along the ground has already landed before it
+// moves sideways, so it doesn't catch on the edges of the blocks under it.
+static const int SWEEP_ORDER[] = { 1, 0, 2 };
+
+static float& component(Vector3& vector, int axis)
+{
+	return axis == 0 ? vector.x : (axis == 1 ? vector.y : vector.z);
+}
+
+static float component(const Vector3& vector, int axis)
+{
+	return axis == 0 ? vector.x : (axis == 1 ? vector.y : vector.z);
+}
+
+// Shortens a motion along one axis so the box stops at the obstacle instead of moving into it.
+static float clipAxis(const math::AABB& box, const math::AABB& obstacle, float motion, int axis)
+{
+	for (int other = 0; other < 3; ++other)
+	{
+		if (other == axis)
+			continue;
+
+		if (component(box.max, other) <= component(obstacle.min, other) + EPSILON ||
+			component(box.min, other) >= component(obstacle.max, other) - EPSILON)
+		{
+			return motion;
+		}
+	}
+
+	if (motion > 0.f && component(box.max, axis) <= component(obstacle.min, axis) + EPSILON)
+		motion = std::min(motion, std::max(0.f, component(obstacle.min, axis) - component(box.max, axis)));
+	else if (motion < 0.f && component(box.min, axis) >= component(obstacle.max, axis) - EPSILON)
+		motion = std::max(motion, std::min(0.f, component(obstacle.max, axis) - component(box.min, axis)));
+
+	return motion;
+}
+
+VoxelCollider::VoxelCollider(const ChunkManager* world) :
+	m_world(world)
+{}
+
+Vector3 VoxelCollider::move(math::AABB& box, const Vector3& motion, float stepHeight, MoveResult& result)
+{
+	result = MoveResult();
+
+	const math::AABB start = box;
+
+	// Everything the move, or a step up, could run into.
+	gather(start.expand(motion).expand({ 0.f, stepHeight, 0.f }));
+
+	Vector3 moved = sweep(box, motion);
+
+	result.onGround = motion.y < 0.f && moved.y != motion.y;
+	result.hitCeiling = motion.y > 0.f && moved.y != motion.y;
+	result.blockedX = moved.x != motion.x;
+	result.blockedZ = moved.z != motion.z;
+
+	if (stepHeight <= 0.f || !result.onGround || !(result.blockedX || result.blockedZ))
+		return moved;
+
+	// Try the move again from on top of the ledge, then settle back down onto whatever is there. The step is only
+	// taken if it gets the box further than walking into the ledge did.
+	math::AABB stepped = start;
+
+	const Vector3 up = sweep(stepped, { 0.f, stepHeight, 0.f });
+	const Vector3 across = sweep(stepped, { motion.x, 0.f, motion.z });
+	const Vector3 down = sweep(stepped, { 0.f, -up.y, 0.f });
+
+	if (across.x * across.x + across.z * across.z <= moved.x * moved.x + moved.z * moved.z)
+		return moved;
+
+	box = stepped;
+	moved = { across.x, up.y + down.y, across.z };
+
+	result.blockedX = across.x != motion.x;
+	result.blockedZ = across.z != motion.z;
+	result.stepped = true;
+
+	return moved;
+}
+
+bool VoxelCollider::intersects(const math::AABB& box)
+{
+	gather(box);
+
+	for (const math::AABB& candidate : m_candidates)
+	{
+		if (box.intersects(candidate))
+			return true;
+	}
+
+	return false;
+}
+
+void VoxelCollider::gather(const math::AABB& region)
+{
+	m_candidates.clear();
+
+	const Vector3i min = worldToBlock(region.min);
+	const Vector3i max = worldToBlock(region.max);
+
+	for (int x = min.x; x <= max.x; ++x)
+	{
+		for (int z = min.z; z <= max.z; ++z)
+		{
+			for (int y = min.y; y <= max.y; ++y)
+			{
+				if (!isSolid({ x, y, z }))
+					continue;
+
+				const Vector3 corner = { static_cast<float>(x), static_cast<float>(y), static_cast<float>(z) };
+				m_candidates.emplace_back(corner, corner + 1.f);
+			}
+		}
+	}
+}
+
+bool VoxelCollider::isSolid(const Vector3i& position)
+{
+	const Vector3i chunkPos = worldToChunk(position);
+
+	// A box is nearly always inside a single chunk, so the last snapshot taken is usually the one needed.
+	if (!m_hasCachedChunk || chunkPos != m_cachedChunkPos)
+	{
+		const Chunk* chunk = m_world->getChunk(chunkPos);
+
+		m_hasCachedChunk = true;
+		m_cachedChunkPos = chunkPos;
+		m_cachedBlocks = chunk != nullptr ? chunk->getBlocks() : nullptr;
+	}
+
+	if (m_cachedBlocks == nullptr)
+		return true;
+
+	return m_cachedBlocks->get(localToIndex(worldToLocal(position))).getBlockType() == BlockType::SOLID;
+}
+
+Vector3 VoxelCollider::sweep(math::AABB& box, const Vector3& motion) const
+{
+	Vector3 moved = motion;
+
+	for (int axis : SWEEP_ORDER)
+	{
+		float& distance = component(moved, axis);
+		if (distance == 0.f)
+			continue;
+
+		for (const math::AABB& candidate : m_candidates)
+			distance = clipAxis(box, candidate, distance, axis);
+
+		Vector3 offset;
+		component(offset, axis) = distance;
+
+		box.offset(offset);
+	}
+
+	return moved;
+}
+
+math::AABB PhysicsBody::getBounds() const
+{
+	const float halfWidth = width / 2.f;
+
+	return {
+		{ position.x - halfWidth, position.y, position.z - halfWidth },
+		{ position.x + halfWidth, position.y + height, position.z + halfWidth }
+	};
+}
+
+PhysicsSystem::PhysicsSystem(const ChunkManager* world, entt::registry<>& registry, threads::utils::ThreadPool<>& threadPool) :
+	m_world(world), m_registry(registry), m_timestep(TICKS_PER_SECOND), m_threadPool(threadPool)
+{}
+
+void PhysicsSystem::update(float dt)
+{
+	const int ticks = m_timestep.consume(dt);
+	for (int i = 0; i < ticks; ++i)
+		tick();
+}
+
+void PhysicsSystem::tick()
+{
+	// The bodies are packed together in the registry, so batches are just ranges of one array.
+	const auto view = m_registry.view<PhysicsBody>();
+
+	PhysicsBody* bodies = view.raw();
+	const std::size_t count = view.size();
+
+	if (count <= BATCH_SIZE)
+	{
+		simulate(bodies, count);
+		return;
+	}
+
+	for (std::size_t begin = 0; begin < count; begin += BATCH_SIZE)
+	{
+		const std::size_t size = std::min(BATCH_SIZE, count - begin);
+		m_threadPool.addWork([this, bodies, begin, size]() { simulate(bodies + begin, size); });
+	}
+
+	m_threadPool.wait();
+}
+
+float PhysicsSystem::getInterpolation() const
+{
+	return m_timestep.getRemainder();
+}
+
+void PhysicsSystem::step(VoxelCollider& collider, PhysicsBody& body)
+{
+	const float dt = 1.f / TICKS_PER_SECOND;
+
+	body.previousPosition = body.position;
+	body.velocity.y = std::max(body.velocity.y - GRAVITY * body.gravityScale * dt, -TERMINAL_VELOCITY);
+
+	math::AABB box = body.getBounds();
+
+	MoveResult result;
+	body.position += collider.move(box, body.velocity * dt, body.stepHeight, result);
+
+	if (result.onGround || result.hitCeiling)
+		body.velocity.y = 0.f;
+
+	if (result.blockedX)
+		body.velocity.x = 0.f;
+
+	if (result.blockedZ)
+		body.velocity.z = 0.f;
+
+	body.onGround = result.onGround;
+}
+
+void PhysicsSystem::simulate(PhysicsBody* bodies, std::size_t count) const
+{
+	// One collider per batch, so a batch of bodies close together shares its chunk lookups.
+	VoxelCollider collider(m_world);
+
+	for (std::size_t i = 0; i < count; ++i)
+		step(collider, bodies[i]);
+}
@@ -0,0 +1,96 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#include <quartz/core/QuartzPCH.hpp>
+#include <quartz/voxels/entities/EntityWorld.hpp>
+
+using namespace qz::entities;
+using namespace qz;
+
+// Dropped items are smaller than a block, and too small to climb onto anything.
+const float ITEM_SIZE = 0.25f;
+
+Registry& EntityWorld::getRegistry()
+{
+	return m_registry;
+}
+
+const Registry& EntityWorld::getRegistry() const
+{
+	return m_registry;
+}
+
+Entity EntityWorld::createEntity(const voxels::PhysicsBody& body)
+{
+	const Entity entity = m_registry.create();
+
+	voxels::PhysicsBody& added = m_registry.assign<voxels::PhysicsBody>(entity, body);
+
+	// There is no last tick to draw the entity coming from yet.
+	added.previousPosition = added.position;
+
+	return entity;
+}
+
+Entity EntityWorld::dropItem(const ItemStack& stack, const Vector3& position, const Vector3& velocity)
+{
+	voxels::PhysicsBody body;
+	body.position = position;
+	body.velocity = velocity;
+	body.width = ITEM_SIZE;
+	body.height = ITEM_SIZE;
+	body.stepHeight = 0.f;
+
+	const Entity entity = createEntity(body);
+
+	m_registry.assign<ItemStack>(entity, stack);
+	m_registry.assign<DroppedItem>(entity);
+
+	return entity;
+}
+
+void EntityWorld::destroy(Entity entity)
+{
+	m_registry.destroy(entity);
+}
+
+std::size_t EntityWorld::getEntityCount() const
+{
+	return m_registry.alive();
+}
+
+void EntityWorld::update(float dt)
+{
+	m_expired.clear();
+
+	m_registry.view<DroppedItem>().each([this, dt](const Entity entity, DroppedItem& item)
+	{
+		item.age += dt;
+
+		if (item.age >= ITEM_DESPAWN_TIME)
+			m_expired.push_back(entity);
+	});
+
+	for (const Entity entity : m_expired)
+		m_registry.destroy(entity);
+}
@@ -23,14 +23,20 @@
 
 #include <quartz/core/QuartzPCH.hpp>
 #include <quartz/voxels/entities/Item.hpp>
+#include <quartz/core/utils/Logging.hpp>
+
+#include <limits>
 
 using namespace qz::entities;
 
-std::vector<Item*> ItemLibrary::m_itemLibrary;
+std::vector<Item*> ItemLibrary::m_items = { nullptr };
+std::unordered_map<std::string, ItemHandle> ItemLibrary::m_handles;
+std::unordered_map<ItemID, ItemHandle> ItemLibrary::m_hashedHandles;
 
 Item::Item(std::string id, std::string name)
 {
 	m_id = id;
+	m_hashedID = hashItemID(id);
 	m_name = name;
 	ItemLibrary::registerItem(this);
 };
@@ -40,42 +46,87 @@ Item::~Item()
 	// empty
 }
 
-std::string Item::getID()
+const std::string& Item::getID() const
 {
 	return m_id;
 };
 
-std::string Item::getName()
+ItemID Item::getHashedID() const
+{
+	return m_hashedID;
+}
+
+ItemHandle Item::getHandle() const
+{
+	return m_handle;
+}
+
+const std::string& Item::getName() const
 {
 	return m_name;
 };
 
-void Item::setOnBreakCallback(void* callback) { m_onBreakCallback = callback; }
-void* Item::getOnBreakCallback() { return m_onBreakCallback; }
+void Item::setOnBreakCallback(const ItemCallback& callback) { m_onBreakCallback = callback; }
+const ItemCallback& Item::getOnBreakCallback() const { return m_onBreakCallback; }
 
-void Item::setOnUseCallback(void* callback) { m_onUseCallback = callback; }
-void* Item::getOnUseCallback() { return m_onUseCallback; }
+void Item::setOnUseCallback(const ItemCallback& callback) { m_onUseCallback = callback; }
+const ItemCallback& Item::getOnUseCallback() const { return m_onUseCallback; }
 
-/////////////////////////////////////////////////////////////////
-/////////////////// Block Library Code //////////////////////////
-/////////////////////////////////////////////////////////////////
 
 void ItemLibrary::registerItem(Item* item)
 {
-	m_itemLibrary.push_back(item);
+	if (m_handles.find(item->getID()) != m_handles.end())
+	{
+		LWARNING("The Item: ", item->getID(), " has already been registered, please take action!");
+		return;
+	}
+
+	if (m_items.size() > std::numeric_limits<ItemHandle>::max())
+	{
+		LWARNING("The Item: ", item->getID(), " can't be registered, there are no item handles left!");
+		return;
+	}
+
+	item->m_handle = static_cast<ItemHandle>(m_items.size());
+
+	m_items.push_back(item);
+	m_handles.emplace(item->getID(), item->m_handle);
+
+	// Two different IDs can hash the same, both are still registered but neither can be found by its hash.
+	const auto hashed = m_hashedHandles.emplace(item->getHashedID(), item->m_handle);
+	if (!hashed.second)
+		hashed.first->second = NO_ITEM;
+}
+
+Item* ItemLibrary::getItemByID(const std::string& id)
+{
+	const auto handle = m_handles.find(id);
+	if (handle == m_handles.end())
+		return nullptr;
+
+	return m_items[handle->second];
 }
 
-Item ItemLibrary::getItemByID(std::string id)
+Item* ItemLibrary::getItemByHashedID(ItemID id)
 {
-	for (int i = 1; i < m_itemLibrary.size(); i++)
-	{
-		Item* item = m_itemLibrary[i];
-		if (item->getID() == id)
-		{
-			return *item;
-		}
-	};
-
-	return *(m_itemLibrary[0]);
+	const auto handle = m_hashedHandles.find(id);
+	if (handle == m_hashedHandles.end())
+		return nullptr;
+
+	return getItem(handle->second);
 }
 
+Item* ItemLibrary::getItem(ItemHandle handle)
+{
+	if (handle >= m_items.size())
+		return nullptr;
+
+	return m_items[handle];
+}
+
+ItemHandle ItemLibrary::getHandle(const std::string& id)
+{
+	const Item* item = getItemByID(id);
+
+	return item != nullptr ? item->getHandle() : NO_ITEM;
+}
@@ -29,30 +29,35 @@ using namespace qz::entities;
 // JUST HERE FOR REFERENCE. NOT NEEDED FOR ANYTHING ATM.
 // MapBlock::MapBlock( std::string id, int rotation ) : m_id( id ), m_rotation( rotation ), m_damage( 0 )
 
-ItemInstance::ItemInstance(std::string id) : m_damage(0), m_id(id)
+ItemInstance::ItemInstance(ItemHandle item, int baseDamage) : m_item(item), m_damage(baseDamage)
 {
     // empty
 }
 
-ItemInstance::ItemInstance(std::string id, int baseDamage) : m_damage(baseDamage), m_id(id)
+ItemInstance::ItemInstance(const std::string& id, int baseDamage) : m_item(ItemLibrary::getHandle(id)), m_damage(baseDamage)
 {
     // empty
 }
 
-ItemInstance::~ItemInstance()
+
+ItemHandle ItemInstance::getHandle() const
 {
-    // empty
+    return m_item;
 }
 
-// Getters for universal data shared between all blocks
-// something getTextures();
+Item* ItemInstance::getItem() const
+{
+    return ItemLibrary::getItem(m_item);
+}
 
-std::string ItemInstance::getID() const
+const std::string& ItemInstance::getID() const
 {
-    return m_id;
+    static const std::string noID;
+
+    const Item* item = getItem();
+    return item != nullptr ? item->getID() : noID;
 }
 
-// Getters and setters for unique item data
 
 int ItemInstance::getDamage() const
 {
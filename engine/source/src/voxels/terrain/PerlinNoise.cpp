@@ -23,6 +23,7 @@
 
 #include <quartz/core/QuartzPCH.hpp>
 #include <quartz/voxels/terrain/PerlinNoise.hpp>
+#include <quartz/voxels/VoxelMath.hpp>
 
 #include <algorithm>
 #include <random>
@@ -45,8 +46,7 @@ static int s_permutation[] = {
 	50, 45, 127, 4, 150, 254, 138, 236, 205, 93, 222, 114, 67, 29, 24, 72, 243, 141, 128, 195, 78, 66, 215,
 	61, 156, 180 };
 
-PerlinNoise::PerlinNoise() :
-	m_chunkSize(16)
+PerlinNoise::PerlinNoise()
 {
 	for (int i : s_permutation)
 	{
@@ -56,8 +56,7 @@ PerlinNoise::PerlinNoise() :
 	m_p.insert(m_p.end(), m_p.begin(), m_p.end());
 }
 
-PerlinNoise::PerlinNoise(unsigned int seed) :
-	m_chunkSize(16)
+PerlinNoise::PerlinNoise(unsigned int seed)
 {
 	m_p.resize(256);
 
@@ -68,57 +67,70 @@ PerlinNoise::PerlinNoise(unsigned int seed) :
 	m_p.insert(m_p.end(), m_p.begin(), m_p.end());
 }
 
-void PerlinNoise::generateFor(std::vector<BlockInstance>& blockArray, qz::Vector3 chunkPos, int chunkSize)
+void PerlinNoise::generateFor(BlockStorage& blocks, const qz::Vector3i& chunkPos)
 {
-	m_chunkSize = chunkSize;
+	const qz::Vector3i chunkOrigin = chunkToWorld(chunkPos);
 
-	for (int x = 0; x < m_chunkSize; ++x)
+	const BlockInstance air("core:air");
+
+	// Terrain only exists between y = 0 and 16, every other chunk is left as uniform air without touching a block.
+	if (chunkOrigin.y >= 16 || chunkOrigin.y + CHUNK_SIZE <= 0)
+	{
+		blocks.fill(air);
+		return;
+	}
+
+	const BlockInstance grass("core:grass");
+	const BlockInstance dirt("core:dirt");
+
+	for (int x = 0; x < CHUNK_SIZE; ++x)
 	{
-		for (int y = 0; y < m_chunkSize; ++y)
+		for (int y = 0; y < CHUNK_SIZE; ++y)
 		{
-			if (chunkPos.y + y >= 16)
+			if (chunkOrigin.y + y >= 16)
 			{
-				for (int z = 0; z < m_chunkSize; ++z)
+				for (int z = 0; z < CHUNK_SIZE; ++z)
 				{
-					blockArray[getVectorIndex(x, y, z)] = BlockInstance("core:air");
+					blocks.set(localToIndex({ x, y, z }), air);
 				}
 				continue;
 			}
 
-			if (chunkPos.y + y < 0)
+			if (chunkOrigin.y + y < 0)
 			{
-				for (int z = 0; z < m_chunkSize; ++z)
+				for (int z = 0; z < CHUNK_SIZE; ++z)
 				{
-					blockArray[getVectorIndex(x, y, z)] = BlockInstance("core:air");
+					blocks.set(localToIndex({ x, y, z }), air);
 				}
 				continue;
 			}
 
-			for (int z = 0; z < m_chunkSize; ++z)
+			for (int z = 0; z < CHUNK_SIZE; ++z)
 			{
 				// Block Position with the smoothing factor applied to it.
 				// The division by 32 helps "decide" how smooth the generated terrain will be.
 				const qz::Vector3 blockPosWithSmoothingApplied = { 
-					(static_cast<float>(x) + chunkPos.x) / 32.f,
-					(static_cast<float>(z) + chunkPos.z) / 32.f,
-					(static_cast<float>(0) + chunkPos.y) / 32.f
+					static_cast<float>(x + chunkOrigin.x) / 32.f,
+					static_cast<float>(z + chunkOrigin.z) / 32.f,
+					static_cast<float>(chunkOrigin.y) / 32.f
 				};
 
 				const float noise = at(blockPosWithSmoothingApplied);
 
-				const int newY = static_cast<int>(noise * m_chunkSize) % m_chunkSize;
+				const int newY = static_cast<int>(noise * CHUNK_SIZE) & CHUNK_SIZE_MASK;
 
-				blockArray[getVectorIndex(x, newY, z)] = BlockInstance("core:grass");
+				blocks.set(localToIndex({ x, newY, z }), grass);
 
 				for (int y2 = 0; y2 < newY; ++y2)
 				{
-					blockArray[getVectorIndex(x, y2, z)] = BlockInstance("core:dirt");
+					blocks.set(localToIndex({ x, y2, z }), dirt);
 				}
 			}
 		}
 	}
 }
 
+
 float PerlinNoise::fade(float t) const
 {
 	return t * t * t * (t * (t * 6 - 15) + 10);
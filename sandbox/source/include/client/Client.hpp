@@ -38,7 +38,6 @@ namespace client
 
 		void run() override;
 
-		void onEvent(events::Event& event);
 		bool onKeyPress(events::KeyPressedEvent& event);
 
 	private:
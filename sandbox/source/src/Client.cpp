@@ -48,10 +48,15 @@ void Sandbox::run()
 
 	m_camera = new gfx::FPSCamera(window);
 
-	window->registerEventListener(std::bind(&Sandbox::onEvent, this, std::placeholders::_1));
+	window->registerEventListener<events::KeyPressedEvent>([this](events::KeyPressedEvent& event) { return onKeyPress(event); });
+	window->registerEventListener<events::WindowResizeEvent>([this](events::WindowResizeEvent& event) { return m_camera->onWindowResize(event); });
 
 	using namespace gfx::api;
 
+	// Start reading the shaders now, so the disk can get on with it while the buffers are being set up.
+	auto vertexSource = utils::VirtualFileSystem::get()->readAllFileAsync("assets/shaders/main.vert");
+	auto fragmentSource = utils::VirtualFileSystem::get()->readAllFileAsync("assets/shaders/main.frag");
+
 	float vertices[] = {
 		-1.f, -1.f, -3.f,
 		1.f, -1.f, -3.f,
@@ -66,8 +71,8 @@ void Sandbox::run()
 
 	state->attachBuffer(buffer);
 
-	shader->addStage(ShaderType::VERTEX_SHADER, utils::FileIO::readAllFile("assets/shaders/main.vert"));
-	shader->addStage(ShaderType::FRAGMENT_SHADER, utils::FileIO::readAllFile("assets/shaders/main.frag"));
+	shader->addStage(ShaderType::VERTEX_SHADER, vertexSource.get());
+	shader->addStage(ShaderType::FRAGMENT_SHADER, fragmentSource.get());
 	shader->build();
 
 	BufferLayout layout;
@@ -77,15 +82,16 @@ void Sandbox::run()
 
 	const Matrix4x4 model;
 
+	GameLoop loop(window);
+
 	std::size_t fpsLastTime = SDL_GetTicks();
 	int fpsCurrent = 0; // the current FPS.
 	int fpsFrames = 0; // frames passed since the last recorded fps.
 
-	float last = static_cast<float>(SDL_GetTicks());
-	while (window->isRunning())
+	// The camera follows the mouse, so it moves every frame rather than every tick. It is tuned for milliseconds.
+	auto last = std::chrono::steady_clock::now();
+	loop.run([&]()
 	{
-		window->startFrame();
-
 		fpsFrames++;
 		if (fpsLastTime < SDL_GetTicks() - 1000)
 		{
@@ -94,8 +100,8 @@ void Sandbox::run()
 			fpsFrames = 0;
 		}
 
-		const float now = static_cast<float>(SDL_GetTicks());
-		const float dt = now - last;
+		const auto now = std::chrono::steady_clock::now();
+		const float dt = std::chrono::duration<float, std::milli>(now - last).count();
 		last = now;
 
 		m_camera->tick(dt);
@@ -113,17 +119,9 @@ void Sandbox::run()
 		ImGui::Begin("Debug Information");
 		ImGui::Text("FPS: %d", fpsCurrent);
 		ImGui::Text("Frame Time: %f ms", dt);
+		ImGui::Text("Ticks: %llu (%d a second)", static_cast<unsigned long long>(loop.getTickCount()), loop.getTicksPerSecond());
 		ImGui::End();
-
-		window->endFrame();
-	}
-}
-
-void Sandbox::onEvent(events::Event& event)
-{
-	auto test = events::EventDispatcher(event);
-	test.dispatch<events::KeyPressedEvent>(std::bind(&Sandbox::onKeyPress, this, std::placeholders::_1));
-	test.dispatch<events::WindowResizeEvent>(std::bind(&gfx::FPSCamera::onWindowResize, m_camera, std::placeholders::_1));
+	});
 }
 
 bool Sandbox::onKeyPress(events::KeyPressedEvent& event)
@@ -0,0 +1,323 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+// Times compressing assets and reading them back out of an archive, and checks that corrupt or truncated data is
+// rejected rather than read past.
+
+#include "Bench.hpp"
+
+#include <quartz/core/utilities/Archive.hpp>
+#include <quartz/core/utilities/Compression.hpp>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace qz::utils;
+using namespace qz::bench;
+
+namespace
+{
+	const int RUNS = 10;
+
+	// Bytes after the output that decompress() must never write to.
+	const std::size_t GUARD_SIZE = 64;
+	const char GUARD_BYTE = '\x5A';
+
+	const char* ARCHIVE_PATH = "quartz-bench-archive.qzpak";
+	const char* BROKEN_ARCHIVE_PATH = "quartz-bench-archive-broken.qzpak";
+
+	std::string makeText(std::size_t size)
+	{
+		std::string text;
+		for (int line = 0; text.size() < size; ++line)
+			text += "block_id=core:block_" + std::to_string(line % 97) + "; texture=assets/textures/block_" + std::to_string(line % 31) + ".png\n";
+
+		text.resize(size);
+		return text;
+	}
+
+	/**
+	 * @brief Decompresses into a buffer followed by guard bytes, so writing past the end of the output is caught.
+	 * @return Whether decompress() succeeded, overrun is set if it wrote past the end either way.
+	 */
+	bool decompressGuarded(const std::string& compressed, std::size_t size, std::string& out, bool& overrun)
+	{
+		std::vector<char> buffer(size + GUARD_SIZE, GUARD_BYTE);
+		const bool success = Compression::decompress(compressed, buffer.data(), size);
+
+		overrun = false;
+		for (std::size_t i = size; i < buffer.size(); ++i)
+			overrun |= buffer[i] != GUARD_BYTE;
+
+		out.assign(buffer.data(), size);
+		return success;
+	}
+
+	bool roundTrips(const std::string& input)
+	{
+		std::string out;
+		bool overrun;
+
+		return decompressGuarded(Compression::compress(input), input.size(), out, overrun) && !overrun && out == input;
+	}
+
+	std::string readFile(const char* filepath)
+	{
+		std::ifstream file(filepath, std::ios::binary);
+		return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	void writeFile(const char* filepath, const std::string& contents)
+	{
+		std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+		file.write(contents.data(), contents.size());
+	}
+
+	/**
+	 * @brief Writes a copy of the archive with some bytes overwritten, and tries to open it.
+	 */
+	template <typename T>
+	bool opensWithPatch(const std::string& archive, std::size_t offset, const T& value)
+	{
+		std::string broken = archive;
+		std::memcpy(&broken[offset], &value, sizeof(value));
+		writeFile(BROKEN_ARCHIVE_PATH, broken);
+
+		Archive opened;
+		return opened.open(BROKEN_ARCHIVE_PATH);
+	}
+}
+
+int main()
+{
+	Checks checks;
+
+	std::mt19937 random(1);
+
+	for (std::size_t size : { 0, 1, 4, 5, 13, 64, 1000, 70000, 300000 })
+	{
+		std::string noise(size, '\0');
+		for (char& c : noise)
+			c = static_cast<char>(random());
+
+		std::string pairs(size, '\0');
+		for (char& c : pairs)
+			c = "ab"[random() % 2];
+
+		checks.expect(roundTrips(noise), "Random data survives a round trip");
+		checks.expect(roundTrips(std::string(size, 'a')), "A single long run survives a round trip");
+		checks.expect(roundTrips(pairs), "Data made of two symbols survives a round trip");
+		checks.expect(roundTrips(makeText(size)), "Text survives a round trip");
+	}
+
+	const std::string text = makeText(4000);
+	const std::string compressed = Compression::compress(text);
+
+	{
+		std::string out;
+		bool overrun;
+
+		checks.expect(!decompressGuarded(compressed, text.size() - 1, out, overrun) && !overrun, "Decompressing into too small an output fails");
+		checks.expect(!decompressGuarded(compressed, text.size() + 1, out, overrun) && !overrun, "Decompressing into too big an output fails");
+	}
+
+	{
+		int accepted = 0;
+		bool anyOverrun = false;
+
+		for (std::size_t length = 0; length < compressed.size(); ++length)
+		{
+			std::string out;
+			bool overrun;
+
+			accepted += decompressGuarded(compressed.substr(0, length), text.size(), out, overrun);
+			anyOverrun |= overrun;
+		}
+
+		checks.expect(accepted == 0, "Every truncated stream is rejected");
+		checks.expect(!anyOverrun, "Truncated streams never write past the output");
+	}
+
+	{
+		// A flipped bit can still make a valid stream, just with the wrong contents, so only overruns are failures.
+		int rejected = 0;
+		bool anyOverrun = false;
+
+		const int CORRUPTIONS = 2000;
+		for (int i = 0; i < CORRUPTIONS; ++i)
+		{
+			std::string corrupt = compressed;
+			corrupt[random() % corrupt.size()] ^= static_cast<char>(1 << (random() % 8));
+
+			std::string out;
+			bool overrun;
+
+			rejected += !decompressGuarded(corrupt, text.size(), out, overrun);
+			anyOverrun |= overrun;
+		}
+
+		checks.expect(!anyOverrun, "Corrupt streams never write past the output");
+		std::printf("Rejected %d of %d corrupt streams\n", rejected, CORRUPTIONS);
+	}
+
+	{
+		const std::string large = makeText(8 << 20);
+		const double megabytes = large.size() / (1024.0 * 1024.0);
+
+		std::string packed;
+		const double compressMs = measure(RUNS, [&]() { packed = Compression::compress(large); });
+
+		std::string unpacked(large.size(), '\0');
+		bool success = false;
+		const double decompressMs = measure(RUNS, [&]() { success = Compression::decompress(packed, &unpacked[0], unpacked.size()); });
+
+		checks.expect(success && unpacked == large, "Large text survives a round trip");
+
+		std::printf("Compress    %8.1f MB/s (ratio %.3f)\n", megabytes / (compressMs / 1000.0), packed.size() / static_cast<double>(large.size()));
+		std::printf("Decompress  %8.1f MB/s\n", megabytes / (decompressMs / 1000.0));
+	}
+
+	// An archive of many small files, like the packed assets, plus an empty file and one that doesn't compress.
+	const int FILE_COUNT = 2000;
+
+	ArchiveWriter writer;
+	std::vector<std::string> paths;
+	std::vector<std::string> contents;
+
+	for (int i = 0; i < FILE_COUNT; ++i)
+	{
+		paths.push_back("assets/configs/file_" + std::to_string(i) + ".ini");
+		contents.push_back(makeText(200 + (i % 50) * 40));
+	}
+
+	std::string noise(5000, '\0');
+	for (char& c : noise)
+		c = static_cast<char>(random());
+
+	paths.push_back("assets/textures/noise.png");
+	contents.push_back(noise);
+
+	paths.push_back("assets/empty.txt");
+	contents.push_back("");
+
+	for (std::size_t i = 0; i < paths.size(); ++i)
+		writer.add(paths[i], contents[i]);
+
+	checks.expect(writer.write(ARCHIVE_PATH), "The archive is written");
+
+	{
+		Archive archive;
+		std::size_t mismatches = 0;
+
+		const double ms = measure(RUNS, [&]()
+		{
+			archive.open(ARCHIVE_PATH);
+
+			mismatches = 0;
+			for (std::size_t i = 0; i < paths.size(); ++i)
+			{
+				const ArchiveEntry* entry = archive.find(paths[i]);
+
+				std::string out;
+				if (entry == nullptr || !archive.read(*entry, out) || out != contents[i])
+					++mismatches;
+			}
+		});
+
+		checks.expect(archive.isOpen() && archive.getEntryCount() == paths.size(), "The archive opens with every file in it");
+		checks.expect(mismatches == 0, "Every file reads back the same as it was added");
+		checks.expect(archive.find("assets/missing.txt") == nullptr, "A file that wasn't added isn't found");
+		checks.expect(archive.find(Archive::normalizePath(".\\assets\\empty.txt")) != nullptr, "Paths are found once normalised");
+
+		std::printf("Open and read %zu files   %8.3f ms\n", paths.size(), ms);
+	}
+
+	const std::string archive = readFile(ARCHIVE_PATH);
+	const std::size_t firstEntry = sizeof(ArchiveHeader);
+
+	{
+		Archive opened;
+		checks.expect(!opened.open("quartz-bench-archive-missing.qzpak"), "A missing archive doesn't open");
+
+		writeFile(BROKEN_ARCHIVE_PATH, "");
+		checks.expect(!opened.open(BROKEN_ARCHIVE_PATH) && !opened.isOpen(), "An empty file doesn't open");
+
+		writeFile(BROKEN_ARCHIVE_PATH, archive.substr(0, firstEntry + sizeof(ArchiveEntry) * FILE_COUNT / 2));
+		checks.expect(!opened.open(BROKEN_ARCHIVE_PATH), "A truncated archive doesn't open");
+	}
+
+	checks.expect(!opensWithPatch(archive, offsetof(ArchiveHeader, magic), ARCHIVE_MAGIC[0] ^ 1), "An archive with the wrong magic doesn't open");
+	checks.expect(!opensWithPatch(archive, offsetof(ArchiveHeader, version), ARCHIVE_VERSION + 1), "An archive from another version doesn't open");
+	checks.expect(!opensWithPatch(archive, offsetof(ArchiveHeader, entryCount), std::uint32_t(0x10000000)), "An archive with too many entries doesn't open");
+
+	checks.expect(!opensWithPatch(archive, firstEntry + offsetof(ArchiveEntry, offset), std::uint64_t(archive.size() + 1)), "An entry starting past the end doesn't open");
+	checks.expect(!opensWithPatch(archive, firstEntry + offsetof(ArchiveEntry, storedSize), std::uint64_t(archive.size())), "An entry running past the end doesn't open");
+	checks.expect(!opensWithPatch(archive, firstEntry + offsetof(ArchiveEntry, nameOffset), std::uint32_t(0xFFFFFFF0)), "An entry whose path is past the names doesn't open");
+
+	{
+		// Stored entries are read as is, so their size has to match what was stored.
+		Archive clean;
+		clean.open(ARCHIVE_PATH);
+
+		const ArchiveEntry* stored = clean.find("assets/textures/noise.png");
+		checks.expect(stored != nullptr && !(stored->flags & ARCHIVE_ENTRY_COMPRESSED), "Data that doesn't compress is stored as is");
+
+		if (stored != nullptr)
+		{
+			const std::size_t sizeOffset = firstEntry + (stored - clean.getEntries()) * sizeof(ArchiveEntry) + offsetof(ArchiveEntry, size);
+			checks.expect(!opensWithPatch(archive, sizeOffset, stored->size + 1), "A stored entry with the wrong size doesn't open");
+		}
+
+		// A compressed entry can only be checked when it's decompressed, so the archive opens but reading fails.
+		const ArchiveEntry* packed = clean.find(paths[0]);
+		checks.expect(packed != nullptr && (packed->flags & ARCHIVE_ENTRY_COMPRESSED), "Text is stored compressed");
+
+		if (packed != nullptr)
+		{
+			std::string broken = archive;
+			broken.resize(packed->offset);
+			broken.append(packed->storedSize, '\xFF');
+			broken.append(archive, broken.size(), std::string::npos);
+			writeFile(BROKEN_ARCHIVE_PATH, broken);
+
+			Archive opened;
+			std::string out;
+
+			checks.expect(opened.open(BROKEN_ARCHIVE_PATH), "An archive with corrupt compressed data still opens");
+
+			const ArchiveEntry* entry = opened.find(paths[0]);
+			checks.expect(entry != nullptr && !opened.read(*entry, out) && out.empty(), "Reading corrupt compressed data fails");
+		}
+	}
+
+	std::remove(ARCHIVE_PATH);
+	std::remove(BROKEN_ARCHIVE_PATH);
+
+	return checks.getFailures();
+}
@@ -0,0 +1,84 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+#pragma once
+
+// Shared helpers for the benchmarks in tools/bench.
+//
+// Every benchmark also checks that what it measured gives the right results, and returns the number of failed checks
+// from main, so running them as tests catches a fast but wrong change.
+
+#include <chrono>
+#include <cstdio>
+
+namespace qz
+{
+	namespace bench
+	{
+		/**
+		 * @brief Runs a function a number of times and returns the fastest run, which is the least disturbed by
+		 * everything else running on the machine.
+		 * @param runs How many times to run the function.
+		 * @param function The function to time.
+		 * @return The time of the fastest run, in milliseconds.
+		 */
+		template <typename Function>
+		double measure(int runs, Function&& function)
+		{
+			double best = 0.0;
+
+			for (int run = 0; run < runs; ++run)
+			{
+				const auto start = std::chrono::steady_clock::now();
+				function();
+				const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+				if (run == 0 || elapsed < best)
+					best = elapsed;
+			}
+
+			return best;
+		}
+
+		/**
+		 * @brief Counts the checks that failed, and prints what they were.
+		 */
+		class Checks
+		{
+		public:
+			void expect(bool condition, const char* what)
+			{
+				if (!condition)
+				{
+					std::printf("FAILED: %s\n", what);
+					++m_failures;
+				}
+			}
+
+			int getFailures() const { return m_failures; }
+
+		private:
+			int m_failures = 0;
+		};
+	}
+}
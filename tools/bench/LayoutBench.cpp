@@ -0,0 +1,221 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+// Compares the block layouts a chunk can be stored in, on the neighbour lookups the mesher and the light engine make.
+// Cache misses are counted on Linux, where the kernel exposes the hardware counters.
+
+#include "Bench.hpp"
+
+#include <quartz/core/QuartzPCH.hpp>
+#include <quartz/voxels/BlockStorage.hpp>
+
+#if defined(QZ_PLATFORM_LINUX)
+#	include <linux/perf_event.h>
+#	include <sys/ioctl.h>
+#	include <sys/syscall.h>
+#	include <unistd.h>
+#endif
+
+#include <cstdint>
+#include <vector>
+
+using namespace qz;
+using namespace qz::voxels;
+using namespace qz::bench;
+
+namespace
+{
+	const int CHUNK_COUNT = 64;
+	const int RUNS = 15;
+
+	const Vector3i NEIGHBOUR_OFFSETS[] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+
+	/**
+	 * @brief Counts L1 data cache misses while it's alive, if the platform lets us.
+	 */
+	class CacheMissCounter
+	{
+	public:
+		CacheMissCounter()
+		{
+#if defined(QZ_PLATFORM_LINUX)
+			perf_event_attr attributes = {};
+			attributes.type = PERF_TYPE_HW_CACHE;
+			attributes.size = sizeof(attributes);
+			attributes.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+			attributes.disabled = 1;
+			attributes.exclude_kernel = 1;
+			attributes.exclude_hv = 1;
+
+			m_fd = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+			if (m_fd != -1)
+			{
+				ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+				ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+			}
+#endif
+		}
+
+		~CacheMissCounter()
+		{
+#if defined(QZ_PLATFORM_LINUX)
+			if (m_fd != -1)
+				close(m_fd);
+#endif
+		}
+
+		/**
+		 * @brief Gets the number of misses so far, or -1 if they can't be counted.
+		 */
+		long long read() const
+		{
+#if defined(QZ_PLATFORM_LINUX)
+			long long count = 0;
+			if (m_fd != -1 && ::read(m_fd, &count, sizeof(count)) == sizeof(count))
+				return count;
+#endif
+			return -1;
+		}
+
+	private:
+		int m_fd = -1;
+	};
+
+	/**
+	 * @brief Fills a chunk with noise, decided by position so every layout holds the same blocks.
+	 */
+	template <typename Storage>
+	void fillChunk(Storage& storage, int seed, const BlockInstance& solid)
+	{
+		for (int z = 0; z < CHUNK_SIZE; ++z)
+		{
+			for (int y = 0; y < CHUNK_SIZE; ++y)
+			{
+				for (int x = 0; x < CHUNK_SIZE; ++x)
+				{
+					std::uint32_t hash = static_cast<std::uint32_t>(seed) * 73856093u ^ static_cast<std::uint32_t>(x) * 19349663u
+						^ static_cast<std::uint32_t>(y) * 83492791u ^ static_cast<std::uint32_t>(z) * 50331653u;
+					hash ^= hash >> 13;
+					hash *= 0x5bd1e995u;
+					hash ^= hash >> 15;
+
+					if (hash & 1u)
+						storage.set(Storage::getIndex({ x, y, z }), solid);
+				}
+			}
+		}
+	}
+
+	template <typename Layout>
+	bool isBijective()
+	{
+		for (std::size_t index = 0; index < CHUNK_VOLUME; ++index)
+		{
+			const Vector3i local = Layout::toLocal(index);
+			if (!isLocalInBounds(local) || Layout::toIndex(local) != index)
+				return false;
+		}
+
+		return true;
+	}
+
+	/**
+	 * @brief Visits every solid block in storage order and looks at its neighbours, the way the mesher does.
+	 * @return The number of solid neighbours found, the same for every layout.
+	 */
+	template <typename Layout>
+	long long runLayout(const char* name, Checks& checks)
+	{
+		using Storage = BasicBlockStorage<Layout>;
+
+		checks.expect(isBijective<Layout>(), "Every block of a chunk has its own index");
+
+		const BlockInstance air("core:air");
+		const BlockInstance dirt("core:dirt");
+
+		std::vector<Storage> chunks;
+		chunks.reserve(CHUNK_COUNT);
+		for (int i = 0; i < CHUNK_COUNT; ++i)
+		{
+			chunks.emplace_back(air);
+			fillChunk(chunks.back(), i, dirt);
+		}
+
+		long long solidNeighbours = 0;
+		long long misses = -1;
+
+		const double ms = measure(RUNS, [&]()
+		{
+			const CacheMissCounter counter;
+
+			solidNeighbours = 0;
+			for (const Storage& chunk : chunks)
+			{
+				for (std::size_t index = 0; index < CHUNK_VOLUME; ++index)
+				{
+					if (chunk.get(index).getBlockType() == BlockType::GAS)
+						continue;
+
+					const Vector3i local = Storage::getLocal(index);
+					for (const Vector3i& offset : NEIGHBOUR_OFFSETS)
+					{
+						const Vector3i neighbour = local + offset;
+						if (isLocalInBounds(neighbour) && chunk.get(Storage::getIndex(neighbour)).getBlockType() == BlockType::SOLID)
+							++solidNeighbours;
+					}
+				}
+			}
+
+			const long long runMisses = counter.read();
+			if (misses == -1 || (runMisses != -1 && runMisses < misses))
+				misses = runMisses;
+		});
+
+		const double blocks = static_cast<double>(CHUNK_COUNT) * CHUNK_VOLUME;
+
+		if (misses == -1)
+			std::printf("%-8s %8.3f ms %8.2f Mblocks/s   L1 misses per block: n/a\n", name, ms, blocks / ms / 1000.0);
+		else
+			std::printf("%-8s %8.3f ms %8.2f Mblocks/s   L1 misses per block: %.3f\n", name, ms, blocks / ms / 1000.0, misses / blocks);
+
+		return solidNeighbours;
+	}
+}
+
+int main()
+{
+	Checks checks;
+
+	BlockLibrary* library = BlockLibrary::get();
+	library->init();
+	library->registerBlock(RegistryBlock("core:air", "Air", 1, BlockType::GAS));
+	library->registerBlock(RegistryBlock("core:dirt", "Dirt", 1, BlockType::SOLID));
+
+	const long long linear = runLayout<LinearLayout>("Linear", checks);
+	const long long morton = runLayout<MortonLayout>("Morton", checks);
+	const long long brick = runLayout<BrickLayout>("Brick", checks);
+
+	checks.expect(linear == morton && linear == brick, "Every layout holds the same blocks");
+
+	return checks.getFailures();
+}
@@ -0,0 +1,217 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+// Times the flood fill lighting for a freshly generated chunk and for single block edits, and checks the result
+// against a brute force reference after every change.
+
+#include "Bench.hpp"
+
+#include <quartz/core/QuartzPCH.hpp>
+#include <quartz/voxels/ChunkManager.hpp>
+#include <quartz/voxels/LightEngine.hpp>
+
+#include <algorithm>
+#include <vector>
+
+using namespace qz;
+using namespace qz::voxels;
+using namespace qz::bench;
+
+namespace
+{
+	// ChunkManager::testGeneration() loads the chunks from (0, 0, 0) to (4, 0, 0).
+	const int WORLD_WIDTH = 5 * CHUNK_SIZE;
+
+	const int RUNS = 20;
+
+	/**
+	 * @brief Lights the test world by relaxing every block until nothing changes, as a slow but obvious reference.
+	 * @return The number of blocks whose light differs from what the engine worked out.
+	 */
+	int countLightErrors(const ChunkManager& world)
+	{
+		const auto index = [](int x, int y, int z) { return x + WORLD_WIDTH * (y + CHUNK_SIZE * z); };
+		const std::size_t volume = static_cast<std::size_t>(WORLD_WIDTH) * CHUNK_SIZE * CHUNK_SIZE;
+
+		std::vector<bool> solid(volume);
+		std::vector<int> emission(volume), sky(volume, 0), block(volume, 0);
+
+		for (int z = 0; z < CHUNK_SIZE; ++z)
+		{
+			for (int y = 0; y < CHUNK_SIZE; ++y)
+			{
+				for (int x = 0; x < WORLD_WIDTH; ++x)
+				{
+					const BlockInstance instance = world.getBlockAt({ x, y, z });
+					solid[index(x, y, z)] = instance.getBlockType() == BlockType::SOLID;
+					emission[index(x, y, z)] = instance.getLightEmission();
+				}
+			}
+		}
+
+		const Vector3i offsets[] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+
+		bool changed = true;
+		while (changed)
+		{
+			changed = false;
+
+			for (int z = 0; z < CHUNK_SIZE; ++z)
+			{
+				for (int y = 0; y < CHUNK_SIZE; ++y)
+				{
+					for (int x = 0; x < WORLD_WIDTH; ++x)
+					{
+						const int i = index(x, y, z);
+
+						// Solid blocks are dark, unless they glow.
+						int skyLevel = 0;
+						int blockLevel = emission[i];
+
+						if (!solid[i])
+						{
+							// Nothing is loaded above the world, so the top is open to the sky, which falls straight down.
+							skyLevel = (y == CHUNK_SIZE - 1 || sky[index(x, y + 1, z)] == LightMap::MAX_LIGHT) ? LightMap::MAX_LIGHT : 0;
+
+							for (const Vector3i& offset : offsets)
+							{
+								const Vector3i n = Vector3i(x, y, z) + offset;
+								if (n.x < 0 || n.x >= WORLD_WIDTH || n.y < 0 || n.y >= CHUNK_SIZE || n.z < 0 || n.z >= CHUNK_SIZE)
+									continue;
+
+								skyLevel = std::max(skyLevel, sky[index(n.x, n.y, n.z)] - 1);
+								blockLevel = std::max(blockLevel, block[index(n.x, n.y, n.z)] - 1);
+							}
+						}
+
+						if (skyLevel > sky[i] || blockLevel > block[i])
+						{
+							sky[i] = std::max(sky[i], skyLevel);
+							block[i] = std::max(block[i], blockLevel);
+							changed = true;
+						}
+					}
+				}
+			}
+		}
+
+		int errors = 0;
+		for (int z = 0; z < CHUNK_SIZE; ++z)
+		{
+			for (int y = 0; y < CHUNK_SIZE; ++y)
+			{
+				for (int x = 0; x < WORLD_WIDTH; ++x)
+				{
+					const int packed = world.getLightAt({ x, y, z });
+					if ((packed >> 4) != sky[index(x, y, z)] || (packed & 0x0F) != block[index(x, y, z)])
+						++errors;
+				}
+			}
+		}
+
+		return errors;
+	}
+}
+
+int main()
+{
+	Checks checks;
+
+	BlockLibrary* library = BlockLibrary::get();
+	library->init();
+	library->registerBlock(RegistryBlock("core:air", "Air", 1, BlockType::GAS));
+	library->registerBlock(RegistryBlock("core:grass", "Grass", 1, BlockType::SOLID));
+	library->registerBlock(RegistryBlock("core:dirt", "Dirt", 1, BlockType::SOLID));
+
+	RegistryBlock torch("bench:torch", "Torch", 1, BlockType::OBJECT);
+	torch.setLightEmission(14);
+	library->registerBlock(torch);
+
+	RegistryBlock glowstone("bench:glowstone", "Glowstone", 1, BlockType::SOLID);
+	glowstone.setLightEmission(9);
+	library->registerBlock(glowstone);
+
+	ChunkManager world("core:air", 7);
+	world.testGeneration();
+
+	checks.expect(countLightErrors(world) == 0, "The generated terrain is lit correctly");
+
+	// Relighting the middle chunk from scratch, with its neighbours already lit as they would be while loading.
+	{
+		LightEngine engine(&world);
+		Chunk* chunk = world.getChunk({ 2, 0, 0 });
+
+		const double fresh = measure(RUNS, [&]() { engine.lightChunk(chunk); });
+		std::printf("Light a freshly generated chunk      %8.3f ms\n", fresh);
+
+		checks.expect(countLightErrors(world) == 0, "Relighting a chunk gives the same light");
+	}
+
+	// A roof over most of the world, so the edits below have dark areas to light up.
+	world.fillRegion({ 5, 12, 3 }, { 60, 12, 12 }, BlockInstance("core:dirt"));
+	checks.expect(countLightErrors(world) == 0, "Building a roof shades the ground under it");
+
+	const BlockInstance air("core:air");
+	const BlockInstance dirt("core:dirt");
+	const BlockInstance torchBlock("bench:torch");
+
+	{
+		const double place = measure(RUNS, [&]()
+		{
+			world.setBlockAt({ 20, 11, 6 }, torchBlock);
+			world.setBlockAt({ 20, 11, 6 }, air);
+		});
+
+		world.setBlockAt({ 20, 11, 6 }, torchBlock);
+		checks.expect(countLightErrors(world) == 0, "Placing a torch lights the area around it");
+
+		world.setBlockAt({ 20, 11, 6 }, air);
+		checks.expect(countLightErrors(world) == 0, "Removing a torch floods its light back out");
+
+		std::printf("Place and remove a torch             %8.3f ms\n", place);
+	}
+
+	{
+		const double hole = measure(RUNS, [&]()
+		{
+			world.setBlockAt({ 30, 12, 7 }, air);
+			world.setBlockAt({ 30, 12, 7 }, dirt);
+		});
+
+		world.setBlockAt({ 30, 12, 7 }, air);
+		checks.expect(countLightErrors(world) == 0, "A hole in the roof lets the sky in");
+
+		world.setBlockAt({ 30, 12, 7 }, dirt);
+		checks.expect(countLightErrors(world) == 0, "Closing the hole shades the ground again");
+
+		std::printf("Open and close a hole in the roof    %8.3f ms\n", hole);
+	}
+
+	world.setBlockAt({ 40, 11, 6 }, BlockInstance("bench:glowstone"));
+	checks.expect(countLightErrors(world) == 0, "A glowing solid block lights its surroundings");
+
+	world.fillRegion({ 5, 12, 3 }, { 60, 12, 12 }, air);
+	checks.expect(countLightErrors(world) == 0, "Taking the roof away lets the sky back in");
+
+	return checks.getFailures();
+}
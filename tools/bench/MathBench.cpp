@@ -0,0 +1,330 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+// Times the camera and culling math in Matrix4x4 and Vector3, and checks it against plain scalar reference code.
+//
+// This is built twice, as quartz-bench-math with whichever SIMD instruction set the compiler targets and as
+// quartz-bench-math-scalar with QZ_SIMD_DISABLE, so comparing the two shows what the SIMD paths are worth. The
+// reference code here is the same in both, so it is also a baseline within each run.
+
+#include "Bench.hpp"
+
+#include <quartz/core/math/Matrix4x4.hpp>
+#include <quartz/core/math/SIMD.hpp>
+#include <quartz/core/math/Vector3.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace qz::math;
+using namespace qz::bench;
+
+namespace
+{
+	// How many matrices and points each timed run works through.
+	const int MATRIX_COUNT = 100000;
+	const int POINT_COUNT = 100000;
+
+	const int RUNS = 10;
+
+	const char* getInstructionSet()
+	{
+#if defined(QZ_SIMD_SSE)
+		return "SSE2";
+#elif defined(QZ_SIMD_NEON)
+		return "NEON";
+#else
+		return "scalar";
+#endif
+	}
+
+	// Elements are stored a column at a time, so element (row, column) is at row + column * 4.
+	Matrix4x4 referenceMultiply(const Matrix4x4& lhs, const Matrix4x4& rhs)
+	{
+		Matrix4x4 result;
+
+		for (int row = 0; row < 4; ++row)
+		{
+			for (int column = 0; column < 4; ++column)
+			{
+				float sum = 0.f;
+				for (int k = 0; k < 4; ++k)
+					sum += lhs.elements[row + k * 4] * rhs.elements[k + column * 4];
+
+				result.elements[row + column * 4] = sum;
+			}
+		}
+
+		return result;
+	}
+
+	// Gauss-Jordan elimination in double precision, slow but easy to trust.
+	Matrix4x4 referenceInverse(const Matrix4x4& matrix)
+	{
+		double augmented[4][8];
+
+		for (int row = 0; row < 4; ++row)
+		{
+			for (int column = 0; column < 4; ++column)
+			{
+				augmented[row][column] = matrix.elements[row + column * 4];
+				augmented[row][column + 4] = row == column ? 1.0 : 0.0;
+			}
+		}
+
+		for (int column = 0; column < 4; ++column)
+		{
+			int pivot = column;
+			for (int row = column + 1; row < 4; ++row)
+			{
+				if (std::abs(augmented[row][column]) > std::abs(augmented[pivot][column]))
+					pivot = row;
+			}
+
+			std::swap(augmented[column], augmented[pivot]);
+
+			const double scale = 1.0 / augmented[column][column];
+			for (double& value : augmented[column])
+				value *= scale;
+
+			for (int row = 0; row < 4; ++row)
+			{
+				if (row == column)
+					continue;
+
+				const double factor = augmented[row][column];
+				for (int k = 0; k < 8; ++k)
+					augmented[row][k] -= factor * augmented[column][k];
+			}
+		}
+
+		Matrix4x4 result;
+		for (int row = 0; row < 4; ++row)
+		{
+			for (int column = 0; column < 4; ++column)
+				result.elements[row + column * 4] = static_cast<float>(augmented[row][column + 4]);
+		}
+
+		return result;
+	}
+
+	Vector3 referenceTransformPoint(const Matrix4x4& matrix, const Vector3& point)
+	{
+		const float* m = matrix.elements;
+
+		return {
+			m[0] * point.x + m[4] * point.y + m[8] * point.z + m[12],
+			m[1] * point.x + m[5] * point.y + m[9] * point.z + m[13],
+			m[2] * point.x + m[6] * point.y + m[10] * point.z + m[14]
+		};
+	}
+
+	// The largest difference between two matrices, relative to the size of the values being compared.
+	float matrixError(const Matrix4x4& a, const Matrix4x4& b)
+	{
+		float error = 0.f;
+		for (int i = 0; i < 16; ++i)
+			error = std::max(error, std::abs(a.elements[i] - b.elements[i]) / std::max(1.f, std::abs(b.elements[i])));
+
+		return error;
+	}
+
+	float vectorError(const Vector3& a, const Vector3& b)
+	{
+		const float scale = std::max({ 1.f, std::abs(b.x), std::abs(b.y), std::abs(b.z) });
+		return std::max({ std::abs(a.x - b.x), std::abs(a.y - b.y), std::abs(a.z - b.z) }) / scale;
+	}
+
+	// A camera looking at a random point, as the renderer would build each frame.
+	Matrix4x4 randomViewProjection(std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> position(-500.f, 500.f);
+
+		const Matrix4x4 projection = Matrix4x4::perspective(16.f / 9.f, 70.f, 1000.f, 0.1f);
+		const Matrix4x4 view = Matrix4x4::lookAt(
+			{ position(random), position(random), position(random) },
+			{ position(random), position(random), position(random) },
+			{ 0.f, 1.f, 0.f });
+
+		return projection * view;
+	}
+
+	void report(const char* name, double engine, double reference, int count)
+	{
+		std::printf("%-24s %8.2f ns   reference %8.2f ns   %5.2fx\n", name,
+			engine * 1e6 / count, reference * 1e6 / count, reference / engine);
+	}
+}
+
+int main()
+{
+	Checks checks;
+	std::mt19937 random(27);
+
+	std::printf("Math kernels built for %s\n\n", getInstructionSet());
+
+	std::vector<Matrix4x4> lhs, rhs;
+	for (int i = 0; i < MATRIX_COUNT; ++i)
+	{
+		lhs.push_back(randomViewProjection(random));
+		rhs.push_back(randomViewProjection(random));
+	}
+
+	std::vector<Matrix4x4> results(MATRIX_COUNT), expected(MATRIX_COUNT);
+
+	// Multiplying the camera matrices together, once per frame per camera or per shadow cascade.
+	{
+		const double engine = measure(RUNS, [&]()
+		{
+			for (int i = 0; i < MATRIX_COUNT; ++i)
+				results[i] = lhs[i] * rhs[i];
+		});
+
+		const double reference = measure(RUNS, [&]()
+		{
+			for (int i = 0; i < MATRIX_COUNT; ++i)
+				expected[i] = referenceMultiply(lhs[i], rhs[i]);
+		});
+
+		report("Matrix4x4 multiply", engine, reference, MATRIX_COUNT);
+
+		float error = 0.f;
+		for (int i = 0; i < MATRIX_COUNT; ++i)
+		{
+			Matrix4x4 inPlace = lhs[i];
+			inPlace *= rhs[i];
+
+			error = std::max({ error, matrixError(results[i], expected[i]), matrixError(inPlace, expected[i]) });
+		}
+
+		checks.expect(error < 1e-5f, "Matrix4x4 multiply matches the reference");
+	}
+
+	// Inverting the view projection, to turn screen positions back into rays.
+	{
+		const double engine = measure(RUNS, [&]()
+		{
+			for (int i = 0; i < MATRIX_COUNT; ++i)
+				results[i] = lhs[i].inverse();
+		});
+
+		const double reference = measure(RUNS, [&]()
+		{
+			for (int i = 0; i < MATRIX_COUNT; ++i)
+				expected[i] = referenceInverse(lhs[i]);
+		});
+
+		report("Matrix4x4 inverse", engine, reference, MATRIX_COUNT);
+
+		float error = 0.f;
+		for (int i = 0; i < MATRIX_COUNT; ++i)
+			error = std::max(error, matrixError(results[i], expected[i]));
+
+		checks.expect(error < 1e-3f, "Matrix4x4 inverse matches the reference");
+	}
+
+	// Transforming the corners of chunk bounding boxes for frustum culling.
+	std::vector<Vector3> points(POINT_COUNT), transformed(POINT_COUNT), expectedPoints(POINT_COUNT);
+	{
+		std::uniform_real_distribution<float> coordinate(-1000.f, 1000.f);
+		for (Vector3& point : points)
+			point = { coordinate(random), coordinate(random), coordinate(random) };
+
+		const Matrix4x4& viewProjection = lhs[0];
+
+		const double engine = measure(RUNS, [&]()
+		{
+			viewProjection.transformPoints(points.data(), transformed.data(), POINT_COUNT);
+		});
+
+		const double reference = measure(RUNS, [&]()
+		{
+			for (int i = 0; i < POINT_COUNT; ++i)
+				expectedPoints[i] = referenceTransformPoint(viewProjection, points[i]);
+		});
+
+		report("transformPoints", engine, reference, POINT_COUNT);
+
+		float error = 0.f;
+		for (int i = 0; i < POINT_COUNT; ++i)
+		{
+			error = std::max(error, vectorError(transformed[i], expectedPoints[i]));
+			error = std::max(error, vectorError(viewProjection.transformPoint(points[i]), expectedPoints[i]));
+		}
+
+		checks.expect(error < 1e-5f, "transformPoints matches the reference");
+	}
+
+	// Testing points against a culling plane, one dot product each.
+	{
+		std::vector<Vector3> normals(POINT_COUNT, Vector3(0.267f, 0.534f, 0.801f));
+		std::vector<float> dots(POINT_COUNT), expectedDots(POINT_COUNT);
+
+		const double engine = measure(RUNS, [&]()
+		{
+			Vector3::dotProducts(points.data(), normals.data(), dots.data(), POINT_COUNT);
+		});
+
+		const double reference = measure(RUNS, [&]()
+		{
+			for (int i = 0; i < POINT_COUNT; ++i)
+				expectedDots[i] = points[i].x * normals[i].x + points[i].y * normals[i].y + points[i].z * normals[i].z;
+		});
+
+		report("Vector3::dotProducts", engine, reference, POINT_COUNT);
+
+		float error = 0.f;
+		for (int i = 0; i < POINT_COUNT; ++i)
+			error = std::max(error, std::abs(dots[i] - expectedDots[i]) / std::max(1.f, std::abs(expectedDots[i])));
+
+		checks.expect(error < 1e-5f, "Vector3::dotProducts matches the reference");
+	}
+
+	// Moving every point by the same offset, such as when the world origin is shifted.
+	{
+		std::vector<Vector3> offsets(POINT_COUNT, Vector3(16.f, -8.f, 4.f));
+
+		const double engine = measure(RUNS, [&]()
+		{
+			Vector3::add(points.data(), offsets.data(), transformed.data(), POINT_COUNT);
+		});
+
+		const double reference = measure(RUNS, [&]()
+		{
+			for (int i = 0; i < POINT_COUNT; ++i)
+				expectedPoints[i] = { points[i].x + offsets[i].x, points[i].y + offsets[i].y, points[i].z + offsets[i].z };
+		});
+
+		report("Vector3::add", engine, reference, POINT_COUNT);
+
+		bool same = true;
+		for (int i = 0; i < POINT_COUNT; ++i)
+			same = same && transformed[i].x == expectedPoints[i].x && transformed[i].y == expectedPoints[i].y && transformed[i].z == expectedPoints[i].z;
+
+		checks.expect(same, "Vector3::add matches the reference exactly");
+	}
+
+	return checks.getFailures();
+}
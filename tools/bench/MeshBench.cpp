@@ -0,0 +1,109 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+// Times meshing the test world at full detail. Built once as is and once with QZ_VOXEL_DISABLE_AO, so the two runs
+// give the cost of ambient occlusion.
+
+#include "Bench.hpp"
+
+#include <quartz/core/QuartzPCH.hpp>
+#include <quartz/voxels/ChunkManager.hpp>
+
+#include <vector>
+
+using namespace qz;
+using namespace qz::voxels;
+using namespace qz::bench;
+
+namespace
+{
+	const int RUNS = 30;
+	const int MESHES_PER_RUN = 40;
+}
+
+int main()
+{
+	Checks checks;
+
+	BlockLibrary* library = BlockLibrary::get();
+	library->init();
+	library->registerBlock(RegistryBlock("core:air", "Air", 1, BlockType::GAS));
+
+	for (const char* id : { "core:grass", "core:dirt" })
+	{
+		RegistryBlock block(id, id, 1, BlockType::SOLID);
+		block.setBlockTextures({ "right", "left", "back", "front", "bottom", "top" });
+		library->registerBlock(block);
+	}
+
+	ChunkManager world("core:air", 7);
+	world.testGeneration();
+
+	// Some overhangs and pillars, so there are corners to occlude beyond the hills of the terrain.
+	world.fillRegion({ 10, 11, 2 }, { 50, 11, 6 }, BlockInstance("core:dirt"));
+	for (int x = 12; x < 70; x += 7)
+		world.fillRegion({ x, 0, 10 }, { x, 14, 10 }, BlockInstance("core:dirt"));
+
+	std::vector<Chunk*> chunks;
+	for (int x = 0; x < 5; ++x)
+		chunks.push_back(world.getChunk({ x, 0, 0 }));
+
+	const double total = measure(RUNS, [&]()
+	{
+		for (int i = 0; i < MESHES_PER_RUN; ++i)
+		{
+			for (Chunk* chunk : chunks)
+				chunk->buildMesh();
+		}
+	});
+
+	std::size_t triangles = 0;
+	std::size_t occludedVertices = 0;
+
+	for (Chunk* chunk : chunks)
+	{
+		const Mesh& mesh = chunk->getBlockRenderer().getMesh();
+
+		triangles += mesh.triangleCount();
+		for (const ChunkVert3D& vertex : mesh.vertices)
+		{
+			if (vertex.shading.z < 1.f)
+				++occludedVertices;
+		}
+	}
+
+#if defined(QZ_VOXEL_DISABLE_AO)
+	const char* mode = "without ambient occlusion";
+	checks.expect(occludedVertices == 0, "No corners are occluded with ambient occlusion disabled");
+#else
+	const char* mode = "with ambient occlusion";
+	checks.expect(occludedVertices > 0, "The terrain has occluded corners");
+#endif
+
+	checks.expect(triangles > 0, "The terrain has something to draw");
+
+	std::printf("Mesh a chunk %-26s %8.3f ms (%zu triangles, %zu occluded vertices)\n",
+		mode, total / (MESHES_PER_RUN * chunks.size()), triangles, occludedVertices);
+
+	return checks.getFailures();
+}
@@ -0,0 +1,199 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+// Times a physics tick with thousands of bodies, and checks the collision edge cases that are easy to break when
+// optimising it: tunnelling through walls, climbing steps and falling faster than terminal velocity.
+
+#include "Bench.hpp"
+
+#include <quartz/core/QuartzPCH.hpp>
+#include <quartz/voxels/ChunkManager.hpp>
+
+#include <algorithm>
+#include <random>
+
+using namespace qz;
+using namespace qz::voxels;
+using namespace qz::bench;
+
+namespace
+{
+	// ChunkManager::testGeneration() loads the chunks from (0, 0, 0) to (4, 0, 0), anything outside them is solid.
+	const int WORLD_WIDTH = 5 * CHUNK_SIZE;
+	const int FLOOR_HEIGHT = 4;
+
+	const int BODY_COUNT = 4096;
+	const int TICKS_PER_RUN = 60;
+	const int RUNS = 5;
+
+	// A little slack for floating point error in the positions the collider works out.
+	const float EPSILON = 0.001f;
+
+	/**
+	 * @brief Runs a body for a number of ticks on its own, keeping it walking along x if it was told to.
+	 */
+	void simulate(VoxelCollider& collider, PhysicsBody& body, int ticks, float walkSpeed = 0.f)
+	{
+		for (int i = 0; i < ticks; ++i)
+		{
+			if (walkSpeed != 0.f)
+				body.velocity.x = walkSpeed;
+
+			PhysicsSystem::step(collider, body);
+		}
+	}
+
+	bool isInsideSolid(VoxelCollider& collider, const PhysicsBody& body)
+	{
+		// Shrunk, as a body resting against a block touches it without overlapping it.
+		math::AABB box = body.getBounds();
+		box.min += qz::Vector3(0.01f, 0.01f, 0.01f);
+		box.max -= qz::Vector3(0.01f, 0.01f, 0.01f);
+
+		return collider.intersects(box);
+	}
+}
+
+int main()
+{
+	Checks checks;
+
+	BlockLibrary* library = BlockLibrary::get();
+	library->init();
+	library->registerBlock(RegistryBlock("core:air", "Air", 1, BlockType::GAS));
+	library->registerBlock(RegistryBlock("core:grass", "Grass", 1, BlockType::SOLID));
+	library->registerBlock(RegistryBlock("core:dirt", "Dirt", 1, BlockType::SOLID));
+
+	const BlockInstance air("core:air");
+	const BlockInstance dirt("core:dirt");
+
+	ChunkManager world("core:air", 7);
+	world.testGeneration();
+
+	// A flat floor, with walls running across the world at x = 30 and x = 50 and a single block step at x = 22.
+	world.fillRegion({ 0, 0, 0 }, { WORLD_WIDTH - 1, CHUNK_SIZE - 1, CHUNK_SIZE - 1 }, air);
+	world.fillRegion({ 0, 0, 0 }, { WORLD_WIDTH - 1, FLOOR_HEIGHT - 1, CHUNK_SIZE - 1 }, dirt);
+	world.fillRegion({ 22, FLOOR_HEIGHT, 0 }, { 22, FLOOR_HEIGHT, CHUNK_SIZE - 1 }, dirt);
+	world.fillRegion({ 30, FLOOR_HEIGHT, 0 }, { 30, FLOOR_HEIGHT + 2, CHUNK_SIZE - 1 }, dirt);
+	world.fillRegion({ 50, FLOOR_HEIGHT, 0 }, { 50, FLOOR_HEIGHT + 4, CHUNK_SIZE - 1 }, dirt);
+
+	// Scattered steps, so the bodies below have something to climb and bump into.
+	std::mt19937 random(1);
+	for (int i = 0; i < 100; ++i)
+	{
+		const int x = 60 + static_cast<int>(random() % 18);
+		const int z = 1 + static_cast<int>(random() % 14);
+		world.setBlockAt({ x, FLOOR_HEIGHT, z }, dirt);
+	}
+
+	VoxelCollider collider(&world);
+
+	// Moves 10 blocks a tick, far more than the width of the wall.
+	{
+		PhysicsBody bullet;
+		bullet.position = { 40.5f, static_cast<float>(FLOOR_HEIGHT), 8.5f };
+		bullet.velocity = { 600.f, 0.f, 0.f };
+		bullet.gravityScale = 0.f;
+
+		simulate(collider, bullet, TICKS_PER_RUN);
+
+		checks.expect(bullet.position.x + bullet.width / 2.f <= 50.f + EPSILON, "A fast body stops at a wall instead of passing through it");
+		checks.expect(bullet.velocity.x == 0.f, "A body that hits a wall loses its speed towards it");
+	}
+
+	{
+		PhysicsBody walker;
+		walker.position = { 20.5f, static_cast<float>(FLOOR_HEIGHT), 8.5f };
+
+		// The step is a single block wide, so the walker climbs onto it and then drops back down the other side.
+		float highest = walker.position.y;
+		for (int i = 0; i < 2 * TICKS_PER_RUN; ++i)
+		{
+			simulate(collider, walker, 1, 4.f);
+			highest = std::max(highest, walker.position.y);
+		}
+
+		checks.expect(highest >= FLOOR_HEIGHT + 1.f - EPSILON, "A walking body climbs a single block step");
+		checks.expect(walker.position.x + walker.width / 2.f <= 30.f + EPSILON, "A walking body doesn't climb a wall taller than its step height");
+		checks.expect(walker.position.x > 23.f, "A walking body carries on after climbing a step");
+	}
+
+	{
+		PhysicsBody faller;
+		faller.position = { 10.5f, 14.f, 8.5f };
+		// Fast enough to be clamped, but slow enough that it's still in the air after the first tick.
+		faller.velocity = { 0.f, -100.f, 0.f };
+
+		PhysicsSystem::step(collider, faller);
+		checks.expect(faller.velocity.y >= -PhysicsSystem::TERMINAL_VELOCITY, "A falling body is limited to terminal velocity");
+
+		simulate(collider, faller, TICKS_PER_RUN);
+		checks.expect(faller.onGround && faller.position.y >= FLOOR_HEIGHT - EPSILON, "A falling body lands on the floor instead of passing through it");
+	}
+
+	// Bodies all over the world, spread out so none start inside a block.
+	entities::EntityWorld& entities = world.getEntities();
+
+	std::uniform_real_distribution<float> horizontal(1.f, CHUNK_SIZE - 1.f);
+	std::uniform_real_distribution<float> along(1.f, WORLD_WIDTH - 1.f);
+	std::uniform_real_distribution<float> height(FLOOR_HEIGHT + 1.f, CHUNK_SIZE - 2.f);
+	std::uniform_real_distribution<float> speed(-4.f, 4.f);
+
+	while (entities.getEntityCount() < BODY_COUNT)
+	{
+		PhysicsBody body;
+		body.position = { along(random), height(random), horizontal(random) };
+		body.velocity = { speed(random), 0.f, speed(random) };
+
+		if (!isInsideSolid(collider, body))
+			entities.createEntity(body);
+	}
+
+	PhysicsSystem& physics = world.getPhysics();
+
+	const double ms = measure(RUNS, [&]()
+	{
+		for (int i = 0; i < TICKS_PER_RUN; ++i)
+			physics.tick();
+	});
+
+	const double perTick = ms / TICKS_PER_RUN;
+	std::printf("%d bodies: %.3f ms per tick, %.3f us per body\n", BODY_COUNT, perTick, perTick * 1000.0 / BODY_COUNT);
+
+	int inside = 0;
+	int below = 0;
+
+	const auto view = entities.getRegistry().view<PhysicsBody>();
+	for (const auto entity : view)
+	{
+		const PhysicsBody& body = view.get(entity);
+
+		inside += isInsideSolid(collider, body);
+		below += body.position.y < FLOOR_HEIGHT - EPSILON;
+	}
+
+	checks.expect(inside == 0, "No body ends up inside a block");
+	checks.expect(below == 0, "No body falls through the floor");
+
+	return checks.getFailures();
+}
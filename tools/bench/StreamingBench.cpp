@@ -0,0 +1,141 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+// Loads the world around the camera at the default view distance, then flies the camera along x, checking that
+// chunks left behind are unloaded so the number of chunks and the memory they take stay about the same.
+
+#include "Bench.hpp"
+
+#include <quartz/core/QuartzPCH.hpp>
+#include <quartz/voxels/ChunkManager.hpp>
+
+#if defined(QZ_PLATFORM_LINUX)
+#	include <unistd.h>
+#endif
+
+#include <chrono>
+#include <fstream>
+
+using namespace qz;
+using namespace qz::voxels;
+using namespace qz::bench;
+
+namespace
+{
+	const int FLIGHT_DISTANCE = 64;
+	const int FLIGHT_STEP = 8;
+
+	/**
+	 * @brief Gets the memory the process is using, in megabytes, or -1 if the platform doesn't say.
+	 */
+	double getResidentMegabytes()
+	{
+#if defined(QZ_PLATFORM_LINUX)
+		std::ifstream statm("/proc/self/statm");
+
+		long long size = 0;
+		long long resident = 0;
+		if (statm >> size >> resident)
+			return resident * static_cast<double>(sysconf(_SC_PAGESIZE)) / (1024.0 * 1024.0);
+#endif
+		return -1.0;
+	}
+
+	/**
+	 * @brief Calls determineGeneration() until everything in view is loaded.
+	 * @return How long it took, in milliseconds.
+	 */
+	double loadAround(ChunkManager& world, int chunkX)
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		// In render space, blocks are 2 units wide.
+		const qz::Vector3 camera = { chunkX * CHUNK_SIZE * 2.f, 0.f, 0.f };
+
+		std::size_t count = 0;
+		do
+		{
+			count = world.getChunkCount();
+			world.determineGeneration(camera);
+		} while (world.getChunkCount() != count);
+
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+}
+
+int main()
+{
+	Checks checks;
+
+	BlockLibrary* library = BlockLibrary::get();
+	library->init();
+	library->registerBlock(RegistryBlock("core:air", "Air", 1, BlockType::GAS));
+	library->registerBlock(RegistryBlock("core:grass", "Grass", 1, BlockType::SOLID));
+	library->registerBlock(RegistryBlock("core:dirt", "Dirt", 1, BlockType::SOLID));
+
+	ChunkManager world("core:air", 7);
+
+	const int horizontal = 2 * world.getViewDistance() + 1;
+	const std::size_t inView = static_cast<std::size_t>(horizontal) * horizontal * (2 * world.getVerticalViewDistance() + 1);
+
+	const double baseline = getResidentMegabytes();
+
+	const double loadMs = loadAround(world, 0);
+	const std::size_t loaded = world.getChunkCount();
+	const double loadedMegabytes = getResidentMegabytes();
+
+	std::printf("Load the view distance      %8.1f ms, %zu chunks", loadMs, loaded);
+	if (baseline >= 0.0)
+		std::printf(", %.1f MB", loadedMegabytes - baseline);
+	std::printf("\n");
+
+	checks.expect(loaded == inView, "Every chunk in view is loaded");
+
+	double flightMs = 0.0;
+	std::size_t mostLoaded = loaded;
+
+	for (int x = FLIGHT_STEP; x <= FLIGHT_DISTANCE; x += FLIGHT_STEP)
+	{
+		flightMs += loadAround(world, x);
+		mostLoaded = std::max(mostLoaded, world.getChunkCount());
+	}
+
+	const double flownMegabytes = getResidentMegabytes();
+
+	std::printf("Fly %d chunks along x       %8.1f ms, %zu chunks", FLIGHT_DISTANCE, flightMs, world.getChunkCount());
+	if (baseline >= 0.0)
+		std::printf(", %.1f MB", flownMegabytes - baseline);
+	std::printf("\n");
+
+	// Chunks up to FLIGHT_STEP behind the camera are kept until it moves on, on top of the ones in view.
+	checks.expect(mostLoaded <= inView + static_cast<std::size_t>(FLIGHT_STEP) * horizontal * (2 * world.getVerticalViewDistance() + 1),
+		"Chunks left behind are unloaded");
+
+	if (baseline >= 0.0)
+		checks.expect(flownMegabytes - baseline < 1.5 * (loadedMegabytes - baseline), "Memory stays about the same while flying");
+
+	world.setViewDistance(4, 1);
+	checks.expect(world.getChunkCount() <= 13u * 13u * 3u, "Shrinking the view distance unloads chunks straight away");
+
+	return checks.getFailures();
+}
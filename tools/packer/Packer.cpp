@@ -0,0 +1,106 @@
+// Copyright 2019 Genten Studios
+// 
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the 
+// following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the 
+// following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the 
+// following disclaimer in the documentation and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote 
+// products derived from this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED 
+// WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A 
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY 
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH 
+// DAMAGE.
+
+// Packs asset directories into a single archive that the engine can mount, see qz::utils::VirtualFileSystem.
+//
+// Usage: quartz-packer [--store] <archive> <directory>...
+//
+// Every file under the directories is stored under its path relative to the working directory, so running
+// "quartz-packer assets.qzpak assets" from the sandbox stores "assets/shaders/main.vert" and so on. Files are
+// compressed when that makes them noticeably smaller, --store turns compression off entirely.
+
+#include <quartz/core/utilities/Archive.hpp>
+#include <quartz/core/utilities/FileIO.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+int main(int argc, char** argv)
+{
+	bool compress = true;
+	std::vector<std::string> arguments;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--store") == 0)
+			compress = false;
+		else
+			arguments.emplace_back(argv[i]);
+	}
+
+	if (arguments.size() < 2)
+	{
+		std::fprintf(stderr, "Usage: %s [--store] <archive> <directory>...\n", argv[0]);
+		return 1;
+	}
+
+	qz::utils::ArchiveWriter writer;
+
+	std::uint64_t totalSize = 0;
+	for (std::size_t i = 1; i < arguments.size(); ++i)
+	{
+		std::error_code error;
+		for (fs::recursive_directory_iterator it(arguments[i], error), end; !error && it != end; it.increment(error))
+		{
+			if (!it->is_regular_file())
+				continue;
+
+			// Placeholder files only exist to keep empty directories in version control.
+			if (it->path().filename() == ".gitkeep")
+				continue;
+
+			const std::string path = it->path().generic_string();
+
+			const qz::utils::MappedFile file(path);
+			if (!file.isOpen())
+			{
+				std::fprintf(stderr, "Couldn't read %s\n", path.c_str());
+				return 1;
+			}
+
+			totalSize += file.size();
+			writer.add(path, std::string(file.getContents()), compress);
+		}
+
+		if (error)
+		{
+			std::fprintf(stderr, "Couldn't walk %s: %s\n", arguments[i].c_str(), error.message().c_str());
+			return 1;
+		}
+	}
+
+	if (!writer.write(arguments[0]))
+	{
+		std::fprintf(stderr, "Couldn't write %s\n", arguments[0].c_str());
+		return 1;
+	}
+
+	std::printf("Packed %zu files (%llu bytes) into %s\n", writer.getFileCount(), static_cast<unsigned long long>(totalSize), arguments[0].c_str());
+
+	return 0;
+}